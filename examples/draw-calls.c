@@ -0,0 +1,252 @@
+/*
+ * draw-calls.c:
+ * Measures the CPU cost of issuing many small draw calls.
+ *
+ * Run it once normally and once with --no-error (or with the
+ * GDK_GL_NO_ERROR=1 environment variable) to see how much of the
+ * per-call overhead goes into OpenGL error validation.
+ *
+ * This program is in the public domain and you are using it at
+ * your own risk.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtk/gtk.h>
+#include <gdk/gdkkeysyms.h>
+
+#include <gtk/gtkgl.h>
+
+#ifdef G_OS_WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#endif
+
+#ifdef GDK_WINDOWING_QUARTZ
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#define GRID 64         /* GRID * GRID draw calls per frame */
+
+static const GLfloat quad[] = {
+  0.0, 0.0,
+  1.0, 0.0,
+  1.0, 1.0,
+  0.0, 1.0
+};
+
+static GTimer *timer = NULL;
+static gdouble submit_seconds = 0.0;
+static gint frames = 0;
+
+static gboolean
+draw (GtkWidget *widget,
+      cairo_t   *cr,
+      gpointer   data)
+{
+  GTimer *submit_timer;
+  gint i, j;
+
+  /*** OpenGL BEGIN ***/
+  if (!gtk_widget_begin_gl (widget))
+    return FALSE;
+
+  glClear (GL_COLOR_BUFFER_BIT);
+
+  /* Drain the queue so that only submission is timed. */
+  glFinish ();
+
+  submit_timer = g_timer_new ();
+
+  for (j = 0; j < GRID; j++)
+    for (i = 0; i < GRID; i++)
+      {
+        glColor3f ((GLfloat) i / GRID, (GLfloat) j / GRID, 0.5);
+        glLoadIdentity ();
+        glTranslatef ((GLfloat) i, (GLfloat) j, 0.0);
+        glDrawArrays (GL_TRIANGLE_FAN, 0, 4);
+      }
+
+  submit_seconds += g_timer_elapsed (submit_timer, NULL);
+  g_timer_destroy (submit_timer);
+
+  gtk_widget_end_gl (widget, TRUE);
+  /*** OpenGL END ***/
+
+  frames++;
+
+  {
+    gdouble seconds = g_timer_elapsed (timer, NULL);
+    if (seconds >= 5.0) {
+      gdouble calls = (gdouble) frames * GRID * GRID;
+      g_print ("%d frames in %6.3f seconds = %6.3f FPS, "
+               "%.0f draw calls/s submitted, %.3f us per call\n",
+               frames, seconds, frames / seconds,
+               calls / submit_seconds,
+               submit_seconds * 1e6 / calls);
+      {
+        guint n_calls, n_skipped;
+
+        gdk_gl_context_get_make_current_stats (&n_calls, &n_skipped);
+        g_print ("%u of %u make-current calls were already bound\n",
+                 n_skipped, n_calls);
+      }
+      g_timer_reset (timer);
+      submit_seconds = 0.0;
+      frames = 0;
+    }
+  }
+
+  return TRUE;
+}
+
+static gboolean
+reshape (GtkWidget         *widget,
+         GdkEventConfigure *event,
+         gpointer           data)
+{
+  GtkAllocation allocation;
+
+  gtk_widget_get_allocation (widget, &allocation);
+
+  /*** OpenGL BEGIN ***/
+  if (!gtk_widget_begin_gl (widget))
+    return FALSE;
+
+  glViewport (0, 0, allocation.width, allocation.height);
+  glMatrixMode (GL_PROJECTION);
+  glLoadIdentity ();
+  glOrtho (0.0, GRID, 0.0, GRID, -1.0, 1.0);
+  glMatrixMode (GL_MODELVIEW);
+  glLoadIdentity ();
+
+  gtk_widget_end_gl (widget, FALSE);
+  /*** OpenGL END ***/
+
+  return TRUE;
+}
+
+static void
+init (GtkWidget *widget,
+      gpointer   data)
+{
+  /*** OpenGL BEGIN ***/
+  if (!gtk_widget_begin_gl (widget))
+    return;
+
+  glEnableClientState (GL_VERTEX_ARRAY);
+  glVertexPointer (2, GL_FLOAT, 0, quad);
+
+  g_print ("\n");
+  g_print ("GL_RENDERER   = %s\n", (char *) glGetString (GL_RENDERER));
+  g_print ("GL_VERSION    = %s\n", (char *) glGetString (GL_VERSION));
+  g_print ("GL_VENDOR     = %s\n", (char *) glGetString (GL_VENDOR));
+  g_print ("\n");
+
+  gtk_widget_end_gl (widget, FALSE);
+  /*** OpenGL END ***/
+
+  if (timer == NULL)
+    timer = g_timer_new ();
+
+  g_timer_start (timer);
+}
+
+static gboolean
+idle (GtkWidget *widget)
+{
+  GtkAllocation allocation;
+  GdkWindow *window;
+
+  window = gtk_widget_get_window (widget);
+  gtk_widget_get_allocation (widget, &allocation);
+
+  gdk_window_invalidate_rect (window, &allocation, FALSE);
+  gdk_window_process_updates (window, FALSE);
+
+  return TRUE;
+}
+
+static gboolean
+key (GtkWidget   *widget,
+     GdkEventKey *event,
+     gpointer     data)
+{
+  if (event->keyval == GDK_KEY_Escape)
+    {
+      gtk_main_quit ();
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  GdkGLConfig *glconfig;
+  GdkGLContextFlags flags = 0;
+  GtkWidget *window;
+  GtkWidget *drawing_area;
+  int i;
+
+  gtk_init (&argc, &argv);
+  gtk_gl_init (&argc, &argv);
+
+  for (i = 0; i < argc; i++)
+    {
+      if (strcmp (argv[i], "--no-error") == 0)
+        flags |= GDK_GL_CONTEXT_NO_ERROR_BIT;
+    }
+
+  glconfig = gdk_gl_config_new_by_mode (GDK_GL_MODE_RGB |
+                                        GDK_GL_MODE_DOUBLE);
+  if (glconfig == NULL)
+    {
+      g_print ("*** No appropriate OpenGL-capable visual found.\n");
+      exit (1);
+    }
+
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_title (GTK_WINDOW (window), "draw-calls");
+
+  g_signal_connect (G_OBJECT (window), "delete_event",
+                    G_CALLBACK (gtk_main_quit), NULL);
+
+  drawing_area = gtk_drawing_area_new ();
+  gtk_widget_set_size_request (drawing_area, 300, 300);
+
+  /* Set OpenGL-capability to the widget. */
+  gtk_widget_set_gl_capability_full (drawing_area,
+                                     glconfig,
+                                     NULL,
+                                     TRUE,
+                                     GDK_GL_RGBA_TYPE,
+                                     0, 0,
+                                     GDK_GL_CONTEXT_PROFILE_DEFAULT,
+                                     flags);
+
+  g_signal_connect_after (G_OBJECT (drawing_area), "realize",
+                          G_CALLBACK (init), NULL);
+  g_signal_connect (G_OBJECT (drawing_area), "configure_event",
+                    G_CALLBACK (reshape), NULL);
+  g_signal_connect (G_OBJECT (drawing_area), "draw",
+                    G_CALLBACK (draw), NULL);
+
+  g_signal_connect_swapped (G_OBJECT (window), "key_press_event",
+                            G_CALLBACK (key), drawing_area);
+
+  gtk_container_add (GTK_CONTAINER (window), drawing_area);
+
+  gtk_widget_show_all (window);
+
+  g_idle_add_full (GDK_PRIORITY_REDRAW, (GSourceFunc) idle, drawing_area, NULL);
+
+  gtk_main ();
+
+  return 0;
+}
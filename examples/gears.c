@@ -9,7 +9,6 @@
 /* Conversion to GtkGLExt by Naofumi Yasufuku */
 
 #include <stdlib.h>
-#include <string.h>
 #include <math.h>
 
 #include <gtk/gtk.h>
@@ -167,8 +166,6 @@ static GLfloat angle = 0.0;
 static GTimer *timer = NULL;
 static gint frames = 0;
 
-static gboolean is_sync = TRUE;
-
 static gboolean
 draw (GtkWidget *widget,
       cairo_t   *cr,
@@ -311,68 +308,39 @@ init(GtkWidget *widget,
   g_timer_start (timer);
 }
 
+/* degrees per second */
+#define ROTATION_SPEED 120.0
+
+static gint64 last_frame_time = 0;
+
 static gboolean
-idle (GtkWidget *widget)
+frame (GtkWidget     *widget,
+       GdkFrameClock *frame_clock,
+       gpointer       data)
 {
-  GtkAllocation allocation;
-  GdkWindow *window;
-  angle += 2.0;
+  gint64 frame_time;
 
-  window = gtk_widget_get_window (widget);
-  gtk_widget_get_allocation (widget, &allocation);
+  frame_time = gdk_frame_clock_get_frame_time (frame_clock);
 
-  /* Invalidate the whole window. */
-  gdk_window_invalidate_rect (window, &allocation, FALSE);
+  if (last_frame_time != 0)
+    angle += ROTATION_SPEED * (frame_time - last_frame_time) / G_USEC_PER_SEC;
 
-  /* Update synchronously (fast). */
-  if (is_sync)
-    gdk_window_process_updates (window, FALSE);
+  last_frame_time = frame_time;
 
   return TRUE;
 }
 
-static guint idle_id = 0;
-
 static void
-idle_add (GtkWidget *widget)
+animation_start (GtkWidget *widget)
 {
-  if (idle_id == 0)
-    {
-      idle_id = g_idle_add_full (GDK_PRIORITY_REDRAW,
-                                 (GSourceFunc) idle,
-                                 widget,
-                                 NULL);
-    }
+  last_frame_time = 0;
+  gtk_widget_set_gl_animation (widget, frame, NULL, NULL);
 }
 
 static void
-idle_remove (GtkWidget *widget)
-{
-  if (idle_id != 0)
-    {
-      g_source_remove (idle_id);
-      idle_id = 0;
-    }
-}
-
-static gboolean
-map (GtkWidget   *widget,
-     GdkEventAny *event,
-     gpointer     data)
-{
-  idle_add (widget);
-
-  return TRUE;
-}
-
-static gboolean
-unmap (GtkWidget   *widget,
-       GdkEventAny *event,
-       gpointer     data)
+animation_stop (GtkWidget *widget)
 {
-  idle_remove (widget);
-
-  return TRUE;
+  gtk_widget_set_gl_animation (widget, NULL, NULL, NULL);
 }
 
 static gboolean
@@ -381,9 +349,9 @@ visible (GtkWidget          *widget,
 	 gpointer            data)
 {
   if (event->state == GDK_VISIBILITY_FULLY_OBSCURED)
-    idle_remove (widget);
+    animation_stop (widget);
   else
-    idle_add (widget);
+    animation_start (widget);
 
   return TRUE;
 }
@@ -394,8 +362,6 @@ key (GtkWidget   *widget,
      GdkEventKey *event,
      gpointer     data)
 {
-  GtkAllocation allocation;
-
   switch (event->keyval)
     {
     case GDK_KEY_z:
@@ -423,8 +389,7 @@ key (GtkWidget   *widget,
       return FALSE;
     }
 
-  gtk_widget_get_allocation (widget, &allocation);
-  gdk_window_invalidate_rect (gtk_widget_get_window (widget), &allocation, FALSE);
+  gtk_widget_queue_gl_frame (widget);
 
   return TRUE;
 }
@@ -438,7 +403,6 @@ main (int   argc,
   GtkWidget *vbox;
   GtkWidget *drawing_area;
   GtkWidget *button;
-  int i;
 
   /*
    * Init GTK.
@@ -452,16 +416,6 @@ main (int   argc,
 
   gtk_gl_init (&argc, &argv);
 
-  /*
-   * Command line options.
-   */
-
-  for (i = 0; i < argc; i++)
-    {
-      if (strcmp (argv[i], "--async") == 0)
-        is_sync = FALSE;
-    }
-
   /*
    * Configure OpenGL-capable visual.
    */
@@ -529,10 +483,6 @@ main (int   argc,
 		    G_CALLBACK (reshape), NULL);
   g_signal_connect (G_OBJECT (drawing_area), "draw",
 		    G_CALLBACK (draw), NULL);
-  g_signal_connect (G_OBJECT (drawing_area), "map_event",
-		    G_CALLBACK (map), NULL);
-  g_signal_connect (G_OBJECT (drawing_area), "unmap_event",
-		    G_CALLBACK (unmap), NULL);
   g_signal_connect (G_OBJECT (drawing_area), "visibility_notify_event",
 		    G_CALLBACK (visible), NULL);
 
@@ -556,6 +506,12 @@ main (int   argc,
 
   gtk_widget_show (button);
 
+  /*
+   * Animate from the frame clock; it only ticks while the widget is mapped.
+   */
+
+  animation_start (drawing_area);
+
   /*
    * Show window.
    */
@@ -565,7 +521,6 @@ main (int   argc,
   /*
    * Main loop.
    */
-//idle_add (drawing_area);
   gtk_main ();
 
   return 0;
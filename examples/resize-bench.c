@@ -0,0 +1,243 @@
+/*
+ * resize-bench.c:
+ * Measures how fast an OpenGL widget can be resized.
+ *
+ * A GtkPaned with an OpenGL drawing area in one pane is dragged from a
+ * tick callback, several times per frame, as an interactive paned drag
+ * would. Every drag step allocates the drawing area; every frame draws
+ * it once.
+ *
+ * Run it once normally and once with --sync-every-allocation, which
+ * waits for X on every allocation as older GtkGLExt did, to see how
+ * much of the resize throughput went into X round trips. Use
+ * --allocations N to change the number of drag steps per frame.
+ *
+ * This program is in the public domain and you are using it at
+ * your own risk.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <gtk/gtk.h>
+#include <gdk/gdkkeysyms.h>
+
+#include <gtk/gtkgl.h>
+
+#ifdef G_OS_WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#endif
+
+#ifdef GDK_WINDOWING_QUARTZ
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+static gint allocations_per_frame = 8;
+static gboolean sync_every_allocation = FALSE;
+
+static GTimer *timer = NULL;
+static gint frames = 0;
+static gint allocations = 0;
+static gdouble phase = 0.0;
+
+static gboolean
+draw (GtkWidget *widget,
+      cairo_t   *cr,
+      gpointer   data)
+{
+  GtkAllocation allocation;
+
+  gtk_widget_get_allocation (widget, &allocation);
+
+  /*** OpenGL BEGIN ***/
+  if (!gtk_widget_begin_gl (widget))
+    return FALSE;
+
+  glViewport (0, 0, allocation.width, allocation.height);
+  glClearColor (0.2, 0.3, 0.5, 1.0);
+  glClear (GL_COLOR_BUFFER_BIT);
+
+  gtk_widget_end_gl (widget, TRUE);
+  /*** OpenGL END ***/
+
+  frames++;
+
+  {
+    gdouble seconds = g_timer_elapsed (timer, NULL);
+    if (seconds >= 5.0) {
+      g_print ("%d frames in %6.3f seconds = %6.3f FPS, "
+               "%.0f allocations/s\n",
+               frames, seconds, frames / seconds,
+               allocations / seconds);
+      g_timer_reset (timer);
+      frames = 0;
+      allocations = 0;
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+size_allocate (GtkWidget     *widget,
+               GtkAllocation *allocation,
+               gpointer       data)
+{
+  allocations++;
+
+  /* What GtkGLExt used to do on every allocation. */
+  if (sync_every_allocation && gtk_widget_get_realized (widget))
+    {
+      if (!gtk_widget_begin_gl (widget))
+        return;
+
+      gdk_gl_drawable_wait_gdk (gtk_widget_get_gl_drawable (widget));
+
+      gtk_widget_end_gl (widget, FALSE);
+    }
+}
+
+static void
+init (GtkWidget *widget,
+      gpointer   data)
+{
+  /*** OpenGL BEGIN ***/
+  if (!gtk_widget_begin_gl (widget))
+    return;
+
+  /* Do not let the vertical retrace limit the frame rate. */
+  gdk_gl_drawable_set_swap_interval (gtk_widget_get_gl_drawable (widget), 0);
+
+  g_print ("\n");
+  g_print ("GL_RENDERER   = %s\n", (char *) glGetString (GL_RENDERER));
+  g_print ("GL_VERSION    = %s\n", (char *) glGetString (GL_VERSION));
+  g_print ("GL_VENDOR     = %s\n", (char *) glGetString (GL_VENDOR));
+  g_print ("%d allocations per frame%s\n", allocations_per_frame,
+           sync_every_allocation ? ", synchronized on every allocation" : "");
+  g_print ("\n");
+
+  gtk_widget_end_gl (widget, FALSE);
+  /*** OpenGL END ***/
+
+  if (timer == NULL)
+    timer = g_timer_new ();
+
+  g_timer_start (timer);
+}
+
+/* Drag the paned handle back and forth. */
+static gboolean
+drag (GtkWidget     *paned,
+      GdkFrameClock *frame_clock,
+      gpointer       data)
+{
+  GtkWidget *toplevel = data;
+  gint width;
+  gint i;
+
+  width = gtk_widget_get_allocated_width (paned);
+
+  for (i = 0; i < allocations_per_frame; i++)
+    {
+      phase += 0.01;
+      gtk_paned_set_position (GTK_PANED (paned),
+                              width / 2 + (gint) (width / 4 * sin (phase)));
+
+      /* Allocate now, as each motion event of a real drag would. */
+      gtk_container_check_resize (GTK_CONTAINER (toplevel));
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+key (GtkWidget   *widget,
+     GdkEventKey *event,
+     gpointer     data)
+{
+  if (event->keyval == GDK_KEY_Escape)
+    {
+      gtk_main_quit ();
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+int
+main (int   argc,
+      char *argv[])
+{
+  GdkGLConfig *glconfig;
+  GtkWidget *window;
+  GtkWidget *paned;
+  GtkWidget *drawing_area;
+  GtkWidget *label;
+  int i;
+
+  gtk_init (&argc, &argv);
+  gtk_gl_init (&argc, &argv);
+
+  for (i = 0; i < argc; i++)
+    {
+      if (strcmp (argv[i], "--sync-every-allocation") == 0)
+        sync_every_allocation = TRUE;
+      else if (strcmp (argv[i], "--allocations") == 0 && i + 1 < argc)
+        allocations_per_frame = MAX (atoi (argv[++i]), 1);
+    }
+
+  glconfig = gdk_gl_config_new_by_mode (GDK_GL_MODE_RGB |
+                                        GDK_GL_MODE_DOUBLE);
+  if (glconfig == NULL)
+    {
+      g_print ("*** No appropriate OpenGL-capable visual found.\n");
+      exit (1);
+    }
+
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_title (GTK_WINDOW (window), "resize-bench");
+  gtk_window_set_default_size (GTK_WINDOW (window), 600, 300);
+
+  g_signal_connect (G_OBJECT (window), "delete_event",
+                    G_CALLBACK (gtk_main_quit), NULL);
+
+  paned = gtk_paned_new (GTK_ORIENTATION_HORIZONTAL);
+  gtk_container_add (GTK_CONTAINER (window), paned);
+
+  drawing_area = gtk_drawing_area_new ();
+  gtk_widget_set_size_request (drawing_area, 50, 50);
+
+  /* Set OpenGL-capability to the widget. */
+  gtk_widget_set_gl_capability (drawing_area,
+                                glconfig,
+                                NULL,
+                                TRUE,
+                                GDK_GL_RGBA_TYPE);
+
+  g_signal_connect_after (G_OBJECT (drawing_area), "realize",
+                          G_CALLBACK (init), NULL);
+  g_signal_connect (G_OBJECT (drawing_area), "size_allocate",
+                    G_CALLBACK (size_allocate), NULL);
+  g_signal_connect (G_OBJECT (drawing_area), "draw",
+                    G_CALLBACK (draw), NULL);
+
+  g_signal_connect_swapped (G_OBJECT (window), "key_press_event",
+                            G_CALLBACK (key), drawing_area);
+
+  gtk_paned_pack1 (GTK_PANED (paned), drawing_area, TRUE, FALSE);
+
+  label = gtk_label_new ("resize-bench");
+  gtk_paned_pack2 (GTK_PANED (paned), label, TRUE, FALSE);
+
+  gtk_widget_show_all (window);
+
+  gtk_widget_add_tick_callback (paned, drag, window, NULL);
+
+  gtk_main ();
+
+  return 0;
+}
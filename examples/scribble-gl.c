@@ -162,11 +162,24 @@ draw (GtkWidget *widget,
 {
   guint count;
   Point* coord;
+  cairo_region_t *damage;
+  cairo_rectangle_int_t extents;
 
   /*** OpenGL BEGIN ***/
   if (!gtk_widget_begin_gl (widget))
     return FALSE;
 
+  /* Repaint only what was invalidated, and what the back buffer
+     is missing. */
+  damage = gtk_widget_get_gl_damage (widget, cr);
+  cairo_region_get_extents (damage, &extents);
+
+  glEnable (GL_SCISSOR_TEST);
+  glScissor (extents.x,
+             gtk_widget_get_allocated_height (widget) - extents.y - extents.height,
+             extents.width,
+             extents.height);
+
   glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   /* Set the foreground colour. */
@@ -182,12 +195,35 @@ draw (GtkWidget *widget,
               coord->y + thickness);
     }
 
-  gtk_widget_end_gl (widget, TRUE);
+  glDisable (GL_SCISSOR_TEST);
+
+  gtk_widget_end_gl_with_damage (widget, damage);
   /*** OpenGL END ***/
 
+  cairo_region_destroy (damage);
+
   return TRUE;
 }
 
+/***
+ *** Invalidate only the area covered by the brush at (x, y), in
+ *** window coordinates.
+ ***/
+static void
+invalidate_point (GtkWidget *widget,
+                  gdouble    x,
+                  gdouble    y)
+{
+  GdkRectangle rect;
+
+  rect.x = (gint) x - thickness - 1;
+  rect.y = (gint) y - thickness - 1;
+  rect.width = 2 * thickness + 2;
+  rect.height = 2 * thickness + 2;
+
+  gdk_window_invalidate_rect (gtk_widget_get_window (widget), &rect, FALSE);
+}
+
 /***
  *** The "motion_notify_event" signal handler. Any processing required when
  *** the OpenGL-capable drawing area is under drag motion should be done here.
@@ -208,7 +244,7 @@ motion_notify_event (GtkWidget      *widget,
       coord->y = allocation.height - event->y;
 
       brushStrokeList = g_list_append(brushStrokeList, coord);
-      gdk_window_invalidate_rect (gtk_widget_get_window (widget), &allocation, FALSE);
+      invalidate_point (widget, event->x, event->y);
       return TRUE;
     }
 
@@ -236,7 +272,7 @@ button_press_event (GtkWidget      *widget,
       coord->y = allocation.height - event->y;
 
       brushStrokeList = g_list_append(brushStrokeList, coord);
-      gdk_window_invalidate_rect (gtk_widget_get_window (widget), &allocation, FALSE);
+      invalidate_point (widget, event->x, event->y);
       return TRUE;
     }
 
@@ -1,6 +1,7 @@
 /*
  * simple-pbuffer-sgix.c:
- * Simple GLX_SGIX_pbuffer example.
+ * Simple GdkGLPbuffer example. On X11, the pbuffer is a GLX 1.3 pbuffer,
+ * or a GLX_SGIX_pbuffer one on older servers.
  *
  * written by Naofumi Yasufuku  <naofumi@users.sourceforge.net>
  */
@@ -11,21 +12,15 @@
 #include <gtk/gtk.h>
 
 #include <gtk/gtkgl.h>
-#include <gdk/x11/gdkglx.h>
 
-#include <GL/glx.h>
+#ifdef G_OS_WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#endif
+
 #include <GL/gl.h>
 #include <GL/glu.h>
 
-static GLXFBConfigSGIX  (APIENTRY *GetFBConfigFromVisualSGIX) (Display*, XVisualInfo*);
-static GLXPbufferSGIX   (APIENTRY *CreateGLXPbufferSGIX)      (Display*,
-                                                               GLXFBConfigSGIX,
-                                                               unsigned int,
-                                                               unsigned int,
-                                                               int*);
-static void             (APIENTRY *DestroyGLXPbufferSGIX)     (Display*,
-                                                               GLXPbufferSGIX);
-
 static void
 realize (GtkWidget *widget,
          gpointer   data)
@@ -117,26 +112,35 @@ draw (GtkWidget *widget,
 
 /* ripped from pbdemo.c which comes with Mesa. */
 static void
-write_file(const char *filename,
-           int width,
-           int height)
+write_file(GObject      *source_object,
+           GAsyncResult *result,
+           gpointer      user_data)
 {
+  const char *filename = user_data;
+  cairo_surface_t *image;
+  GError *error = NULL;
   FILE *f;
-  GLubyte *image;
-  int i;
-
-  image = malloc(width * height * 3 * sizeof(GLubyte));
-  if (!image) {
-    printf("Error: couldn't allocate image buffer\n");
+  const guchar *data;
+  int width, height, stride;
+  int i, j;
+
+  image = gdk_gl_drawable_read_pixels_finish_surface (GDK_GL_DRAWABLE (source_object),
+                                                      result, &error);
+  if (image == NULL) {
+    printf("Error: couldn't read back the image: %s\n", error->message);
+    g_error_free (error);
     return;
   }
 
-  glPixelStorei(GL_PACK_ALIGNMENT, 1);
-  glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, image);
+  width = cairo_image_surface_get_width (image);
+  height = cairo_image_surface_get_height (image);
+  stride = cairo_image_surface_get_stride (image);
+  data = cairo_image_surface_get_data (image);
 
   f = fopen(filename, "w");
   if (!f) {
     printf("Couldn't open image file: %s\n", filename);
+    cairo_surface_destroy (image);
     return;
   }
   fprintf(f,"P6\n");
@@ -147,18 +151,22 @@ write_file(const char *filename,
   f = fopen(filename, "ab");  /* now append binary data */
   if (!f) {
     printf("Couldn't append to image file: %s\n", filename);
+    cairo_surface_destroy (image);
     return;
   }
 
+  /* Rows are already top to bottom; pixels are native-endian ARGB. */
   for (i=0;i<height;i++) {
-    GLubyte *rowPtr;
-    /* Remember, OpenGL images are bottom to top.  Have to reverse. */
-    rowPtr = image + (height-1-i) * width*3;
-    fwrite(rowPtr, 1, width*3, f);
+    const guint32 *rowPtr = (const guint32 *) (data + i * stride);
+    for (j=0;j<width;j++) {
+      fputc((rowPtr[j] >> 16) & 0xff, f);
+      fputc((rowPtr[j] >> 8) & 0xff, f);
+      fputc(rowPtr[j] & 0xff, f);
+    }
   }
 
   fclose(f);
-  free(image);
+  cairo_surface_destroy (image);
 
   printf("- Wrote %d by %d image file: %s\n", width, height, filename);
 }
@@ -169,88 +177,85 @@ render_to_file (GtkButton *button,
 {
   GtkAllocation allocation;
   GdkGLConfig *glconfig;
-  Display *xdisplay;
-  XVisualInfo *xvinfo;
-  GLXFBConfigSGIX fbconfig;
+  GdkGLContext *glcontext;
 
-  GLXPbufferSGIX pbuffer;
+  GdkGLPbuffer *glpbuffer;
   int pb_attrib_list[] = {
-    GLX_LARGEST_PBUFFER_SGIX, True,
-    GLX_PRESERVED_CONTENTS_SGIX, False,
-    None
+    GDK_GL_LARGEST_PBUFFER, TRUE,
+    GDK_GL_PRESERVED_CONTENTS, FALSE,
+    GDK_GL_ATTRIB_LIST_NONE
   };
   int width, height;
 
-  GdkGLContext *glcontext;
-  GLXContext glxcontext;
-
   g_print ("Render to PPM file...\n");
 
   glconfig = gtk_widget_get_gl_config (widget);
-  xdisplay = gdk_x11_gl_config_get_xdisplay (glconfig);
-  xvinfo = gdk_x11_gl_config_get_xvinfo (glconfig);
 
   /*
-   * Get FBConfig.
-   */
-
-  g_print ("- get FBConfig\n");
-  fbconfig = GetFBConfigFromVisualSGIX (xdisplay, xvinfo);
-  if (!fbconfig)
-    {
-      g_print ("cannot get FBConfig\n");
-      return;
-    }
-
-  /*
-   * Create GLXPbuffer.
+   * Create GdkGLPbuffer.
    */
 
   gtk_widget_get_allocation (widget, &allocation);
-  width = allocation.width;
-  height = allocation.height;
 
-  g_print ("- create GLXPbuffer\n");
-  pbuffer = CreateGLXPbufferSGIX (xdisplay, fbconfig,
-                                  width, height,
+  g_print ("- create GdkGLPbuffer\n");
+  glpbuffer = gdk_gl_pbuffer_new (glconfig,
+                                  allocation.width, allocation.height,
                                   pb_attrib_list);
-  if (!pbuffer)
+  if (glpbuffer == NULL)
     {
-      g_print ("cannot create GLXPbuffer\n");
+      g_print ("cannot create GdkGLPbuffer\n");
       return;
     }
 
+  /* GDK_GL_LARGEST_PBUFFER may have given us a smaller one. */
+  gdk_gl_pbuffer_get_size (glpbuffer, &width, &height);
+
   /*
-   * Render.
+   * Render with the widget's context, so that its display list is
+   * available.
    */
 
   glcontext = gtk_widget_get_gl_context (widget);
-  glxcontext = gdk_x11_gl_context_get_glxcontext (glcontext);
 
-  glXMakeCurrent (xdisplay, pbuffer, glxcontext);
+  if (!gdk_gl_context_make_current (glcontext, GDK_GL_DRAWABLE (glpbuffer), NULL))
+    {
+      g_print ("cannot make the pbuffer current\n");
+      g_object_unref (glpbuffer);
+      return;
+    }
+
+  glViewport (0, 0, width, height);
 
   glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   glCallList (1);
 
-  glFlush ();
-
   /*
-   * Write to file.
+   * Read back without waiting; the file is written once the pixels
+   * have arrived.
    */
 
-  write_file ("simple-pbuffer-sgix.ppm", width, height);
+  gdk_gl_drawable_read_pixels_async (GDK_GL_DRAWABLE (glpbuffer),
+                                     0, 0, width, height,
+                                     NULL,
+                                     write_file,
+                                     (gpointer) "simple-pbuffer-sgix.ppm");
+
+  /* the context is shared with the widget, so restore its viewport */
+  glViewport (0, 0, allocation.width, allocation.height);
 
   /*
-   * Destroy GLXPbuffer.
+   * Destroy GdkGLPbuffer.
    */
 
-  glXMakeCurrent (xdisplay, None, NULL);
+  gdk_gl_context_release_current ();
 
-  g_print ("- destroy GLXPbuffer\n");
-  DestroyGLXPbufferSGIX (xdisplay, pbuffer);
+  g_print ("- destroy GdkGLPbuffer\n");
+  g_object_unref (glpbuffer);
 
   g_print ("Done.\n\n");
+
+  gtk_widget_queue_draw (widget);
 }
 
 int
@@ -308,33 +313,6 @@ main (int   argc,
         }
     }
 
-  /*
-   * GLX extensions.
-   */
-
-  if (!gdk_x11_gl_query_glx_extension (glconfig, "GLX_SGIX_fbconfig"))
-    {
-      g_print ("GLX_SGIX_fbconfig extension is not supported.\n");
-      exit (1);
-    }
-
-  GetFBConfigFromVisualSGIX =
-    (GLXFBConfigSGIX (APIENTRY *)(Display*, XVisualInfo*))
-      gdk_gl_get_proc_address ("glXGetFBConfigFromVisualSGIX");
-
-  if (!gdk_x11_gl_query_glx_extension (glconfig, "GLX_SGIX_pbuffer"))
-    {
-      g_print ("GLX_SGIX_pbuffer extension is not supported.\n");
-      exit (1);
-    }
-
-  CreateGLXPbufferSGIX  =
-    (GLXPbufferSGIX (APIENTRY *)(Display*, GLXFBConfigSGIX, unsigned int, unsigned int, int*))
-      gdk_gl_get_proc_address ("glXCreateGLXPbufferSGIX");
-  DestroyGLXPbufferSGIX =
-    (void (APIENTRY *)(Display*, GLXPbufferSGIX))
-      gdk_gl_get_proc_address ("glXDestroyGLXPbufferSGIX");
-
   /*
    * Top-level window.
    */
@@ -0,0 +1,189 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <gdk/gdkgldebug.h>
+#include <gdk/gdkx.h>
+#include <gdk/egl/gdkglegl.h>
+
+#include "gdkglconfig-egl.h"
+
+struct _GdkEGLGLConfig
+{
+  GdkGLConfig parent;
+};
+
+struct _GdkEGLGLConfigClass
+{
+  GdkGLConfigClass parent_class;
+};
+
+G_DEFINE_TYPE (GdkEGLGLConfig, gdk_egl_gl_config, GDK_TYPE_GL_CONFIG);
+
+static void
+gdk_egl_gl_config_init (GdkEGLGLConfig *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+}
+
+static void
+gdk_egl_gl_config_finalize (GObject *object)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  G_OBJECT_CLASS (gdk_egl_gl_config_parent_class)->finalize (object);
+}
+
+static void
+gdk_egl_gl_config_class_init (GdkEGLGLConfigClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  object_class->finalize = gdk_egl_gl_config_finalize;
+}
+
+/**
+ * gdk_egl_gl_config_new_for_display:
+ * @display: display.
+ * @attrib_list: (array length=n_attribs): the attribute list.
+ * @n_attribs: the number of attributes and values in attrib_list
+ *
+ * Creates a #GdkGLConfig on the default screen of the given display,
+ * using EGL.
+ *
+ * Return value: the new #GdkGLConfig, or NULL if no configuration matches.
+ **/
+GdkGLConfig *
+gdk_egl_gl_config_new_for_display (GdkDisplay *display,
+                                   const int  *attrib_list,
+                                   gsize       n_attribs)
+{
+  g_return_val_if_fail (GDK_IS_X11_DISPLAY (display), NULL);
+
+  return gdk_egl_gl_config_new_for_screen (gdk_display_get_default_screen (display),
+                                           attrib_list, n_attribs);
+}
+
+/**
+ * gdk_egl_gl_config_new_for_screen:
+ * @screen: target screen.
+ * @attrib_list: (array length=n_attribs): the attribute list.
+ * @n_attribs: the number of attributes and values in attrib_list
+ *
+ * Creates a #GdkGLConfig on the given screen, using EGL.
+ *
+ * Return value: the new #GdkGLConfig, or NULL if no configuration matches.
+ **/
+GdkGLConfig *
+gdk_egl_gl_config_new_for_screen (GdkScreen *screen,
+                                  const int *attrib_list,
+                                  gsize      n_attribs)
+{
+  GdkGLConfig *glconfig;
+  GdkGLConfig *impl;
+
+  g_return_val_if_fail (GDK_IS_X11_SCREEN (screen), NULL);
+
+  glconfig = g_object_new (GDK_TYPE_EGL_GL_CONFIG, NULL);
+
+  g_return_val_if_fail (glconfig != NULL, NULL);
+
+  impl = _gdk_egl_gl_config_impl_new_for_screen (glconfig, screen, attrib_list, n_attribs);
+
+  /* No matching configuration is not an error; callers may retry
+   * with fewer requirements. */
+  if (impl == NULL)
+    {
+      g_object_unref (glconfig);
+      return NULL;
+    }
+
+  return glconfig;
+}
+
+/**
+ * gdk_egl_gl_config_new_surfaceless:
+ * @attrib_list: (array length=n_attribs): the attribute list.
+ * @n_attribs: the number of attributes and values in attrib_list
+ *
+ * Creates a #GdkGLConfig on the Mesa surfaceless EGL platform, which
+ * needs no display server. Such a config cannot be used for windows;
+ * create contexts for it with gdk_gl_context_new_offscreen().
+ *
+ * Return value: the new #GdkGLConfig, or NULL if the platform is not
+ *               available or no configuration matches.
+ **/
+GdkGLConfig *
+gdk_egl_gl_config_new_surfaceless (const int *attrib_list,
+                                   gsize      n_attribs)
+{
+  GdkGLConfig *glconfig;
+  GdkGLConfig *impl;
+
+  GDK_GL_NOTE_FUNC ();
+
+  glconfig = g_object_new (GDK_TYPE_EGL_GL_CONFIG, NULL);
+
+  g_return_val_if_fail (glconfig != NULL, NULL);
+
+  impl = _gdk_egl_gl_config_impl_new_surfaceless (glconfig, attrib_list, n_attribs);
+  if (impl == NULL)
+    {
+      g_object_unref (glconfig);
+      return NULL;
+    }
+
+  return glconfig;
+}
+
+/**
+ * gdk_egl_gl_config_get_egldisplay:
+ * @glconfig: a #GdkGLConfig.
+ *
+ * Gets the EGLDisplay of the configuration.
+ *
+ * Return value: the EGLDisplay.
+ **/
+EGLDisplay
+gdk_egl_gl_config_get_egldisplay (GdkGLConfig *glconfig)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), EGL_NO_DISPLAY);
+
+  return GDK_GL_CONFIG_IMPL_EGL_GET_CLASS (glconfig->impl)->get_egldisplay (glconfig);
+}
+
+/**
+ * gdk_egl_gl_config_get_eglconfig:
+ * @glconfig: a #GdkGLConfig.
+ *
+ * Gets the EGLConfig of the frame buffer configuration.
+ *
+ * Return value: the EGLConfig.
+ **/
+EGLConfig
+gdk_egl_gl_config_get_eglconfig (GdkGLConfig *glconfig)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+
+  return GDK_GL_CONFIG_IMPL_EGL_GET_CLASS (glconfig->impl)->get_eglconfig (glconfig);
+}
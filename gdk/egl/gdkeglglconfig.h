@@ -0,0 +1,75 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#if !defined (__GDKGLEGL_H_INSIDE__) && !defined (GDK_GL_COMPILATION)
+#error "Only <gdk/gdkglegl.h> can be included directly."
+#endif
+
+#ifndef __GDK_EGL_GL_CONFIG_H__
+#define __GDK_EGL_GL_CONFIG_H__
+
+#include <EGL/egl.h>
+#include <gdk/gdkgl.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_EGL_GL_CONFIG             (gdk_egl_gl_config_get_type ())
+#define GDK_EGL_GL_CONFIG(object)          (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_EGL_GL_CONFIG, GdkEGLGLConfig))
+#define GDK_EGL_GL_CONFIG_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_EGL_GL_CONFIG, GdkEGLGLConfigClass))
+#define GDK_IS_EGL_GL_CONFIG(object)       (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_EGL_GL_CONFIG))
+#define GDK_IS_EGL_GL_CONFIG_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_EGL_GL_CONFIG))
+#define GDK_EGL_GL_CONFIG_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_EGL_GL_CONFIG, GdkEGLGLConfigClass))
+
+#ifdef INSIDE_GDK_GL_EGL
+typedef struct _GdkEGLGLConfig GdkEGLGLConfig;
+#else
+typedef GdkGLConfig GdkEGLGLConfig;
+#endif
+typedef struct _GdkEGLGLConfigClass GdkEGLGLConfigClass;
+
+GType        gdk_egl_gl_config_get_type (void);
+
+GdkGLConfig *gdk_egl_gl_config_new_for_display  (GdkDisplay *display,
+                                                 const int  *attrib_list,
+                                                 gsize       n_attribs);
+
+GdkGLConfig *gdk_egl_gl_config_new_for_screen   (GdkScreen *screen,
+                                                 const int *attrib_list,
+                                                 gsize      n_attribs);
+
+GdkGLConfig *gdk_egl_gl_config_new_surfaceless  (const int *attrib_list,
+                                                 gsize      n_attribs);
+
+EGLDisplay   gdk_egl_gl_config_get_egldisplay   (GdkGLConfig *glconfig);
+EGLConfig    gdk_egl_gl_config_get_eglconfig    (GdkGLConfig *glconfig);
+
+#ifdef INSIDE_GDK_GL_EGL
+
+#define GDK_GL_CONFIG_EGLDISPLAY(glconfig)     (GDK_GL_CONFIG_IMPL_EGL (glconfig->impl)->egldisplay)
+#define GDK_GL_CONFIG_EGLCONFIG(glconfig)      (GDK_GL_CONFIG_IMPL_EGL (glconfig->impl)->eglconfig)
+
+#else
+
+#define GDK_GL_CONFIG_EGLDISPLAY(glconfig)     (gdk_egl_gl_config_get_egldisplay (glconfig))
+#define GDK_GL_CONFIG_EGLCONFIG(glconfig)      (gdk_egl_gl_config_get_eglconfig (glconfig))
+
+#endif
+
+G_END_DECLS
+
+#endif /* __GDK_EGL_GL_CONFIG_H__ */
@@ -0,0 +1,78 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <gdk/gdkgldebug.h>
+#include <gdk/egl/gdkglegl.h>
+
+#include "gdkglcontext-egl.h"
+
+struct _GdkEGLGLContext
+{
+  GdkGLContext parent;
+};
+
+struct _GdkEGLGLContextClass
+{
+  GdkGLContextClass parent_class;
+};
+
+G_DEFINE_TYPE (GdkEGLGLContext, gdk_egl_gl_context, GDK_TYPE_GL_CONTEXT);
+
+static void
+gdk_egl_gl_context_init (GdkEGLGLContext *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+}
+
+static void
+gdk_egl_gl_context_finalize (GObject *object)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  G_OBJECT_CLASS (gdk_egl_gl_context_parent_class)->finalize (object);
+}
+
+static void
+gdk_egl_gl_context_class_init (GdkEGLGLContextClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  object_class->finalize = gdk_egl_gl_context_finalize;
+}
+
+/**
+ * gdk_egl_gl_context_get_eglcontext:
+ * @glcontext: a #GdkGLContext.
+ *
+ * Gets EGLContext.
+ *
+ * Return value: the EGLContext.
+ **/
+EGLContext
+gdk_egl_gl_context_get_eglcontext (GdkGLContext *glcontext)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), EGL_NO_CONTEXT);
+
+  return GDK_GL_CONTEXT_IMPL_EGL_GET_CLASS (glcontext->impl)->get_eglcontext (glcontext);
+}
@@ -0,0 +1,61 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#if !defined (__GDKGLEGL_H_INSIDE__) && !defined (GDK_GL_COMPILATION)
+#error "Only <gdk/gdkglegl.h> can be included directly."
+#endif
+
+#ifndef __GDK_EGL_GL_CONTEXT_H__
+#define __GDK_EGL_GL_CONTEXT_H__
+
+#include <EGL/egl.h>
+#include <gdk/gdkgl.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_EGL_GL_CONTEXT             (gdk_egl_gl_context_get_type ())
+#define GDK_EGL_GL_CONTEXT(object)          (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_EGL_GL_CONTEXT, GdkEGLGLContext))
+#define GDK_EGL_GL_CONTEXT_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_EGL_GL_CONTEXT, GdkEGLGLContextClass))
+#define GDK_IS_EGL_GL_CONTEXT(object)       (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_EGL_GL_CONTEXT))
+#define GDK_IS_EGL_GL_CONTEXT_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_EGL_GL_CONTEXT))
+#define GDK_EGL_GL_CONTEXT_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_EGL_GL_CONTEXT, GdkEGLGLContextClass))
+
+#ifdef INSIDE_GDK_GL_EGL
+typedef struct _GdkEGLGLContext GdkEGLGLContext;
+#else
+typedef GdkGLContext GdkEGLGLContext;
+#endif
+typedef struct _GdkEGLGLContextClass GdkEGLGLContextClass;
+
+GType         gdk_egl_gl_context_get_type       (void);
+
+EGLContext    gdk_egl_gl_context_get_eglcontext (GdkGLContext *glcontext);
+
+#ifdef INSIDE_GDK_GL_EGL
+
+#define GDK_GL_CONTEXT_EGLCONTEXT(glcontext)   (GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl)->eglcontext)
+
+#else
+
+#define GDK_GL_CONTEXT_EGLCONTEXT(glcontext)   (gdk_egl_gl_context_get_eglcontext (glcontext))
+
+#endif
+
+G_END_DECLS
+
+#endif /* __GDK_EGL_GL_CONTEXT_H__ */
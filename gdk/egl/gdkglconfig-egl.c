@@ -0,0 +1,730 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <gdk/gdk.h>
+#include <gdk/gdkx.h>
+
+#include "gdkglegl.h"
+#include "gdkglprivate-egl.h"
+#include "gdkglquery-egl.h"
+#include "gdkglconfig-egl.h"
+#include "gdkglwindow-egl.h"
+
+static EGLDisplay    _gdk_egl_gl_config_impl_get_egldisplay     (GdkGLConfig *glconfig);
+static EGLConfig     _gdk_egl_gl_config_impl_get_eglconfig      (GdkGLConfig *glconfig);
+static GdkGLWindow  *_gdk_egl_gl_config_impl_create_gl_window   (GdkGLConfig *glconfig,
+                                                                 GdkWindow   *window,
+                                                                 const int   *attrib_list);
+static GdkScreen    *_gdk_egl_gl_config_impl_get_screen         (GdkGLConfig *glconfig);
+static gboolean      _gdk_egl_gl_config_impl_get_attrib         (GdkGLConfig *glconfig,
+                                                                 int          attribute,
+                                                                 int         *value);
+static GdkVisual    *_gdk_egl_gl_config_impl_get_visual         (GdkGLConfig *glconfig);
+static gint          _gdk_egl_gl_config_impl_get_depth          (GdkGLConfig *glconfig);
+
+G_DEFINE_TYPE (GdkGLConfigImplEGL,              \
+               gdk_gl_config_impl_egl,          \
+               GDK_TYPE_GL_CONFIG_IMPL)
+
+static void
+gdk_gl_config_impl_egl_init (GdkGLConfigImplEGL *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  self->egldisplay = EGL_NO_DISPLAY;
+  self->eglconfig = NULL;
+  self->screen = NULL;
+}
+
+static void
+gdk_gl_config_impl_egl_class_init (GdkGLConfigImplEGLClass *klass)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  klass->get_egldisplay = _gdk_egl_gl_config_impl_get_egldisplay;
+  klass->get_eglconfig  = _gdk_egl_gl_config_impl_get_eglconfig;
+
+  klass->parent_class.create_gl_window = _gdk_egl_gl_config_impl_create_gl_window;
+  klass->parent_class.get_screen       = _gdk_egl_gl_config_impl_get_screen;
+  klass->parent_class.get_attrib       = _gdk_egl_gl_config_impl_get_attrib;
+  klass->parent_class.get_visual       = _gdk_egl_gl_config_impl_get_visual;
+  klass->parent_class.get_depth        = _gdk_egl_gl_config_impl_get_depth;
+}
+
+/*
+ * GdkGLExt attributes which map one to one onto EGL config attributes.
+ * Unlike GDK_GL_* and GLX_* tokens, EGL tokens have their own values.
+ */
+static const struct
+{
+  int attrib;
+  EGLint egl_attrib;
+} gdk_egl_gl_config_attribs[] =
+  {
+    { GDK_GL_BUFFER_SIZE,             EGL_BUFFER_SIZE },
+    { GDK_GL_LEVEL,                   EGL_LEVEL },
+    { GDK_GL_RED_SIZE,                EGL_RED_SIZE },
+    { GDK_GL_GREEN_SIZE,              EGL_GREEN_SIZE },
+    { GDK_GL_BLUE_SIZE,               EGL_BLUE_SIZE },
+    { GDK_GL_ALPHA_SIZE,              EGL_ALPHA_SIZE },
+    { GDK_GL_DEPTH_SIZE,              EGL_DEPTH_SIZE },
+    { GDK_GL_STENCIL_SIZE,            EGL_STENCIL_SIZE },
+    { GDK_GL_SAMPLE_BUFFERS,          EGL_SAMPLE_BUFFERS },
+    { GDK_GL_SAMPLES,                 EGL_SAMPLES },
+    { GDK_GL_TRANSPARENT_RED_VALUE,   EGL_TRANSPARENT_RED_VALUE },
+    { GDK_GL_TRANSPARENT_GREEN_VALUE, EGL_TRANSPARENT_GREEN_VALUE },
+    { GDK_GL_TRANSPARENT_BLUE_VALUE,  EGL_TRANSPARENT_BLUE_VALUE },
+    { GDK_GL_X_RENDERABLE,            EGL_NATIVE_RENDERABLE },
+    { GDK_GL_FBCONFIG_ID,             EGL_CONFIG_ID },
+    { GDK_GL_VISUAL_ID,               EGL_NATIVE_VISUAL_ID }
+  };
+
+static EGLint
+gdk_egl_gl_config_egl_attrib (int attrib)
+{
+  gsize i;
+
+  for (i = 0; i < G_N_ELEMENTS (gdk_egl_gl_config_attribs); ++i)
+    {
+      if (gdk_egl_gl_config_attribs[i].attrib == attrib)
+        return gdk_egl_gl_config_attribs[i].egl_attrib;
+    }
+
+  return EGL_NONE;
+}
+
+static EGLint
+egl_caveat_from_caveat (int value)
+{
+  switch (value)
+    {
+      case GDK_GL_SLOW_CONFIG:           return EGL_SLOW_CONFIG;
+      case GDK_GL_NON_CONFORMANT_CONFIG: return EGL_NON_CONFORMANT_CONFIG;
+      case GDK_GL_CONFIG_CAVEAT_NONE:    return EGL_NONE;
+      default:                           return EGL_DONT_CARE;
+    }
+}
+
+static EGLint
+egl_surface_type_from_drawable_type (int value)
+{
+  EGLint surface_type = 0;
+
+  if (value & GDK_GL_WINDOW_BIT)
+    surface_type |= EGL_WINDOW_BIT;
+  if (value & GDK_GL_PBUFFER_BIT)
+    surface_type |= EGL_PBUFFER_BIT;
+
+  return surface_type;
+}
+
+/*
+ * Converts a GdkGLExt attribute list into an EGL attribute list for
+ * eglChooseConfig(). EGL has no stereo, aux or accumulation buffers, so
+ * requests for them cannot be met. EGL window surfaces are always
+ * double-buffered, which makes GDK_GL_DOUBLEBUFFER a no-op.
+ */
+static EGLint *
+egl_attrib_list_from_attrib_list (const gint *attrib_list,
+                                  gsize       n_attribs,
+                                  gboolean    for_window)
+{
+  EGLint *egl_attrib_list;
+  gsize attrib_index;
+  gsize egl_attrib_index;
+  gboolean has_surface_type = FALSE;
+  int value;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  /* two entries per attribute, plus appended defaults */
+  egl_attrib_list = g_new (EGLint, 2 * n_attribs + 7);
+
+  for (attrib_index = 0, egl_attrib_index = 0; (attrib_index < n_attribs) && attrib_list[attrib_index]; ++attrib_index)
+    {
+      int attrib = attrib_list[attrib_index];
+
+      switch (attrib)
+        {
+          case GDK_GL_USE_GL:
+          case GDK_GL_RGBA:
+          case GDK_GL_DOUBLEBUFFER:
+            break;
+
+          case GDK_GL_STEREO:
+            GDK_GL_NOTE (MISC, g_message (" -- EGL: stereo is not supported"));
+            goto err_attrib_list;
+
+          case GDK_GL_AUX_BUFFERS:
+          case GDK_GL_ACCUM_RED_SIZE:
+          case GDK_GL_ACCUM_GREEN_SIZE:
+          case GDK_GL_ACCUM_BLUE_SIZE:
+          case GDK_GL_ACCUM_ALPHA_SIZE:
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            if (attrib_list[attrib_index] > 0)
+              {
+                GDK_GL_NOTE (MISC, g_message (" -- EGL: aux and accumulation buffers are not supported"));
+                goto err_attrib_list;
+              }
+            break;
+
+          case GDK_GL_CONFIG_CAVEAT:
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            egl_attrib_list[egl_attrib_index++] = EGL_CONFIG_CAVEAT;
+            egl_attrib_list[egl_attrib_index++] = egl_caveat_from_caveat (attrib_list[attrib_index]);
+            break;
+
+          case GDK_GL_TRANSPARENT_TYPE:
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            value = attrib_list[attrib_index];
+            egl_attrib_list[egl_attrib_index++] = EGL_TRANSPARENT_TYPE;
+            egl_attrib_list[egl_attrib_index++] =
+              (value == GDK_GL_TRANSPARENT_RGB) ? EGL_TRANSPARENT_RGB : EGL_NONE;
+            break;
+
+          case GDK_GL_DRAWABLE_TYPE:
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            has_surface_type = TRUE;
+            egl_attrib_list[egl_attrib_index++] = EGL_SURFACE_TYPE;
+            egl_attrib_list[egl_attrib_index++] =
+              egl_surface_type_from_drawable_type (attrib_list[attrib_index]);
+            break;
+
+          case GDK_GL_X_VISUAL_TYPE:
+          case GDK_GL_TRANSPARENT_INDEX_VALUE:
+          case GDK_GL_TRANSPARENT_ALPHA_VALUE:
+          case GDK_GL_RENDER_TYPE:
+          case GDK_GL_VISUAL_ID:
+          case GDK_GL_SCREEN:
+            /* no EGL equivalent, or only RGBA is possible anyway */
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            break;
+
+          default:
+            if (gdk_egl_gl_config_egl_attrib (attrib) == EGL_NONE)
+              {
+                g_warning ("unknown configuration attribute 0x%x", attrib);
+                goto err_attrib_list;
+              }
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            egl_attrib_list[egl_attrib_index++] = gdk_egl_gl_config_egl_attrib (attrib);
+            egl_attrib_list[egl_attrib_index++] = attrib_list[attrib_index];
+            break;
+        }
+    }
+
+  if (!has_surface_type)
+    {
+      /* a mask of 0 matches any configuration */
+      egl_attrib_list[egl_attrib_index++] = EGL_SURFACE_TYPE;
+      egl_attrib_list[egl_attrib_index++] = for_window ? EGL_WINDOW_BIT : 0;
+    }
+
+  egl_attrib_list[egl_attrib_index++] = EGL_RENDERABLE_TYPE;
+  egl_attrib_list[egl_attrib_index++] = EGL_OPENGL_BIT;
+  egl_attrib_list[egl_attrib_index++] = EGL_COLOR_BUFFER_TYPE;
+  egl_attrib_list[egl_attrib_index++] = EGL_RGB_BUFFER;
+
+  egl_attrib_list[egl_attrib_index++] = EGL_NONE;
+
+  return egl_attrib_list;
+
+err_attrib_list:
+  g_free (egl_attrib_list);
+  return NULL;
+}
+
+/*
+ * Returns TRUE if the configuration can render to windows of the screen,
+ * i.e. if it names a native visual GDK knows about.
+ */
+static gboolean
+gdk_egl_gl_config_has_visual (EGLDisplay  egldisplay,
+                              EGLConfig   eglconfig,
+                              GdkScreen  *screen)
+{
+  EGLint visualid = 0;
+
+  if (screen == NULL)
+    return TRUE;
+
+  if (!eglGetConfigAttrib (egldisplay, eglconfig, EGL_NATIVE_VISUAL_ID, &visualid) ||
+      visualid == 0)
+    return FALSE;
+
+  return (gdk_x11_screen_lookup_visual (screen, visualid) != NULL);
+}
+
+/*
+ * Picks an EGLConfig from the sorted list returned by eglChooseConfig,
+ * skipping EGL_SLOW_CONFIG configurations unless nothing else matches.
+ */
+static EGLConfig
+gdk_egl_gl_choose_config (EGLDisplay    egldisplay,
+                          GdkScreen    *screen,
+                          const EGLint *egl_attrib_list)
+{
+  EGLConfig *eglconfigs;
+  EGLConfig eglconfig = NULL;
+  EGLint nelements = 0;
+  EGLint caveat;
+  int pass, i;
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglChooseConfig");
+
+  if (!eglChooseConfig (egldisplay, egl_attrib_list, NULL, 0, &nelements) ||
+      nelements == 0)
+    return NULL;
+
+  eglconfigs = g_new (EGLConfig, nelements);
+  eglChooseConfig (egldisplay, egl_attrib_list, eglconfigs, nelements, &nelements);
+
+  for (pass = 0; pass < 2 && eglconfig == NULL; ++pass)
+    {
+      for (i = 0; i < nelements; ++i)
+        {
+          caveat = EGL_NONE;
+          eglGetConfigAttrib (egldisplay, eglconfigs[i], EGL_CONFIG_CAVEAT, &caveat);
+
+          if (pass == 0 && caveat == EGL_SLOW_CONFIG)
+            continue;
+
+          if (gdk_egl_gl_config_has_visual (egldisplay, eglconfigs[i], screen))
+            {
+              eglconfig = eglconfigs[i];
+              break;
+            }
+        }
+    }
+
+  if (eglconfig != NULL && pass > 1)
+    GDK_GL_NOTE (MISC, g_message (" -- eglChooseConfig: only slow configs available"));
+
+  g_free (eglconfigs);
+
+  return eglconfig;
+}
+
+static gboolean
+gdk_egl_gl_config_impl_get_config (GdkGLConfigImplEGL *egl_impl,
+                                   int                 attribute,
+                                   int                *value)
+{
+  EGLint egl_value = 0;
+
+  switch (attribute)
+    {
+      case GDK_GL_USE_GL:
+      case GDK_GL_RGBA:
+        *value = TRUE;
+        return TRUE;
+
+      case GDK_GL_DOUBLEBUFFER:
+        if (!eglGetConfigAttrib (egl_impl->egldisplay, egl_impl->eglconfig,
+                                 EGL_SURFACE_TYPE, &egl_value))
+          return FALSE;
+        *value = (egl_value & EGL_WINDOW_BIT) ? TRUE : FALSE;
+        return TRUE;
+
+      case GDK_GL_STEREO:
+      case GDK_GL_AUX_BUFFERS:
+      case GDK_GL_ACCUM_RED_SIZE:
+      case GDK_GL_ACCUM_GREEN_SIZE:
+      case GDK_GL_ACCUM_BLUE_SIZE:
+      case GDK_GL_ACCUM_ALPHA_SIZE:
+      case GDK_GL_TRANSPARENT_INDEX_VALUE:
+      case GDK_GL_TRANSPARENT_ALPHA_VALUE:
+        *value = 0;
+        return TRUE;
+
+      case GDK_GL_CONFIG_CAVEAT:
+        if (!eglGetConfigAttrib (egl_impl->egldisplay, egl_impl->eglconfig,
+                                 EGL_CONFIG_CAVEAT, &egl_value))
+          return FALSE;
+        if (egl_value == EGL_SLOW_CONFIG)
+          *value = GDK_GL_SLOW_CONFIG;
+        else if (egl_value == EGL_NON_CONFORMANT_CONFIG)
+          *value = GDK_GL_NON_CONFORMANT_CONFIG;
+        else
+          *value = GDK_GL_CONFIG_CAVEAT_NONE;
+        return TRUE;
+
+      case GDK_GL_TRANSPARENT_TYPE:
+        if (!eglGetConfigAttrib (egl_impl->egldisplay, egl_impl->eglconfig,
+                                 EGL_TRANSPARENT_TYPE, &egl_value))
+          return FALSE;
+        *value = (egl_value == EGL_TRANSPARENT_RGB) ? GDK_GL_TRANSPARENT_RGB : GDK_GL_TRANSPARENT_NONE;
+        return TRUE;
+
+      case GDK_GL_DRAWABLE_TYPE:
+        if (!eglGetConfigAttrib (egl_impl->egldisplay, egl_impl->eglconfig,
+                                 EGL_SURFACE_TYPE, &egl_value))
+          return FALSE;
+        *value = 0;
+        if (egl_value & EGL_WINDOW_BIT)
+          *value |= GDK_GL_WINDOW_BIT;
+        if (egl_value & EGL_PBUFFER_BIT)
+          *value |= GDK_GL_PBUFFER_BIT;
+        return TRUE;
+
+      case GDK_GL_RENDER_TYPE:
+        *value = GDK_GL_RGBA_BIT;
+        return TRUE;
+
+      case GDK_GL_X_VISUAL_TYPE:
+        *value = GDK_GL_TRUE_COLOR;
+        return TRUE;
+
+      case GDK_GL_SCREEN:
+        *value = (egl_impl->screen != NULL) ? gdk_x11_screen_get_screen_number (egl_impl->screen) : 0;
+        return TRUE;
+
+      default:
+        if (gdk_egl_gl_config_egl_attrib (attribute) == EGL_NONE)
+          return FALSE;
+        if (!eglGetConfigAttrib (egl_impl->egldisplay, egl_impl->eglconfig,
+                                 gdk_egl_gl_config_egl_attrib (attribute), &egl_value))
+          return FALSE;
+        *value = egl_value;
+        return TRUE;
+    }
+}
+
+static void
+gdk_egl_gl_config_impl_init_attrib (GdkGLConfig *glconfig)
+{
+  GdkGLConfigImplEGL *egl_impl;
+  int value;
+
+  egl_impl = GDK_GL_CONFIG_IMPL_EGL (glconfig->impl);
+
+#define _GET_CONFIG(__attrib) \
+  (value = 0, gdk_egl_gl_config_impl_get_config (egl_impl, __attrib, &value))
+
+  glconfig->impl->is_rgba = TRUE;
+  glconfig->impl->is_stereo = FALSE;
+  glconfig->impl->n_aux_buffers = 0;
+  glconfig->impl->has_accum_buffer = FALSE;
+
+  /* Layer plane. */
+  _GET_CONFIG (GDK_GL_LEVEL);
+  glconfig->impl->layer_plane = value;
+
+  /* Window surfaces are double-buffered. */
+  _GET_CONFIG (GDK_GL_DOUBLEBUFFER);
+  glconfig->impl->is_double_buffered = value ? TRUE : FALSE;
+
+  /* Has alpha bits? */
+  _GET_CONFIG (GDK_GL_ALPHA_SIZE);
+  glconfig->impl->has_alpha = value ? TRUE : FALSE;
+
+  /* Has depth buffer? */
+  _GET_CONFIG (GDK_GL_DEPTH_SIZE);
+  glconfig->impl->has_depth_buffer = value ? TRUE : FALSE;
+
+  /* Has stencil buffer? */
+  _GET_CONFIG (GDK_GL_STENCIL_SIZE);
+  glconfig->impl->has_stencil_buffer = value ? TRUE : FALSE;
+
+  /* Number of multisample buffers */
+  _GET_CONFIG (GDK_GL_SAMPLE_BUFFERS);
+  glconfig->impl->n_sample_buffers = value;
+
+#undef _GET_CONFIG
+}
+
+/*
+ * Instantiates the GdkGLConfigImplEGL object for a chosen EGLConfig.
+ * screen is NULL for surfaceless configurations.
+ */
+static GdkGLConfig *
+gdk_egl_gl_config_impl_init_common (GdkGLConfig *glconfig,
+                                    GdkScreen   *screen,
+                                    EGLDisplay   egldisplay,
+                                    EGLConfig    eglconfig)
+{
+  GdkGLConfigImplEGL *egl_impl;
+
+  egl_impl = g_object_new (GDK_TYPE_GL_CONFIG_IMPL_EGL, NULL);
+
+  egl_impl->egldisplay = egldisplay;
+  egl_impl->eglconfig = eglconfig;
+  egl_impl->screen = screen;
+
+  /*
+   * Init GdkGLConfig
+   */
+  glconfig->impl = GDK_GL_CONFIG_IMPL (egl_impl);
+
+  /*
+   * Init configuration attributes.
+   */
+
+  gdk_egl_gl_config_impl_init_attrib (glconfig);
+
+  return glconfig;
+}
+
+static GdkGLConfig *
+gdk_egl_gl_config_impl_new_common (GdkGLConfig *glconfig,
+                                   GdkScreen   *screen,
+                                   EGLDisplay   egldisplay,
+                                   const int   *attrib_list,
+                                   gsize        n_attribs)
+{
+  EGLint *egl_attrib_list;
+  EGLConfig eglconfig;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (egldisplay == EGL_NO_DISPLAY)
+    return NULL;
+
+  GDK_GL_NOTE (MISC, _gdk_egl_gl_print_egl_info (egldisplay));
+
+  /*
+   * Find an OpenGL-capable frame buffer configuration.
+   */
+
+  egl_attrib_list = egl_attrib_list_from_attrib_list (attrib_list, n_attribs, screen != NULL);
+  if (egl_attrib_list == NULL)
+    return NULL;
+
+  eglconfig = gdk_egl_gl_choose_config (egldisplay, screen, egl_attrib_list);
+
+  g_free (egl_attrib_list);
+
+  if (eglconfig == NULL)
+    return NULL;
+
+  /*
+   * Instantiate the GdkGLConfigImplEGL object.
+   */
+
+  return gdk_egl_gl_config_impl_init_common (glconfig, screen, egldisplay, eglconfig);
+}
+
+GdkGLConfig *
+_gdk_egl_gl_config_impl_new_for_screen (GdkGLConfig *glconfig,
+                                        GdkScreen   *screen,
+                                        const int   *attrib_list,
+                                        gsize        n_attribs)
+{
+  EGLDisplay egldisplay;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+  g_return_val_if_fail (GDK_IS_SCREEN (screen), NULL);
+  g_return_val_if_fail (attrib_list != NULL, NULL);
+
+  egldisplay = _gdk_egl_gl_get_egldisplay_for_display (gdk_screen_get_display (screen));
+
+  return gdk_egl_gl_config_impl_new_common (glconfig, screen, egldisplay,
+                                            attrib_list, n_attribs);
+}
+
+GdkGLConfig *
+_gdk_egl_gl_config_impl_new_surfaceless (GdkGLConfig *glconfig,
+                                         const int   *attrib_list,
+                                         gsize        n_attribs)
+{
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+  g_return_val_if_fail (attrib_list != NULL, NULL);
+
+  return gdk_egl_gl_config_impl_new_common (glconfig, NULL,
+                                            _gdk_egl_gl_get_surfaceless_egldisplay (),
+                                            attrib_list, n_attribs);
+}
+
+/*
+ * Returns a new GdkGLConfig for every window-capable OpenGL configuration
+ * with a visual on the screen, in the order reported by EGL.
+ */
+GList *
+_gdk_egl_gl_config_impl_list_for_screen (GdkScreen *screen)
+{
+  EGLDisplay egldisplay;
+  EGLConfig *eglconfigs;
+  EGLint nelements = 0;
+  EGLint renderable_type, surface_type, color_buffer_type;
+  GdkGLConfig *glconfig;
+  GList *list = NULL;
+  int i;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_SCREEN (screen), NULL);
+
+  egldisplay = _gdk_egl_gl_get_egldisplay_for_display (gdk_screen_get_display (screen));
+  if (egldisplay == EGL_NO_DISPLAY)
+    return NULL;
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglGetConfigs");
+
+  if (!eglGetConfigs (egldisplay, NULL, 0, &nelements) || nelements == 0)
+    return NULL;
+
+  eglconfigs = g_new (EGLConfig, nelements);
+  eglGetConfigs (egldisplay, eglconfigs, nelements, &nelements);
+
+  for (i = 0; i < nelements; ++i)
+    {
+      renderable_type = surface_type = color_buffer_type = 0;
+
+      eglGetConfigAttrib (egldisplay, eglconfigs[i], EGL_RENDERABLE_TYPE, &renderable_type);
+      eglGetConfigAttrib (egldisplay, eglconfigs[i], EGL_SURFACE_TYPE, &surface_type);
+      eglGetConfigAttrib (egldisplay, eglconfigs[i], EGL_COLOR_BUFFER_TYPE, &color_buffer_type);
+
+      if (!(renderable_type & EGL_OPENGL_BIT) ||
+          !(surface_type & EGL_WINDOW_BIT) ||
+          color_buffer_type != EGL_RGB_BUFFER)
+        continue;
+
+      if (!gdk_egl_gl_config_has_visual (egldisplay, eglconfigs[i], screen))
+        continue;
+
+      glconfig = g_object_new (GDK_TYPE_EGL_GL_CONFIG, NULL);
+      list = g_list_prepend (list,
+                             gdk_egl_gl_config_impl_init_common (glconfig, screen,
+                                                                 egldisplay, eglconfigs[i]));
+    }
+
+  g_free (eglconfigs);
+
+  return g_list_reverse (list);
+}
+
+static EGLDisplay
+_gdk_egl_gl_config_impl_get_egldisplay (GdkGLConfig *glconfig)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), EGL_NO_DISPLAY);
+
+  return GDK_GL_CONFIG_IMPL_EGL (glconfig->impl)->egldisplay;
+}
+
+static EGLConfig
+_gdk_egl_gl_config_impl_get_eglconfig (GdkGLConfig *glconfig)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+
+  return GDK_GL_CONFIG_IMPL_EGL (glconfig->impl)->eglconfig;
+}
+
+static GdkGLWindow *
+_gdk_egl_gl_config_impl_create_gl_window (GdkGLConfig *glconfig,
+                                          GdkWindow   *window,
+                                          const int   *attrib_list)
+{
+  GdkGLWindow *glwindow;
+  GdkGLWindow *impl;
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+
+  if (GDK_GL_CONFIG_IMPL_EGL (glconfig->impl)->screen == NULL)
+    {
+      g_warning ("cannot create a window with a surfaceless config");
+      return NULL;
+    }
+
+  glwindow = g_object_new (GDK_TYPE_EGL_GL_WINDOW, NULL);
+
+  g_return_val_if_fail (glwindow != NULL, NULL);
+
+  impl = _gdk_egl_gl_window_impl_new (glwindow,
+                                      glconfig,
+                                      window,
+                                      attrib_list);
+  if (impl == NULL)
+    g_object_unref (glwindow);
+
+  g_return_val_if_fail (impl != NULL, NULL);
+
+  return glwindow;
+}
+
+static GdkScreen *
+_gdk_egl_gl_config_impl_get_screen (GdkGLConfig *glconfig)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+
+  return GDK_GL_CONFIG_IMPL_EGL (glconfig->impl)->screen;
+}
+
+static gboolean
+_gdk_egl_gl_config_impl_get_attrib (GdkGLConfig *glconfig,
+                                    int          attribute,
+                                    int         *value)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), FALSE);
+
+  return gdk_egl_gl_config_impl_get_config (GDK_GL_CONFIG_IMPL_EGL (glconfig->impl),
+                                            attribute, value);
+}
+
+static GdkVisual *
+_gdk_egl_gl_config_impl_get_visual (GdkGLConfig *glconfig)
+{
+  GdkGLConfigImplEGL *egl_impl;
+  EGLint visualid = 0;
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+
+  egl_impl = GDK_GL_CONFIG_IMPL_EGL (glconfig->impl);
+
+  if (egl_impl->screen == NULL)
+    return NULL;
+
+  eglGetConfigAttrib (egl_impl->egldisplay, egl_impl->eglconfig,
+                      EGL_NATIVE_VISUAL_ID, &visualid);
+
+  return gdk_x11_screen_lookup_visual (egl_impl->screen, visualid);
+}
+
+static gint
+_gdk_egl_gl_config_impl_get_depth (GdkGLConfig *glconfig)
+{
+  GdkGLConfigImplEGL *egl_impl;
+  GdkVisual *visual;
+  EGLint value = 0;
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), 0);
+
+  egl_impl = GDK_GL_CONFIG_IMPL_EGL (glconfig->impl);
+
+  visual = _gdk_egl_gl_config_impl_get_visual (glconfig);
+  if (visual != NULL)
+    return gdk_visual_get_depth (visual);
+
+  eglGetConfigAttrib (egl_impl->egldisplay, egl_impl->eglconfig,
+                      EGL_BUFFER_SIZE, &value);
+
+  return value;
+}
@@ -0,0 +1,70 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifndef __GDK_GL_CONFIG_EGL_H__
+#define __GDK_GL_CONFIG_EGL_H__
+
+#include <EGL/egl.h>
+
+#include <gdk/gdkglconfig.h>
+#include <gdk/gdkglconfigimpl.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkGLConfigImplEGL      GdkGLConfigImplEGL;
+typedef struct _GdkGLConfigImplEGLClass GdkGLConfigImplEGLClass;
+
+#define GDK_TYPE_GL_CONFIG_IMPL_EGL              (gdk_gl_config_impl_egl_get_type ())
+#define GDK_GL_CONFIG_IMPL_EGL(object)           (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_CONFIG_IMPL_EGL, GdkGLConfigImplEGL))
+#define GDK_GL_CONFIG_IMPL_EGL_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_CONFIG_IMPL_EGL, GdkGLConfigImplEGLClass))
+#define GDK_IS_GL_CONFIG_IMPL_EGL(object)        (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_CONFIG_IMPL_EGL))
+#define GDK_IS_GL_CONFIG_IMPL_EGL_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_CONFIG_IMPL_EGL))
+#define GDK_GL_CONFIG_IMPL_EGL_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_CONFIG_IMPL_EGL, GdkGLConfigImplEGLClass))
+
+struct _GdkGLConfigImplEGL
+{
+  GdkGLConfigImpl parent_instance;
+
+  EGLDisplay egldisplay;
+  EGLConfig eglconfig;
+
+  GdkScreen *screen;            /* NULL for surfaceless configs */
+};
+
+struct _GdkGLConfigImplEGLClass
+{
+  GdkGLConfigImplClass parent_class;
+
+  EGLDisplay (*get_egldisplay) (GdkGLConfig *glconfig);
+  EGLConfig  (*get_eglconfig)  (GdkGLConfig *glconfig);
+};
+
+GType gdk_gl_config_impl_egl_get_type (void);
+
+GdkGLConfig *_gdk_egl_gl_config_impl_new_for_screen      (GdkGLConfig *glconfig,
+                                                          GdkScreen   *screen,
+                                                          const int   *attrib_list,
+                                                          gsize        n_attribs);
+GdkGLConfig *_gdk_egl_gl_config_impl_new_surfaceless     (GdkGLConfig *glconfig,
+                                                          const int   *attrib_list,
+                                                          gsize        n_attribs);
+GList       *_gdk_egl_gl_config_impl_list_for_screen     (GdkScreen   *screen);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_CONFIG_EGL_H__ */
@@ -0,0 +1,877 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gdk/gdk.h>
+
+#include "gdkglegl.h"
+#include "gdkglprivate-egl.h"
+#include "gdkglquery-egl.h"
+#include "gdkglconfig-egl.h"
+#include "gdkglwindow-egl.h"
+#include "gdkglcontext-egl.h"
+
+static void          gdk_gl_context_insert (GdkGLContext *glcontext);
+static void          gdk_gl_context_remove (GdkGLContext *glcontext);
+static GdkGLContext *gdk_gl_context_lookup (EGLContext    eglcontext);
+
+static gboolean       _gdk_egl_gl_context_impl_copy             (GdkGLContext  *glcontext,
+                                                                 GdkGLContext  *src,
+                                                                 unsigned long  mask);
+static GdkGLDrawable* _gdk_egl_gl_context_impl_get_gl_drawable  (GdkGLContext *glcontext);
+static GdkGLConfig*   _gdk_egl_gl_context_impl_get_gl_config    (GdkGLContext *glcontext);
+static GdkGLContext*  _gdk_egl_gl_context_impl_get_share_list   (GdkGLContext *glcontext);
+static gboolean       _gdk_egl_gl_context_impl_is_direct        (GdkGLContext *glcontext);
+static int            _gdk_egl_gl_context_impl_get_render_type  (GdkGLContext *glcontext);
+static gboolean       _gdk_egl_gl_context_impl_make_current     (GdkGLContext  *glcontext,
+                                                                 GdkGLDrawable *draw,
+                                                                 GdkGLDrawable *read);
+static EGLContext     _gdk_egl_gl_context_impl_get_eglcontext   (GdkGLContext *glcontext);
+
+G_DEFINE_TYPE (GdkGLContextImplEGL,             \
+               gdk_gl_context_impl_egl,         \
+               GDK_TYPE_GL_CONTEXT_IMPL)
+
+/*
+ * Per-thread record of the last binding made through make_current,
+ * as in the GLX backend.
+ */
+typedef struct
+{
+  EGLContext     eglcontext;
+  GdkGLContext  *glcontext;
+  GdkGLDrawable *draw;
+  GdkGLDrawable *read;
+} GdkGLContextBindingEGL;
+
+static GPrivate current_binding = G_PRIVATE_INIT (g_free);
+
+static GdkGLContextBindingEGL *
+gdk_egl_gl_context_get_binding (void)
+{
+  GdkGLContextBindingEGL *binding;
+
+  binding = g_private_get (&current_binding);
+  if (binding == NULL)
+    {
+      binding = g_new0 (GdkGLContextBindingEGL, 1);
+      g_private_set (&current_binding, binding);
+    }
+
+  return binding;
+}
+
+static void
+gdk_egl_gl_context_set_binding (EGLContext     eglcontext,
+                                GdkGLContext  *glcontext,
+                                GdkGLDrawable *draw,
+                                GdkGLDrawable *read)
+{
+  GdkGLContextBindingEGL *binding = gdk_egl_gl_context_get_binding ();
+
+  binding->eglcontext = eglcontext;
+  binding->glcontext = glcontext;
+  binding->draw = draw;
+  binding->read = read;
+}
+
+static void
+gdk_gl_context_impl_egl_init (GdkGLContextImplEGL *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  self->eglcontext = EGL_NO_CONTEXT;
+  self->share_list = NULL;
+  self->render_type = 0;
+  self->glconfig = NULL;
+  self->gldrawable = NULL;
+  self->gldrawable_read = NULL;
+  self->major_version = 0;
+  self->minor_version = 0;
+  self->profile = GDK_GL_CONTEXT_PROFILE_DEFAULT;
+  self->flags = 0;
+  self->eglpbuffer = EGL_NO_SURFACE;
+  self->is_destroyed = 0;
+  self->is_no_error = 0;
+  self->is_surfaceless = 0;
+  self->is_share_list_weak = 0;
+}
+
+static void
+gdk_egl_gl_context_destroy (GdkGLContext *glcontext)
+{
+  GdkGLContextImplEGL *impl = GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl);
+  GdkGLContextBindingEGL *binding;
+  EGLDisplay egldisplay;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (impl->is_destroyed)
+    return;
+
+  gdk_gl_context_remove (glcontext);
+
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (impl->glconfig);
+
+  eglBindAPI (EGL_OPENGL_API);
+
+  if (impl->eglcontext == eglGetCurrentContext ())
+    {
+      eglWaitClient ();
+
+      GDK_GL_NOTE_FUNC_IMPL ("eglMakeCurrent");
+      eglMakeCurrent (egldisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+  binding = g_private_get (&current_binding);
+  if (binding != NULL && binding->glcontext == glcontext)
+    gdk_egl_gl_context_set_binding (EGL_NO_CONTEXT, NULL, NULL, NULL);
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglDestroyContext");
+  eglDestroyContext (egldisplay, impl->eglcontext);
+  impl->eglcontext = EGL_NO_CONTEXT;
+
+  if (impl->eglpbuffer != EGL_NO_SURFACE)
+    {
+      GDK_GL_NOTE_FUNC_IMPL ("eglDestroySurface");
+      eglDestroySurface (egldisplay, impl->eglpbuffer);
+      impl->eglpbuffer = EGL_NO_SURFACE;
+    }
+
+  if (impl->gldrawable != NULL)
+    {
+      g_object_remove_weak_pointer (G_OBJECT (impl->gldrawable),
+                                    (gpointer *) &(impl->gldrawable));
+      impl->gldrawable = NULL;
+    }
+
+  if (impl->gldrawable_read != NULL)
+    {
+      g_object_remove_weak_pointer (G_OBJECT (impl->gldrawable_read),
+                                    (gpointer *) &(impl->gldrawable_read));
+      impl->gldrawable_read = NULL;
+    }
+
+  impl->is_destroyed = TRUE;
+}
+
+static void
+gdk_gl_context_impl_egl_finalize (GObject *object)
+{
+  GdkGLContextImplEGL *impl = GDK_GL_CONTEXT_IMPL_EGL (object);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  gdk_egl_gl_context_destroy (GDK_GL_CONTEXT (object));
+
+  g_object_unref (G_OBJECT (impl->glconfig));
+
+  if (impl->share_list != NULL)
+    {
+      if (impl->is_share_list_weak)
+        g_object_remove_weak_pointer (G_OBJECT (impl->share_list),
+                                      (gpointer *) &(impl->share_list));
+      else
+        g_object_unref (G_OBJECT (impl->share_list));
+    }
+
+  G_OBJECT_CLASS (gdk_gl_context_impl_egl_parent_class)->finalize (object);
+}
+
+static void
+gdk_gl_context_impl_egl_class_init (GdkGLContextImplEGLClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  klass->get_eglcontext = _gdk_egl_gl_context_impl_get_eglcontext;
+
+  klass->parent_class.copy_gl_context_impl = _gdk_egl_gl_context_impl_copy;
+  klass->parent_class.get_gl_drawable = _gdk_egl_gl_context_impl_get_gl_drawable;
+  klass->parent_class.get_gl_config   = _gdk_egl_gl_context_impl_get_gl_config;
+  klass->parent_class.get_share_list  = _gdk_egl_gl_context_impl_get_share_list;
+  klass->parent_class.is_direct       = _gdk_egl_gl_context_impl_is_direct;
+  klass->parent_class.get_render_type = _gdk_egl_gl_context_impl_get_render_type;
+  klass->parent_class.make_current    = _gdk_egl_gl_context_impl_make_current;
+  klass->parent_class.make_uncurrent  = NULL;
+
+  object_class->finalize = gdk_gl_context_impl_egl_finalize;
+}
+
+#ifndef EGL_KHR_create_context
+#define EGL_CONTEXT_MAJOR_VERSION_KHR             0x3098
+#define EGL_CONTEXT_MINOR_VERSION_KHR             0x30FB
+#define EGL_CONTEXT_FLAGS_KHR                     0x30FC
+#define EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR       0x30FD
+#endif
+#ifndef EGL_KHR_create_context_no_error
+#define EGL_CONTEXT_OPENGL_NO_ERROR_KHR           0x31B3
+#endif
+
+/*
+ * Creates an OpenGL context, through EGL_KHR_create_context when a
+ * version, profile or flags are requested. GdkGLContextProfile and
+ * GdkGLContextFlags bits have the same values as the EGL ones.
+ */
+static EGLContext
+gdk_egl_gl_create_context (GdkGLConfig         *glconfig,
+                           EGLContext           share_eglcontext,
+                           int                  major_version,
+                           int                  minor_version,
+                           GdkGLContextProfile  profile,
+                           GdkGLContextFlags    flags)
+{
+  EGLDisplay egldisplay;
+  EGLint attrib_list[11];
+  int n = 0;
+
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (glconfig);
+
+  if (major_version > 0)
+    {
+      attrib_list[n++] = EGL_CONTEXT_MAJOR_VERSION_KHR;
+      attrib_list[n++] = major_version;
+      attrib_list[n++] = EGL_CONTEXT_MINOR_VERSION_KHR;
+      attrib_list[n++] = minor_version;
+    }
+  if (profile != GDK_GL_CONTEXT_PROFILE_DEFAULT)
+    {
+      attrib_list[n++] = EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR;
+      attrib_list[n++] = profile;
+    }
+  if (flags & GDK_GL_CONTEXT_NO_ERROR_BIT)
+    {
+      attrib_list[n++] = EGL_CONTEXT_OPENGL_NO_ERROR_KHR;
+      attrib_list[n++] = EGL_TRUE;
+      flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+    }
+  if (flags != 0)
+    {
+      attrib_list[n++] = EGL_CONTEXT_FLAGS_KHR;
+      attrib_list[n++] = flags;
+    }
+  attrib_list[n] = EGL_NONE;
+
+  GDK_GL_NOTE (MISC,
+    g_message (" -- Context: version %d.%d, profile 0x%x, flags 0x%x",
+               major_version, minor_version, profile, flags));
+
+  eglBindAPI (EGL_OPENGL_API);
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglCreateContext");
+
+  return eglCreateContext (egldisplay,
+                           GDK_GL_CONFIG_EGLCONFIG (glconfig),
+                           share_eglcontext,
+                           attrib_list);
+}
+
+static GdkGLContextImpl *
+gdk_egl_gl_context_impl_create (GdkGLContext        *glcontext,
+                                GdkGLConfig         *glconfig,
+                                GdkGLContext        *share_list,
+                                int                  render_type,
+                                int                  major_version,
+                                int                  minor_version,
+                                GdkGLContextProfile  profile,
+                                GdkGLContextFlags    flags)
+{
+  GdkGLContextImplEGL *share_impl = NULL;
+  EGLContext share_eglcontext = EGL_NO_CONTEXT;
+  EGLDisplay egldisplay;
+  EGLContext eglcontext;
+  GdkGLContextImpl *impl;
+  GdkGLContextImplEGL *egl_impl;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (glconfig);
+
+  if (share_list != NULL && GDK_IS_GL_CONTEXT (share_list))
+    {
+      share_impl = GDK_GL_CONTEXT_IMPL_EGL (share_list->impl);
+      share_eglcontext = share_impl->eglcontext;
+    }
+
+  if (_gdk_gl_context_no_error)
+    flags |= GDK_GL_CONTEXT_NO_ERROR_BIT;
+
+  /* Contexts sharing objects must agree on the no-error mode. */
+  if (share_impl != NULL)
+    {
+      if (share_impl->is_no_error)
+        flags |= GDK_GL_CONTEXT_NO_ERROR_BIT;
+      else
+        flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+    }
+
+  if ((flags & GDK_GL_CONTEXT_NO_ERROR_BIT) &&
+      ((flags & GDK_GL_CONTEXT_DEBUG_BIT) ||
+       !_gdk_egl_gl_query_display_extension (egldisplay, "EGL_KHR_create_context_no_error")))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- No-error context not available"));
+
+      flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+    }
+
+  if ((major_version > 0 || profile != GDK_GL_CONTEXT_PROFILE_DEFAULT || flags != 0) &&
+      !_gdk_egl_gl_query_display_extension (egldisplay, "EGL_KHR_create_context"))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- EGL_KHR_create_context not supported"));
+
+      major_version = minor_version = 0;
+      profile = GDK_GL_CONTEXT_PROFILE_DEFAULT;
+      flags = 0;
+    }
+
+  eglcontext = gdk_egl_gl_create_context (glconfig, share_eglcontext,
+                                          major_version, minor_version,
+                                          profile, flags);
+  if (eglcontext == EGL_NO_CONTEXT && (flags & GDK_GL_CONTEXT_NO_ERROR_BIT))
+    {
+      /* no-error is only a hint; retry with validation on */
+      GDK_GL_NOTE (MISC, g_message (" -- No-error context rejected"));
+
+      flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+      eglcontext = gdk_egl_gl_create_context (glconfig, share_eglcontext,
+                                              major_version, minor_version,
+                                              profile, flags);
+    }
+  if (eglcontext == EGL_NO_CONTEXT)
+    return NULL;
+
+  /*
+   * Instantiate the GdkGLContextImplEGL object.
+   */
+
+  impl = g_object_new (GDK_TYPE_GL_CONTEXT_IMPL_EGL, NULL);
+  egl_impl = GDK_GL_CONTEXT_IMPL_EGL (impl);
+
+  egl_impl->eglcontext = eglcontext;
+
+  if (share_impl != NULL)
+    {
+      egl_impl->share_list = share_list;
+      g_object_ref (G_OBJECT (egl_impl->share_list));
+    }
+
+  egl_impl->render_type = render_type;
+
+  egl_impl->glconfig = glconfig;
+  g_object_ref (G_OBJECT (egl_impl->glconfig));
+
+  egl_impl->is_no_error = (flags & GDK_GL_CONTEXT_NO_ERROR_BIT) ? TRUE : FALSE;
+
+  /* remembered so that worker contexts can match the request */
+  egl_impl->major_version = major_version;
+  egl_impl->minor_version = minor_version;
+  egl_impl->profile = profile;
+  egl_impl->flags = flags;
+
+  glcontext->impl = impl;
+
+  /*
+   * Insert into the GL context hash table.
+   */
+
+  gdk_gl_context_insert (glcontext);
+
+  return impl;
+}
+
+/*< private >*/
+GdkGLContextImpl *
+_gdk_egl_gl_context_impl_new_full (GdkGLContext        *glcontext,
+                                   GdkGLDrawable       *gldrawable,
+                                   GdkGLContext        *share_list,
+                                   gboolean             direct,
+                                   int                  render_type,
+                                   int                  major_version,
+                                   int                  minor_version,
+                                   GdkGLContextProfile  profile,
+                                   GdkGLContextFlags    flags)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  /* EGL contexts are always direct */
+  return gdk_egl_gl_context_impl_create (glcontext,
+                                         gdk_gl_drawable_get_gl_config (gldrawable),
+                                         share_list,
+                                         render_type,
+                                         major_version,
+                                         minor_version,
+                                         profile,
+                                         flags);
+}
+
+/*
+ * Creates the 1x1 pbuffer that an offscreen context is bound to. Returns
+ * EGL_NO_SURFACE if @glconfig does not support pbuffers.
+ */
+static EGLSurface
+gdk_egl_gl_create_hidden_pbuffer (GdkGLConfig *glconfig)
+{
+  EGLDisplay egldisplay;
+  EGLConfig eglconfig;
+  EGLint surface_type = 0;
+  static const EGLint pbuffer_attribs[] = {
+    EGL_WIDTH,  1,
+    EGL_HEIGHT, 1,
+    EGL_NONE
+  };
+
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (glconfig);
+  eglconfig = GDK_GL_CONFIG_EGLCONFIG (glconfig);
+
+  if (!eglGetConfigAttrib (egldisplay, eglconfig, EGL_SURFACE_TYPE, &surface_type) ||
+      !(surface_type & EGL_PBUFFER_BIT))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Config has no pbuffer support"));
+      return EGL_NO_SURFACE;
+    }
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglCreatePbufferSurface");
+
+  return eglCreatePbufferSurface (egldisplay, eglconfig, pbuffer_attribs);
+}
+
+/*< private >*/
+GdkGLContextImpl *
+_gdk_egl_gl_context_impl_new_offscreen (GdkGLContext        *glcontext,
+                                        GdkGLConfig         *glconfig,
+                                        GdkGLContext        *share_list,
+                                        gboolean             direct,
+                                        int                  render_type,
+                                        int                  major_version,
+                                        int                  minor_version,
+                                        GdkGLContextProfile  profile,
+                                        GdkGLContextFlags    flags)
+{
+  GdkGLContextImpl *impl;
+  EGLSurface eglpbuffer;
+  gboolean is_surfaceless = FALSE;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+
+  /*
+   * As with GLX, an offscreen context is bound to a 1x1 pbuffer of its
+   * own, or to no surface at all with EGL_KHR_surfaceless_context.
+   */
+
+  eglpbuffer = gdk_egl_gl_create_hidden_pbuffer (glconfig);
+  if (eglpbuffer == EGL_NO_SURFACE)
+    {
+      if (!_gdk_egl_gl_query_display_extension (GDK_GL_CONFIG_EGLDISPLAY (glconfig),
+                                                "EGL_KHR_surfaceless_context"))
+        return NULL;
+
+      GDK_GL_NOTE (MISC, g_message (" -- Surfaceless context"));
+
+      is_surfaceless = TRUE;
+    }
+
+  impl = gdk_egl_gl_context_impl_create (glcontext,
+                                         glconfig,
+                                         share_list,
+                                         render_type,
+                                         major_version,
+                                         minor_version,
+                                         profile,
+                                         flags);
+  if (impl == NULL)
+    {
+      if (eglpbuffer != EGL_NO_SURFACE)
+        eglDestroySurface (GDK_GL_CONFIG_EGLDISPLAY (glconfig), eglpbuffer);
+      return NULL;
+    }
+
+  GDK_GL_CONTEXT_IMPL_EGL (impl)->eglpbuffer = eglpbuffer;
+  GDK_GL_CONTEXT_IMPL_EGL (impl)->is_surfaceless = is_surfaceless;
+
+  return impl;
+}
+
+/*< private >*/
+GdkGLContextImpl *
+_gdk_egl_gl_context_impl_new_worker (GdkGLContext *glcontext,
+                                     GdkGLContext *share_list)
+{
+  GdkGLContextImplEGL *share_impl;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (share_list), NULL);
+
+  share_impl = GDK_GL_CONTEXT_IMPL_EGL (share_list->impl);
+
+  return _gdk_egl_gl_context_impl_new_offscreen (glcontext,
+                                                 share_impl->glconfig,
+                                                 share_list,
+                                                 TRUE,
+                                                 share_impl->render_type,
+                                                 share_impl->major_version,
+                                                 share_impl->minor_version,
+                                                 share_impl->profile,
+                                                 share_impl->flags);
+}
+
+/*< private >*/
+void
+_gdk_egl_gl_context_impl_weaken_share_list (GdkGLContext *glcontext)
+{
+  GdkGLContextImplEGL *impl = GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (impl->share_list == NULL || impl->is_share_list_weak)
+    return;
+
+  g_object_add_weak_pointer (G_OBJECT (impl->share_list),
+                             (gpointer *) &(impl->share_list));
+  g_object_unref (G_OBJECT (impl->share_list));
+
+  impl->is_share_list_weak = TRUE;
+}
+
+static gboolean
+_gdk_egl_gl_context_impl_copy (GdkGLContext  *glcontext,
+                               GdkGLContext  *src,
+                               unsigned long  mask)
+{
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), FALSE);
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (src), FALSE);
+
+  /* EGL has no equivalent of glXCopyContext */
+  GDK_GL_NOTE (MISC, g_message (" -- Context copy is not supported by EGL"));
+
+  return FALSE;
+}
+
+/*< private >*/
+void
+_gdk_egl_gl_context_impl_set_gl_drawable (GdkGLContext  *glcontext,
+                                          GdkGLDrawable *gldrawable)
+{
+  GdkGLContextImplEGL *impl = GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (impl->gldrawable == gldrawable)
+    return;
+
+  if (impl->gldrawable != NULL)
+    {
+      g_object_remove_weak_pointer (G_OBJECT (impl->gldrawable),
+                                    (gpointer *) &(impl->gldrawable));
+      impl->gldrawable = NULL;
+    }
+
+  if (gldrawable != NULL && GDK_IS_GL_DRAWABLE (gldrawable))
+    {
+      impl->gldrawable = gldrawable;
+      g_object_add_weak_pointer (G_OBJECT (impl->gldrawable),
+                                 (gpointer *) &(impl->gldrawable));
+    }
+}
+
+/*< private >*/
+void
+_gdk_egl_gl_context_impl_set_gl_drawable_read (GdkGLContext  *glcontext,
+                                               GdkGLDrawable *gldrawable_read)
+{
+  GdkGLContextImplEGL *impl = GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (impl->gldrawable_read == gldrawable_read)
+    return;
+
+  if (impl->gldrawable_read != NULL)
+    {
+      g_object_remove_weak_pointer (G_OBJECT (impl->gldrawable_read),
+                                    (gpointer *) &(impl->gldrawable_read));
+      impl->gldrawable_read = NULL;
+    }
+
+  if (gldrawable_read != NULL && GDK_IS_GL_DRAWABLE (gldrawable_read))
+    {
+      impl->gldrawable_read = gldrawable_read;
+      g_object_add_weak_pointer (G_OBJECT (impl->gldrawable_read),
+                                 (gpointer *) &(impl->gldrawable_read));
+    }
+}
+
+static GdkGLDrawable *
+_gdk_egl_gl_context_impl_get_gl_drawable (GdkGLContext *glcontext)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), NULL);
+
+  return GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl)->gldrawable;
+}
+
+static GdkGLConfig *
+_gdk_egl_gl_context_impl_get_gl_config (GdkGLContext *glcontext)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), NULL);
+
+  return GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl)->glconfig;
+}
+
+static GdkGLContext *
+_gdk_egl_gl_context_impl_get_share_list (GdkGLContext *glcontext)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), NULL);
+
+  return GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl)->share_list;
+}
+
+static gboolean
+_gdk_egl_gl_context_impl_is_direct (GdkGLContext *glcontext)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), FALSE);
+
+  return TRUE;
+}
+
+static int
+_gdk_egl_gl_context_impl_get_render_type (GdkGLContext *glcontext)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), 0);
+
+  return GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl)->render_type;
+}
+
+static gboolean
+_gdk_egl_gl_context_impl_make_current (GdkGLContext  *glcontext,
+                                       GdkGLDrawable *draw,
+                                       GdkGLDrawable *read)
+{
+  GdkGLContextImplEGL *impl;
+  GdkGLWindowImplEGL *egl_impl;
+  GdkGLConfig *glconfig;
+  GdkGLConfig *read_glconfig;
+  GdkGLContextBindingEGL *binding;
+  EGLDisplay egldisplay;
+  EGLSurface eglsurface;
+  EGLSurface eglsurface_read;
+  EGLContext eglcontext;
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), FALSE);
+  g_return_val_if_fail (draw == NULL || GDK_IS_EGL_GL_WINDOW (draw), FALSE);
+  g_return_val_if_fail (read == NULL || GDK_IS_EGL_GL_WINDOW (read), FALSE);
+
+  impl = GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl);
+  eglcontext = impl->eglcontext;
+
+  if (read == NULL)
+    read = draw;
+
+  if (draw == NULL)
+    {
+      /* offscreen contexts render to their own hidden pbuffer, or
+         to no surface at all */
+      if (impl->eglpbuffer == EGL_NO_SURFACE && !impl->is_surfaceless)
+        {
+          g_warning ("a draw drawable is required");
+          return FALSE;
+        }
+
+      glconfig = read_glconfig = impl->glconfig;
+      eglsurface = eglsurface_read = impl->eglpbuffer;
+    }
+  else
+    {
+      egl_impl = GDK_GL_WINDOW_IMPL_EGL (GDK_GL_WINDOW (draw)->impl);
+      glconfig = egl_impl->glconfig;
+      eglsurface = egl_impl->eglsurface;
+
+      egl_impl = GDK_GL_WINDOW_IMPL_EGL (GDK_GL_WINDOW (read)->impl);
+      read_glconfig = egl_impl->glconfig;
+      eglsurface_read = egl_impl->eglsurface;
+    }
+
+  if (eglcontext == EGL_NO_CONTEXT)
+    return FALSE;
+  if ((eglsurface == EGL_NO_SURFACE || eglsurface_read == EGL_NO_SURFACE) &&
+      !impl->is_surfaceless)
+    return FALSE;
+
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (glconfig);
+
+  /* The bound API is per-thread state. */
+  eglBindAPI (EGL_OPENGL_API);
+
+  binding = g_private_get (&current_binding);
+  if (binding != NULL &&
+      binding->glcontext == glcontext &&
+      binding->draw == draw &&
+      binding->read == read &&
+      eglGetCurrentContext () == eglcontext &&
+      eglGetCurrentSurface (EGL_DRAW) == eglsurface &&
+      eglGetCurrentSurface (EGL_READ) == eglsurface_read)
+    {
+      g_atomic_int_inc (&_gdk_gl_context_n_make_current_skipped);
+      return TRUE;
+    }
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglMakeCurrent");
+
+  if (!eglMakeCurrent (egldisplay, eglsurface, eglsurface_read, eglcontext))
+    {
+      g_warning ("eglMakeCurrent() failed (0x%x)", eglGetError ());
+      gdk_egl_gl_context_set_binding (EGL_NO_CONTEXT, NULL, NULL, NULL);
+      _gdk_egl_gl_context_impl_set_gl_drawable (glcontext, NULL);
+      _gdk_egl_gl_context_impl_set_gl_drawable_read (glcontext, NULL);
+      return FALSE;
+    }
+
+  gdk_egl_gl_context_set_binding (eglcontext, glcontext, draw, read);
+  _gdk_egl_gl_context_impl_set_gl_drawable (glcontext, draw);
+  _gdk_egl_gl_context_impl_set_gl_drawable_read (glcontext, read);
+
+  if (eglsurface != EGL_NO_SURFACE && _GDK_GL_CONFIG_AS_SINGLE_MODE (glconfig))
+    glDrawBuffer (GL_FRONT);
+  if (eglsurface_read != EGL_NO_SURFACE && _GDK_GL_CONFIG_AS_SINGLE_MODE (read_glconfig))
+    glReadBuffer (GL_FRONT);
+
+  GDK_GL_NOTE (MISC, _gdk_gl_print_gl_info ());
+
+  return TRUE;
+}
+
+GdkGLContext *
+_gdk_egl_gl_context_impl_get_current (void)
+{
+  GdkGLContextBindingEGL *binding;
+  GdkGLContext *glcontext;
+  EGLContext eglcontext;
+
+  GDK_GL_NOTE_FUNC ();
+
+  eglBindAPI (EGL_OPENGL_API);
+
+  eglcontext = eglGetCurrentContext ();
+
+  if (eglcontext == EGL_NO_CONTEXT)
+    return NULL;
+
+  binding = g_private_get (&current_binding);
+  if (binding != NULL && binding->eglcontext == eglcontext)
+    return binding->glcontext;
+
+  glcontext = gdk_gl_context_lookup (eglcontext);
+  if (glcontext != NULL)
+    gdk_egl_gl_context_set_binding (eglcontext, glcontext, NULL, NULL);
+
+  return glcontext;
+}
+
+static EGLContext
+_gdk_egl_gl_context_impl_get_eglcontext (GdkGLContext *glcontext)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONTEXT (glcontext), EGL_NO_CONTEXT);
+
+  return GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl)->eglcontext;
+}
+
+/*
+ * GdkGLContext hash table.
+ */
+
+G_LOCK_DEFINE_STATIC (gl_context_ht);
+
+static GHashTable *gl_context_ht = NULL;
+
+static void
+gdk_gl_context_insert (GdkGLContext *glcontext)
+{
+  GdkGLContextImplEGL *impl;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  G_LOCK (gl_context_ht);
+
+  if (gl_context_ht == NULL)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Create GL context hash table."));
+
+      /* EGLContext is an opaque pointer */
+      gl_context_ht = g_hash_table_new (g_direct_hash,
+                                        g_direct_equal);
+    }
+
+  impl = GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl);
+
+  g_hash_table_insert (gl_context_ht, impl->eglcontext, glcontext);
+
+  G_UNLOCK (gl_context_ht);
+}
+
+static void
+gdk_gl_context_remove (GdkGLContext *glcontext)
+{
+  GdkGLContextImplEGL *impl;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  G_LOCK (gl_context_ht);
+
+  if (gl_context_ht == NULL)
+    {
+      G_UNLOCK (gl_context_ht);
+      return;
+    }
+
+  impl = GDK_GL_CONTEXT_IMPL_EGL (glcontext->impl);
+
+  g_hash_table_remove (gl_context_ht, impl->eglcontext);
+
+  if (g_hash_table_size (gl_context_ht) == 0)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Destroy GL context hash table."));
+      g_hash_table_destroy (gl_context_ht);
+      gl_context_ht = NULL;
+    }
+
+  G_UNLOCK (gl_context_ht);
+}
+
+static GdkGLContext *
+gdk_gl_context_lookup (EGLContext eglcontext)
+{
+  GdkGLContext *glcontext = NULL;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  G_LOCK (gl_context_ht);
+
+  if (gl_context_ht != NULL)
+    glcontext = g_hash_table_lookup (gl_context_ht, eglcontext);
+
+  G_UNLOCK (gl_context_ht);
+
+  return glcontext;
+}
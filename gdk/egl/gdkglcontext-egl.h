@@ -0,0 +1,109 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifndef __GDK_GL_CONTEXT_EGL_H__
+#define __GDK_GL_CONTEXT_EGL_H__
+
+#include <EGL/egl.h>
+
+#include <gdk/gdkglcontext.h>
+#include <gdk/gdkglcontextimpl.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkGLContextImplEGL      GdkGLContextImplEGL;
+typedef struct _GdkGLContextImplEGLClass GdkGLContextImplEGLClass;
+
+#define GDK_TYPE_GL_CONTEXT_IMPL_EGL            (gdk_gl_context_impl_egl_get_type ())
+#define GDK_GL_CONTEXT_IMPL_EGL(object)         (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_CONTEXT_IMPL_EGL, GdkGLContextImplEGL))
+#define GDK_GL_CONTEXT_IMPL_EGL_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_CONTEXT_IMPL_EGL, GdkGLContextImplEGLClass))
+#define GDK_IS_GL_CONTEXT_IMPL_EGL(object)      (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_CONTEXT_IMPL_EGL))
+#define GDK_IS_GL_CONTEXT_IMPL_EGL_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_CONTEXT_IMPL_EGL))
+#define GDK_GL_CONTEXT_IMPL_EGL_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_CONTEXT_IMPL_EGL, GdkGLContextImplEGLClass))
+
+struct _GdkGLContextImplEGL
+{
+  GdkGLContextImpl parent_instance;
+
+  EGLContext eglcontext;
+  GdkGLContext *share_list;
+  int render_type;
+
+  GdkGLConfig *glconfig;
+
+  GdkGLDrawable *gldrawable;
+  GdkGLDrawable *gldrawable_read;
+
+  /* creation parameters, reused for worker contexts */
+  int major_version;
+  int minor_version;
+  GdkGLContextProfile profile;
+  GdkGLContextFlags flags;
+
+  EGLSurface eglpbuffer;          /* hidden drawable of offscreen contexts */
+
+  guint is_destroyed   : 1;
+  guint is_no_error    : 1;
+  guint is_surfaceless : 1;       /* offscreen context bound to no surface */
+  guint is_share_list_weak : 1;   /* share_list is a weak pointer */
+};
+
+struct _GdkGLContextImplEGLClass
+{
+  GdkGLContextImplClass parent_class;
+
+  EGLContext (*get_eglcontext) (GdkGLContext *glcontext);
+};
+
+GType gdk_gl_context_impl_egl_get_type (void);
+
+GdkGLContextImpl *_gdk_egl_gl_context_impl_new_full (GdkGLContext        *glcontext,
+                                                     GdkGLDrawable       *gldrawable,
+                                                     GdkGLContext        *share_list,
+                                                     gboolean             direct,
+                                                     int                  render_type,
+                                                     int                  major_version,
+                                                     int                  minor_version,
+                                                     GdkGLContextProfile  profile,
+                                                     GdkGLContextFlags    flags);
+
+GdkGLContextImpl *_gdk_egl_gl_context_impl_new_offscreen (GdkGLContext        *glcontext,
+                                                          GdkGLConfig         *glconfig,
+                                                          GdkGLContext        *share_list,
+                                                          gboolean             direct,
+                                                          int                  render_type,
+                                                          int                  major_version,
+                                                          int                  minor_version,
+                                                          GdkGLContextProfile  profile,
+                                                          GdkGLContextFlags    flags);
+
+GdkGLContextImpl *_gdk_egl_gl_context_impl_new_worker (GdkGLContext *glcontext,
+                                                       GdkGLContext *share_list);
+
+void _gdk_egl_gl_context_impl_weaken_share_list (GdkGLContext *glcontext);
+
+void _gdk_egl_gl_context_impl_set_gl_drawable      (GdkGLContext  *glcontext,
+                                                    GdkGLDrawable *gldrawable);
+void _gdk_egl_gl_context_impl_set_gl_drawable_read (GdkGLContext  *glcontext,
+                                                    GdkGLDrawable *gldrawable);
+
+GdkGLContext *_gdk_egl_gl_context_impl_get_current (void);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_CONTEXT_EGL_H__ */
@@ -0,0 +1,38 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifndef __GDK_GL_PRIVATE_EGL_H__
+#define __GDK_GL_PRIVATE_EGL_H__
+
+#include <gdk/gdkprivate.h>
+
+#include <gdk/gdkglprivate.h>
+
+G_BEGIN_DECLS
+
+void _gdk_egl_gl_print_egl_info (EGLDisplay egldisplay);
+
+#define GDK_GL_CONTEXT_IS_DESTROYED(glcontext) \
+  ( ((GdkGLContextImplEGL *) (glcontext->impl))->is_destroyed )
+
+#define GDK_GL_WINDOW_IS_DESTROYED(glwindow) \
+  ( ((GdkGLWindowImplEGL *) (glwindow->impl))->is_destroyed )
+
+G_END_DECLS
+
+#endif /* __GDK_GL_PRIVATE_EGL_H__ */
@@ -0,0 +1,375 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <string.h>
+
+#include <gmodule.h>
+
+#include <gdk/gdk.h>
+#include <gdk/gdkx.h>
+
+#include "gdkglegl.h"
+#include "gdkglprivate-egl.h"
+#include "gdkglconfig-egl.h"
+#include "gdkglquery.h"
+
+#include "gdkglquery-egl.h"
+
+#ifndef EGL_PLATFORM_X11_KHR
+#define EGL_PLATFORM_X11_KHR            0x31D5
+#endif
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA   0x31DD
+#endif
+
+typedef EGLDisplay (*GdkGLEGLGetPlatformDisplayProc) (EGLenum       platform,
+                                                      void         *native_display,
+                                                      const EGLint *attrib_list);
+
+static const char quark_egl_display_string[] = "gdk-gl-egl-display";
+static GQuark quark_egl_display = 0;
+
+G_LOCK_DEFINE_STATIC (egl_display);
+
+/*
+ * This code is based on __glutIsSupportedByGLX().
+ */
+static gboolean
+gdk_egl_gl_extension_in_string (const char *extensions,
+                                const char *extension)
+{
+  const char *start;
+  const char *where, *terminator;
+
+  /* Extension names should not have spaces. */
+  where = strchr (extension, ' ');
+  if (where || *extension == '\0' || extensions == NULL)
+    return FALSE;
+
+  start = extensions;
+  for (;;)
+    {
+      where = strstr (start, extension);
+      if (where == NULL)
+        break;
+
+      terminator = where + strlen (extension);
+
+      if (where == start || *(where - 1) == ' ')
+        if (*terminator == ' ' || *terminator == '\0')
+          return TRUE;
+
+      start = terminator;
+    }
+
+  return FALSE;
+}
+
+/*
+ * Client extensions (EGL_EXT_client_extensions) describe the platforms
+ * that eglGetPlatformDisplayEXT() accepts. Without them, only the native
+ * display of the default platform can be used.
+ */
+static gboolean
+gdk_egl_gl_query_client_extension (const char *extension)
+{
+  static const char *extensions = NULL;
+  static gboolean done = FALSE;
+
+  if (!done)
+    {
+      extensions = eglQueryString (EGL_NO_DISPLAY, EGL_EXTENSIONS);
+      if (extensions == NULL)
+        eglGetError ();         /* clear EGL_BAD_DISPLAY */
+      done = TRUE;
+    }
+
+  return gdk_egl_gl_extension_in_string (extensions, extension);
+}
+
+static EGLDisplay
+gdk_egl_gl_get_platform_display (EGLenum  platform,
+                                 void    *native_display)
+{
+  GdkGLEGLGetPlatformDisplayProc get_platform_display;
+
+  if (!gdk_egl_gl_query_client_extension ("EGL_EXT_platform_base"))
+    return EGL_NO_DISPLAY;
+
+  get_platform_display =
+    (GdkGLEGLGetPlatformDisplayProc) eglGetProcAddress ("eglGetPlatformDisplayEXT");
+  if (get_platform_display == NULL)
+    return EGL_NO_DISPLAY;
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglGetPlatformDisplayEXT");
+
+  return get_platform_display (platform, native_display, NULL);
+}
+
+static EGLDisplay
+gdk_egl_gl_initialize (EGLDisplay egldisplay)
+{
+  EGLint major, minor;
+
+  if (egldisplay == EGL_NO_DISPLAY)
+    return EGL_NO_DISPLAY;
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglInitialize");
+
+  if (!eglInitialize (egldisplay, &major, &minor))
+    return EGL_NO_DISPLAY;
+
+  GDK_GL_NOTE (MISC, g_message (" -- EGL version %d.%d", major, minor));
+  GDK_GL_NOTE (MISC, _gdk_egl_gl_print_egl_info (egldisplay));
+
+  return egldisplay;
+}
+
+/*
+ * Returns TRUE if the EGL backend is in use. When the GLX backend is
+ * built as well, EGL has to be asked for with GDK_GL_EGL or --gdk-gl-egl.
+ */
+gboolean
+_gdk_egl_gl_is_enabled (void)
+{
+#ifdef GDKGLEXT_WINDOWING_X11
+  return _gdk_gl_use_egl;
+#else
+  return TRUE;
+#endif
+}
+
+/*
+ * Returns TRUE if the EGL backend renders to @display.
+ */
+gboolean
+_gdk_egl_gl_is_enabled_for_display (GdkDisplay *display)
+{
+  return _gdk_egl_gl_is_enabled () && GDK_IS_X11_DISPLAY (display);
+}
+
+/*
+ * Returns the initialized EGLDisplay for an X11 GDK display, or
+ * EGL_NO_DISPLAY. The EGLDisplay lives as long as the GdkDisplay; like
+ * the GLX backend, we never terminate the connection.
+ */
+EGLDisplay
+_gdk_egl_gl_get_egldisplay_for_display (GdkDisplay *display)
+{
+  EGLDisplay egldisplay;
+  Display *xdisplay;
+
+  g_return_val_if_fail (GDK_IS_X11_DISPLAY (display), EGL_NO_DISPLAY);
+
+  if (quark_egl_display == 0)
+    quark_egl_display = g_quark_from_static_string (quark_egl_display_string);
+
+  G_LOCK (egl_display);
+
+  egldisplay = g_object_get_qdata (G_OBJECT (display), quark_egl_display);
+  if (egldisplay == NULL)
+    {
+      xdisplay = GDK_DISPLAY_XDISPLAY (display);
+
+      if (gdk_egl_gl_query_client_extension ("EGL_KHR_platform_x11") ||
+          gdk_egl_gl_query_client_extension ("EGL_EXT_platform_x11"))
+        egldisplay = gdk_egl_gl_get_platform_display (EGL_PLATFORM_X11_KHR, xdisplay);
+
+      if (egldisplay == EGL_NO_DISPLAY)
+        {
+          GDK_GL_NOTE_FUNC_IMPL ("eglGetDisplay");
+
+          egldisplay = eglGetDisplay ((EGLNativeDisplayType) xdisplay);
+        }
+
+      egldisplay = gdk_egl_gl_initialize (egldisplay);
+
+      if (egldisplay != EGL_NO_DISPLAY)
+        g_object_set_qdata (G_OBJECT (display), quark_egl_display, egldisplay);
+    }
+
+  G_UNLOCK (egl_display);
+
+  return egldisplay;
+}
+
+/*
+ * Returns the initialized EGLDisplay of the Mesa surfaceless platform,
+ * which needs no window system at all, or EGL_NO_DISPLAY.
+ */
+EGLDisplay
+_gdk_egl_gl_get_surfaceless_egldisplay (void)
+{
+  static EGLDisplay egldisplay = EGL_NO_DISPLAY;
+  static gboolean done = FALSE;
+
+  G_LOCK (egl_display);
+
+  if (!done)
+    {
+      if (gdk_egl_gl_query_client_extension ("EGL_MESA_platform_surfaceless"))
+        egldisplay = gdk_egl_gl_get_platform_display (EGL_PLATFORM_SURFACELESS_MESA,
+                                                      EGL_DEFAULT_DISPLAY);
+      else
+        GDK_GL_NOTE (MISC, g_message (" -- EGL_MESA_platform_surfaceless not supported"));
+
+      egldisplay = gdk_egl_gl_initialize (egldisplay);
+      done = TRUE;
+    }
+
+  G_UNLOCK (egl_display);
+
+  return egldisplay;
+}
+
+gboolean
+_gdk_egl_gl_query_display_extension (EGLDisplay  egldisplay,
+                                     const char *extension)
+{
+  gboolean supp;
+
+  supp = gdk_egl_gl_extension_in_string (eglQueryString (egldisplay, EGL_EXTENSIONS),
+                                         extension);
+
+  GDK_GL_NOTE (MISC, g_message (" - %s - %s", extension,
+                                supp ? "supported" : "not supported"));
+
+  return supp;
+}
+
+gboolean
+_gdk_egl_gl_query_extension_for_display (GdkDisplay *display)
+{
+  g_return_val_if_fail (GDK_IS_DISPLAY (display), FALSE);
+
+  return _gdk_egl_gl_get_egldisplay_for_display (display) != EGL_NO_DISPLAY;
+}
+
+gboolean
+_gdk_egl_gl_query_version_for_display (GdkDisplay *display,
+                                       int        *major,
+                                       int        *minor)
+{
+  EGLDisplay egldisplay;
+
+  g_return_val_if_fail (GDK_IS_DISPLAY (display), FALSE);
+
+  egldisplay = _gdk_egl_gl_get_egldisplay_for_display (display);
+  if (egldisplay == EGL_NO_DISPLAY)
+    return FALSE;
+
+  /* initializing again is a no-op that reports the version */
+  return eglInitialize (egldisplay, major, minor);
+}
+
+/**
+ * gdk_egl_gl_query_egl_extension:
+ * @glconfig: a #GdkGLConfig.
+ * @extension: name of EGL extension.
+ *
+ * Determines whether a given EGL extension is supported by the EGL
+ * display of @glconfig.
+ *
+ * Return value: TRUE if the EGL extension is supported, FALSE if not
+ *               supported.
+ **/
+gboolean
+gdk_egl_gl_query_egl_extension (GdkGLConfig *glconfig,
+                                const char  *extension)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), FALSE);
+
+  return _gdk_egl_gl_query_display_extension (GDK_GL_CONFIG_EGLDISPLAY (glconfig),
+                                              extension);
+}
+
+GdkGLProc
+_gdk_egl_gl_get_proc_address (const char *proc_name)
+{
+  const char *module_name;
+  gchar *file_name;
+  GModule *module;
+  GdkGLProc proc_address = NULL;
+
+  GDK_GL_NOTE_FUNC ();
+
+  if (strncmp ("glu", proc_name, 3) != 0)
+    {
+      /* Try eglGetProcAddress () */
+
+      proc_address = (GdkGLProc) eglGetProcAddress (proc_name);
+      GDK_GL_NOTE (IMPL, g_message (" ** eglGetProcAddress () - %s",
+                                    proc_address ? "succeeded" : "failed"));
+      if (proc_address != NULL)
+        return proc_address;
+
+      /* Before EGL 1.5, core functions need not be returned */
+      module_name = "GL";
+    }
+  else
+    {
+      module_name = "GLU";
+    }
+
+  /* Try g_module_symbol () */
+
+  file_name = g_module_build_path (NULL, module_name);
+  GDK_GL_NOTE (MISC, g_message (" - Open %s", file_name));
+  module = g_module_open (file_name, G_MODULE_BIND_LAZY);
+
+  if (module != NULL)
+    {
+      g_module_symbol (module, proc_name, (gpointer) &proc_address);
+      GDK_GL_NOTE (MISC, g_message (" - g_module_symbol () - %s",
+                                    proc_address ? "succeeded" : "failed"));
+      g_module_close (module);
+    }
+  else
+    {
+      g_warning ("Cannot open %s", file_name);
+    }
+
+  g_free (file_name);
+
+  return proc_address;
+}
+
+/*< private >*/
+void
+_gdk_egl_gl_print_egl_info (EGLDisplay egldisplay)
+{
+  static gboolean done = FALSE;
+
+  if (!done)
+    {
+      g_message (" -- EGL_VENDOR         : %s",
+                 eglQueryString (egldisplay, EGL_VENDOR));
+      g_message (" -- EGL_VERSION        : %s",
+                 eglQueryString (egldisplay, EGL_VERSION));
+      g_message (" -- EGL_CLIENT_APIS    : %s",
+                 eglQueryString (egldisplay, EGL_CLIENT_APIS));
+      g_message (" -- EGL_EXTENSIONS     : %s",
+                 eglQueryString (egldisplay, EGL_EXTENSIONS));
+
+      done = TRUE;
+    }
+}
@@ -0,0 +1,460 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <gdk/gdkx.h>
+
+#include "gdkglegl.h"
+#include "gdkglprivate-egl.h"
+#include "gdkglconfig-egl.h"
+#include "gdkglcontext-egl.h"
+#include "gdkglwindow-egl.h"
+#include "gdkglquery-egl.h"
+
+#ifndef EGL_EXT_buffer_age
+#define EGL_BUFFER_AGE_EXT                        0x313D
+#endif
+
+typedef EGLBoolean (*GdkGLEGLSwapBuffersWithDamageProc) (EGLDisplay  dpy,
+                                                         EGLSurface  surface,
+                                                         EGLint     *rects,
+                                                         EGLint      n_rects);
+
+static GdkGLContext *_gdk_egl_gl_window_impl_create_gl_context  (GdkGLWindow  *glwindow,
+                                                                 GdkGLContext *share_list,
+                                                                 gboolean      direct,
+                                                                 int           render_type);
+static GdkGLContext *_gdk_egl_gl_window_impl_create_gl_context_full (GdkGLWindow         *glwindow,
+                                                                     GdkGLContext        *share_list,
+                                                                     gboolean             direct,
+                                                                     int                  render_type,
+                                                                     int                  major_version,
+                                                                     int                  minor_version,
+                                                                     GdkGLContextProfile  profile,
+                                                                     GdkGLContextFlags    flags);
+static gboolean     _gdk_egl_gl_window_impl_is_double_buffered  (GdkGLWindow  *glwindow);
+static void         _gdk_egl_gl_window_impl_swap_buffers        (GdkGLWindow  *glwindow);
+static void         _gdk_egl_gl_window_impl_wait_gl             (GdkGLWindow  *glwindow);
+static void         _gdk_egl_gl_window_impl_wait_gdk            (GdkGLWindow  *glwindow);
+static GdkGLConfig *_gdk_egl_gl_window_impl_get_gl_config       (GdkGLWindow  *glwindow);
+static gboolean     _gdk_egl_gl_window_impl_set_swap_interval   (GdkGLWindow  *glwindow,
+                                                                 int           interval);
+static int          _gdk_egl_gl_window_impl_get_swap_interval   (GdkGLWindow  *glwindow);
+static int          _gdk_egl_gl_window_impl_get_buffer_age      (GdkGLWindow  *glwindow);
+static void         _gdk_egl_gl_window_impl_swap_buffers_with_damage (GdkGLWindow          *glwindow,
+                                                                      const cairo_region_t *damage);
+static EGLSurface   _gdk_egl_gl_window_impl_get_eglsurface      (GdkGLWindow  *glwindow);
+
+G_DEFINE_TYPE (GdkGLWindowImplEGL,
+               gdk_gl_window_impl_egl,
+               GDK_TYPE_GL_WINDOW_IMPL);
+
+static void
+gdk_gl_window_impl_egl_init (GdkGLWindowImplEGL *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  self->eglsurface = EGL_NO_SURFACE;
+  self->glconfig = NULL;
+  self->swap_interval = 1;
+  self->is_destroyed = 0;
+}
+
+static void
+_gdk_egl_gl_window_impl_destroy (GdkGLWindow *glwindow)
+{
+  GdkGLWindowImplEGL *egl_impl = GDK_GL_WINDOW_IMPL_EGL (glwindow->impl);
+  EGLDisplay egldisplay;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (egl_impl->is_destroyed)
+    return;
+
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (egl_impl->glconfig);
+
+  eglBindAPI (EGL_OPENGL_API);
+
+  if (egl_impl->eglsurface == eglGetCurrentSurface (EGL_DRAW) ||
+      egl_impl->eglsurface == eglGetCurrentSurface (EGL_READ))
+    {
+      eglWaitClient ();
+
+      GDK_GL_NOTE_FUNC_IMPL ("eglMakeCurrent");
+      eglMakeCurrent (egldisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglDestroySurface");
+  eglDestroySurface (egldisplay, egl_impl->eglsurface);
+
+  egl_impl->eglsurface = EGL_NO_SURFACE;
+
+  egl_impl->is_destroyed = TRUE;
+}
+
+static void
+gdk_gl_window_impl_egl_finalize (GObject *object)
+{
+  GdkGLWindowImplEGL *impl = GDK_GL_WINDOW_IMPL_EGL (object);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  _gdk_egl_gl_window_impl_destroy (GDK_GL_WINDOW (object));
+
+  g_object_unref (G_OBJECT (impl->glconfig));
+
+  G_OBJECT_CLASS (gdk_gl_window_impl_egl_parent_class)->finalize (object);
+}
+
+static void
+gdk_gl_window_impl_egl_class_init (GdkGLWindowImplEGLClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  klass->get_eglsurface = _gdk_egl_gl_window_impl_get_eglsurface;
+
+  klass->parent_class.create_gl_context      = _gdk_egl_gl_window_impl_create_gl_context;
+  klass->parent_class.create_gl_context_full = _gdk_egl_gl_window_impl_create_gl_context_full;
+  klass->parent_class.is_double_buffered     = _gdk_egl_gl_window_impl_is_double_buffered;
+  klass->parent_class.swap_buffers           = _gdk_egl_gl_window_impl_swap_buffers;
+  klass->parent_class.wait_gl                = _gdk_egl_gl_window_impl_wait_gl;
+  klass->parent_class.wait_gdk               = _gdk_egl_gl_window_impl_wait_gdk;
+  klass->parent_class.get_gl_config          = _gdk_egl_gl_window_impl_get_gl_config;
+  klass->parent_class.destroy_gl_window_impl = _gdk_egl_gl_window_impl_destroy;
+  klass->parent_class.set_swap_interval      = _gdk_egl_gl_window_impl_set_swap_interval;
+  klass->parent_class.get_swap_interval      = _gdk_egl_gl_window_impl_get_swap_interval;
+  klass->parent_class.get_buffer_age         = _gdk_egl_gl_window_impl_get_buffer_age;
+  klass->parent_class.swap_buffers_with_damage = _gdk_egl_gl_window_impl_swap_buffers_with_damage;
+
+  object_class->finalize = gdk_gl_window_impl_egl_finalize;
+}
+
+/*
+ * attrib_list is currently unused. This must be set to NULL or empty
+ * (first attribute of None).
+ */
+GdkGLWindow *
+_gdk_egl_gl_window_impl_new (GdkGLWindow *glwindow,
+                             GdkGLConfig *glconfig,
+                             GdkWindow   *window,
+                             const int   *attrib_list)
+{
+  GdkGLWindowImplEGL *egl_impl;
+  EGLSurface eglsurface;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow), NULL);
+  g_return_val_if_fail (GDK_IS_EGL_GL_CONFIG (glconfig), NULL);
+  g_return_val_if_fail (GDK_IS_WINDOW (window), NULL);
+
+  /*
+   * Create the EGL window surface. For the X11 platform the native
+   * window is the XID itself.
+   */
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglCreateWindowSurface");
+
+  eglsurface = eglCreateWindowSurface (GDK_GL_CONFIG_EGLDISPLAY (glconfig),
+                                       GDK_GL_CONFIG_EGLCONFIG (glconfig),
+                                       (EGLNativeWindowType) GDK_WINDOW_XID (window),
+                                       NULL);
+  if (eglsurface == EGL_NO_SURFACE)
+    {
+      g_warning ("eglCreateWindowSurface() failed (0x%x)", eglGetError ());
+      return NULL;
+    }
+
+  /*
+   * Instantiate the GdkGLWindowImplEGL object.
+   */
+
+  egl_impl = g_object_new (GDK_TYPE_GL_WINDOW_IMPL_EGL, NULL);
+
+  egl_impl->eglsurface = eglsurface;
+  egl_impl->glconfig = glconfig;
+  g_object_ref (G_OBJECT (egl_impl->glconfig));
+
+  egl_impl->is_destroyed = FALSE;
+
+  glwindow->impl = GDK_GL_WINDOW_IMPL (egl_impl);
+  glwindow->window = window;
+  g_object_add_weak_pointer (G_OBJECT (glwindow->window),
+                             (gpointer *) &(glwindow->window));
+
+  return glwindow;
+}
+
+static GdkGLContext *
+_gdk_egl_gl_window_impl_create_gl_context (GdkGLWindow  *glwindow,
+                                           GdkGLContext *share_list,
+                                           gboolean      direct,
+                                           int           render_type)
+{
+  GdkGLContext *glcontext;
+  GdkGLContextImpl *impl;
+
+  glcontext = g_object_new (GDK_TYPE_EGL_GL_CONTEXT, NULL);
+
+  g_return_val_if_fail (glcontext != NULL, NULL);
+
+  impl = _gdk_egl_gl_context_impl_new_full (glcontext,
+                                            GDK_GL_DRAWABLE (glwindow),
+                                            share_list,
+                                            direct,
+                                            render_type,
+                                            0, 0,
+                                            GDK_GL_CONTEXT_PROFILE_DEFAULT,
+                                            0);
+  if (impl == NULL)
+    g_object_unref (glcontext);
+
+  g_return_val_if_fail (impl != NULL, NULL);
+
+  return glcontext;
+}
+
+static GdkGLContext *
+_gdk_egl_gl_window_impl_create_gl_context_full (GdkGLWindow         *glwindow,
+                                                GdkGLContext        *share_list,
+                                                gboolean             direct,
+                                                int                  render_type,
+                                                int                  major_version,
+                                                int                  minor_version,
+                                                GdkGLContextProfile  profile,
+                                                GdkGLContextFlags    flags)
+{
+  GdkGLContext *glcontext;
+  GdkGLContextImpl *impl;
+
+  glcontext = g_object_new (GDK_TYPE_EGL_GL_CONTEXT, NULL);
+
+  g_return_val_if_fail (glcontext != NULL, NULL);
+
+  impl = _gdk_egl_gl_context_impl_new_full (glcontext,
+                                            GDK_GL_DRAWABLE (glwindow),
+                                            share_list,
+                                            direct,
+                                            render_type,
+                                            major_version,
+                                            minor_version,
+                                            profile,
+                                            flags);
+  if (impl == NULL)
+    {
+      /* the requested version may simply be unsupported; not a bug */
+      g_object_unref (glcontext);
+      return NULL;
+    }
+
+  return glcontext;
+}
+
+static gboolean
+_gdk_egl_gl_window_impl_is_double_buffered (GdkGLWindow *glwindow)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow), FALSE);
+
+  return gdk_gl_config_is_double_buffered (GDK_GL_WINDOW_IMPL_EGL (glwindow->impl)->glconfig);
+}
+
+static void
+_gdk_egl_gl_window_impl_swap_buffers (GdkGLWindow *glwindow)
+{
+  GdkGLWindowImplEGL *egl_impl;
+
+  g_return_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow));
+
+  egl_impl = GDK_GL_WINDOW_IMPL_EGL (glwindow->impl);
+
+  if (egl_impl->eglsurface == EGL_NO_SURFACE)
+    return;
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglSwapBuffers");
+
+  eglSwapBuffers (GDK_GL_CONFIG_EGLDISPLAY (egl_impl->glconfig), egl_impl->eglsurface);
+}
+
+static void
+_gdk_egl_gl_window_impl_wait_gl (GdkGLWindow *glwindow)
+{
+  g_return_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow));
+
+  eglWaitClient ();
+}
+
+static void
+_gdk_egl_gl_window_impl_wait_gdk (GdkGLWindow *glwindow)
+{
+  g_return_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow));
+
+  eglWaitNative (EGL_CORE_NATIVE_ENGINE);
+}
+
+static GdkGLConfig *
+_gdk_egl_gl_window_impl_get_gl_config (GdkGLWindow *glwindow)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow), NULL);
+
+  return GDK_GL_WINDOW_IMPL_EGL (glwindow->impl)->glconfig;
+}
+
+/*
+ * eglSwapInterval() applies to the draw surface of the current context,
+ * and EGL has no adaptive vsync, so negative intervals use -interval.
+ */
+static gboolean
+_gdk_egl_gl_window_impl_set_swap_interval (GdkGLWindow *glwindow,
+                                           int          interval)
+{
+  GdkGLWindowImplEGL *egl_impl;
+  EGLDisplay egldisplay;
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow), FALSE);
+
+  egl_impl = GDK_GL_WINDOW_IMPL_EGL (glwindow->impl);
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (egl_impl->glconfig);
+
+  eglBindAPI (EGL_OPENGL_API);
+
+  if (egl_impl->eglsurface == EGL_NO_SURFACE ||
+      egl_impl->eglsurface != eglGetCurrentSurface (EGL_DRAW))
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- the window is not current, cannot set the swap interval"));
+      return FALSE;
+    }
+
+  interval = ABS (interval);
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglSwapInterval");
+
+  if (!eglSwapInterval (egldisplay, interval))
+    return FALSE;
+
+  egl_impl->swap_interval = interval;
+
+  return TRUE;
+}
+
+static int
+_gdk_egl_gl_window_impl_get_swap_interval (GdkGLWindow *glwindow)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow), 0);
+
+  return GDK_GL_WINDOW_IMPL_EGL (glwindow->impl)->swap_interval;
+}
+
+static int
+_gdk_egl_gl_window_impl_get_buffer_age (GdkGLWindow *glwindow)
+{
+  GdkGLWindowImplEGL *egl_impl;
+  EGLDisplay egldisplay;
+  EGLint age = 0;
+
+  g_return_val_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow), 0);
+
+  egl_impl = GDK_GL_WINDOW_IMPL_EGL (glwindow->impl);
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (egl_impl->glconfig);
+
+  eglBindAPI (EGL_OPENGL_API);
+
+  /* The age can only be queried for the current draw surface. */
+  if (egl_impl->eglsurface == EGL_NO_SURFACE ||
+      egl_impl->eglsurface != eglGetCurrentSurface (EGL_DRAW) ||
+      !_gdk_egl_gl_query_display_extension (egldisplay, "EGL_EXT_buffer_age"))
+    return 0;
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglQuerySurface");
+
+  if (!eglQuerySurface (egldisplay, egl_impl->eglsurface, EGL_BUFFER_AGE_EXT, &age))
+    return 0;
+
+  return age;
+}
+
+static void
+_gdk_egl_gl_window_impl_swap_buffers_with_damage (GdkGLWindow          *glwindow,
+                                                  const cairo_region_t *damage)
+{
+  GdkGLWindowImplEGL *egl_impl;
+  EGLDisplay egldisplay;
+  GdkGLEGLSwapBuffersWithDamageProc SwapBuffersWithDamage = NULL;
+  cairo_rectangle_int_t rect;
+  EGLint *rects;
+  int height;
+  int i, n_rects;
+
+  g_return_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow));
+
+  egl_impl = GDK_GL_WINDOW_IMPL_EGL (glwindow->impl);
+  egldisplay = GDK_GL_CONFIG_EGLDISPLAY (egl_impl->glconfig);
+
+  if (egl_impl->eglsurface == EGL_NO_SURFACE)
+    return;
+
+  if (glwindow->window != NULL)
+    {
+      if (_gdk_egl_gl_query_display_extension (egldisplay, "EGL_KHR_swap_buffers_with_damage"))
+        SwapBuffersWithDamage = (GdkGLEGLSwapBuffersWithDamageProc)
+          _gdk_egl_gl_get_proc_address ("eglSwapBuffersWithDamageKHR");
+      else if (_gdk_egl_gl_query_display_extension (egldisplay, "EGL_EXT_swap_buffers_with_damage"))
+        SwapBuffersWithDamage = (GdkGLEGLSwapBuffersWithDamageProc)
+          _gdk_egl_gl_get_proc_address ("eglSwapBuffersWithDamageEXT");
+    }
+
+  if (SwapBuffersWithDamage == NULL)
+    {
+      _gdk_egl_gl_window_impl_swap_buffers (glwindow);
+      return;
+    }
+
+  /* EGL rectangles have their origin at the bottom left. */
+  height = gdk_window_get_height (glwindow->window);
+
+  n_rects = cairo_region_num_rectangles (damage);
+  rects = g_new (EGLint, 4 * MAX (n_rects, 1));
+
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_region_get_rectangle (damage, i, &rect);
+      rects[4 * i + 0] = rect.x;
+      rects[4 * i + 1] = height - rect.y - rect.height;
+      rects[4 * i + 2] = rect.width;
+      rects[4 * i + 3] = rect.height;
+    }
+
+  GDK_GL_NOTE_FUNC_IMPL ("eglSwapBuffersWithDamage");
+
+  SwapBuffersWithDamage (egldisplay, egl_impl->eglsurface, rects, n_rects);
+
+  g_free (rects);
+}
+
+static EGLSurface
+_gdk_egl_gl_window_impl_get_eglsurface (GdkGLWindow *glwindow)
+{
+  g_return_val_if_fail (GDK_IS_EGL_GL_WINDOW (glwindow), EGL_NO_SURFACE);
+
+  return GDK_GL_WINDOW_IMPL_EGL (glwindow->impl)->eglsurface;
+}
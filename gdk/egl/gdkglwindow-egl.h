@@ -0,0 +1,69 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifndef __GDK_GL_WINDOW_EGL_H__
+#define __GDK_GL_WINDOW_EGL_H__
+
+#include <EGL/egl.h>
+
+#include <gdk/gdkglwindow.h>
+#include <gdk/gdkglwindowimpl.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkGLWindowImplEGL      GdkGLWindowImplEGL;
+typedef struct _GdkGLWindowImplEGLClass GdkGLWindowImplEGLClass;
+
+#define GDK_TYPE_GL_WINDOW_IMPL_EGL              (gdk_gl_window_impl_egl_get_type ())
+#define GDK_GL_WINDOW_IMPL_EGL(object)           (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_WINDOW_IMPL_EGL, GdkGLWindowImplEGL))
+#define GDK_GL_WINDOW_IMPL_EGL_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_WINDOW_IMPL_EGL, GdkGLWindowImplEGLClass))
+#define GDK_IS_GL_WINDOW_IMPL_EGL(object)        (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_WINDOW_IMPL_EGL))
+#define GDK_IS_GL_WINDOW_IMPL_EGL_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_WINDOW_IMPL_EGL))
+#define GDK_GL_WINDOW_IMPL_EGL_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_WINDOW_IMPL_EGL, GdkGLWindowImplEGLClass))
+
+struct _GdkGLWindowImplEGL
+{
+  GdkGLWindowImpl parent_instance;
+
+  EGLSurface eglsurface;
+
+  GdkGLConfig *glconfig;
+
+  int swap_interval;
+
+  guint is_destroyed : 1;
+};
+
+struct _GdkGLWindowImplEGLClass
+{
+  GdkGLWindowImplClass parent_class;
+
+  EGLSurface (*get_eglsurface) (GdkGLWindow *glwindow);
+};
+
+GType gdk_gl_window_impl_egl_get_type (void);
+
+GdkGLWindow *
+_gdk_egl_gl_window_impl_new (GdkGLWindow *glwindow,
+                             GdkGLConfig *glconfig,
+                             GdkWindow   *window,
+                             const int   *attrib_list);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_WINDOW_EGL_H__ */
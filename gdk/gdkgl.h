@@ -34,6 +34,10 @@
 #include "gdkglcontext.h"
 #include "gdkgldrawable.h"
 #include "gdkglwindow.h"
+#include "gdkglpbuffer.h"
+#include "gdkglframebuffer.h"
+#include "gdkglfence.h"
+#include "gdkglworker.h"
 
 #undef __GDKGL_H_INSIDE__
 
@@ -20,11 +20,18 @@
 #include "config.h"
 #endif /* HAVE_CONFIG_H */
 
+#include <stdlib.h>
+
 #include "gdkglprivate.h"
 #include "gdkglconfig.h"
 
 #include <gdk/gdk.h>
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+#include "egl/gdkeglglconfig.h"
+#include "egl/gdkglconfig-egl.h"
+#include "egl/gdkglquery-egl.h"
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
 #include "x11/gdkx11glconfig.h"
 #include "x11/gdkglconfig-x11.h"
@@ -34,6 +41,9 @@
 #include "win32/gdkglconfig-win32.h"
 #endif
 
+gboolean _gdk_gl_config_no_disk_cache = FALSE;
+gboolean _gdk_gl_use_egl = FALSE;
+
 G_DEFINE_TYPE (GdkGLConfig,     \
                gdk_gl_config,   \
                G_TYPE_OBJECT)
@@ -50,9 +60,307 @@ gdk_gl_config_class_init (GdkGLConfigClass *klass)
   GDK_GL_NOTE_FUNC_PRIVATE ();
 }
 
+static GdkGLConfig *
+gdk_gl_config_new_for_screen_common (GdkScreen *screen,
+                                     const int *attrib_list,
+                                     gsize      n_attribs)
+{
+  GdkDisplay *display;
+  GdkGLConfig *glconfig = NULL;
+
+  /* The linker returns undefined symbol '_gdk_win32_screen_get_type'
+   * for win32 builds when using GDK_IS_WIN32_SCREEN. Thus we lookup
+   * the screen's display and test the display instead.
+   */
+
+  display = gdk_screen_get_display(screen);
+  g_return_val_if_fail(display != NULL, NULL);
+
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (_gdk_egl_gl_is_enabled_for_display(display))
+    {
+      glconfig = gdk_egl_gl_config_new_for_screen(screen,
+                                                  attrib_list,
+                                                  n_attribs);
+    }
+  else
+#endif
+#ifdef GDKGLEXT_WINDOWING_X11
+  if (GDK_IS_X11_DISPLAY(display))
+    {
+      glconfig = gdk_x11_gl_config_new_for_screen(screen,
+                                                  attrib_list,
+                                                  n_attribs);
+    }
+  else
+#endif
+#ifdef GDKGLEXT_WINDOWING_WIN32
+  if (GDK_IS_WIN32_DISPLAY(display))
+    {
+      glconfig = gdk_win32_gl_config_new_for_screen(screen,
+                                                    attrib_list,
+                                                    n_attribs);
+    }
+  else
+#endif
+    {
+      g_warning("Unsupported GDK backend");
+    }
+
+  return glconfig;
+}
+
+/*
+ * Resolved configs are cached per screen, keyed by a canonical form of
+ * the attribute list, so that creating many GL widgets with the same
+ * mode runs the visual selection only once. Failed selections are cached
+ * too, as GDK_GL_CONFIG_CACHE_FAILED, so that the fallback ladders of
+ * gdk_gl_config_new_by_mode() do not repeat the failing selections. The
+ * table is dropped when compositing changes or the display is closed,
+ * which is when the available configs can change. Cached configs are
+ * shared and must not be modified.
+ *
+ * The lock only guards the tables; the backend selection, which may
+ * talk to the server, runs unlocked. Two threads missing on the same
+ * key may both select a config; the first one inserted wins.
+ */
+
+static const gchar quark_gl_config_cache_string[] = "gdk-gl-config-cache";
+static GQuark quark_gl_config_cache = 0;
+
+G_LOCK_DEFINE_STATIC (gl_config_cache);
+
+/* cached in place of a config when no config matches */
+static gchar gl_config_cache_failed;
+#define GDK_GL_CONFIG_CACHE_FAILED ((gpointer) &gl_config_cache_failed)
+
+static void
+gdk_gl_config_cache_value_free (gpointer data)
+{
+  if (data != GDK_GL_CONFIG_CACHE_FAILED)
+    g_object_unref (data);
+}
+
+static void
+gdk_gl_config_cache_clear (GdkScreen *screen)
+{
+  GHashTable *cache;
+
+  GDK_GL_NOTE (MISC, g_message (" -- config cache cleared"));
+
+  G_LOCK (gl_config_cache);
+  cache = g_object_get_qdata (G_OBJECT (screen), quark_gl_config_cache);
+  if (cache != NULL)
+    g_hash_table_remove_all (cache);
+  G_UNLOCK (gl_config_cache);
+}
+
+typedef struct
+{
+  int attrib;
+  int value;
+} GdkGLConfigAttribPair;
+
+static gboolean
+gdk_gl_config_attrib_has_value (int attrib)
+{
+  switch (attrib)
+    {
+      case GDK_GL_USE_GL:
+      case GDK_GL_RGBA:
+      case GDK_GL_DOUBLEBUFFER:
+      case GDK_GL_STEREO:
+        return FALSE;
+      default:
+        return TRUE;
+    }
+}
+
+static int
+gdk_gl_config_attrib_pair_compare (const void *a,
+                                   const void *b)
+{
+  const GdkGLConfigAttribPair *pa = a;
+  const GdkGLConfigAttribPair *pb = b;
+
+  return (pa->attrib > pb->attrib) - (pa->attrib < pb->attrib);
+}
+
+/*
+ * Parses attrib_list into attribute/value pairs sorted by attribute.
+ * Later occurrences override earlier ones; boolean attributes get the
+ * value 1. Returns NULL if the list is malformed.
+ */
+static GdkGLConfigAttribPair *
+gdk_gl_config_parse_attrib_list (const int *attrib_list,
+                                 gsize      n_attribs,
+                                 gsize     *n_pairs_ret)
+{
+  GdkGLConfigAttribPair *pairs;
+  gsize n_pairs = 0;
+  gsize i, j;
+
+  pairs = g_new (GdkGLConfigAttribPair, n_attribs + 1);
+
+  for (i = 0; (i < n_attribs) && (attrib_list[i] != GDK_GL_ATTRIB_LIST_NONE); ++i)
+    {
+      int attrib = attrib_list[i];
+      int value = 1;
+
+      if (gdk_gl_config_attrib_has_value (attrib))
+        {
+          if (++i == n_attribs)
+            {
+              g_free (pairs);
+              return NULL;
+            }
+          value = attrib_list[i];
+        }
+
+      for (j = 0; (j < n_pairs) && (pairs[j].attrib != attrib); ++j)
+        ;
+
+      pairs[j].attrib = attrib;
+      pairs[j].value = value;
+
+      if (j == n_pairs)
+        ++n_pairs;
+    }
+
+  qsort (pairs, n_pairs, sizeof (*pairs), gdk_gl_config_attrib_pair_compare);
+
+  *n_pairs_ret = n_pairs;
+
+  return pairs;
+}
+
+/*
+ * Returns the cache key for an attribute list, or NULL if the list is
+ * malformed. Equivalent lists map to the same key.
+ */
+static gchar *
+gdk_gl_config_cache_key (const int *attrib_list,
+                         gsize      n_attribs,
+                         gboolean   as_single)
+{
+  GdkGLConfigAttribPair *pairs;
+  gsize n_pairs;
+  gsize i;
+  GString *key;
+
+  pairs = gdk_gl_config_parse_attrib_list (attrib_list, n_attribs, &n_pairs);
+  if (pairs == NULL)
+    return NULL;
+
+  key = g_string_new (as_single ? "s" : "d");
+
+  for (i = 0; i < n_pairs; ++i)
+    g_string_append_printf (key, ":%x=%x", pairs[i].attrib, pairs[i].value);
+
+  g_free (pairs);
+
+  return g_string_free (key, FALSE);
+}
+
+/*
+ * Returns a new reference to a config matching attrib_list, creating it
+ * on the first request. If as_single is TRUE, the config is a double
+ * buffered config used in single buffered mode; it is cached separately
+ * from the plain double buffered one.
+ */
+static GdkGLConfig *
+gdk_gl_config_new_for_screen_cached (GdkScreen *screen,
+                                     const int *attrib_list,
+                                     gsize      n_attribs,
+                                     gboolean   as_single)
+{
+  GdkGLConfig *glconfig;
+  GdkGLConfig *cached;
+  GHashTable *cache;
+  gchar *key;
+
+  g_return_val_if_fail (GDK_IS_SCREEN (screen), NULL);
+  g_return_val_if_fail (attrib_list != NULL, NULL);
+
+  key = gdk_gl_config_cache_key (attrib_list, n_attribs, as_single);
+
+  if (key == NULL)
+    {
+      /* malformed list; let the backend report it */
+      glconfig = gdk_gl_config_new_for_screen_common (screen, attrib_list, n_attribs);
+      if (glconfig != NULL && as_single)
+        glconfig->impl->as_single_mode = TRUE;
+      return glconfig;
+    }
+
+  if (quark_gl_config_cache == 0)
+    quark_gl_config_cache = g_quark_from_static_string (quark_gl_config_cache_string);
+
+  G_LOCK (gl_config_cache);
+
+  cache = g_object_get_qdata (G_OBJECT (screen), quark_gl_config_cache);
+  if (cache == NULL)
+    {
+      cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                     g_free, gdk_gl_config_cache_value_free);
+      g_object_set_qdata_full (G_OBJECT (screen), quark_gl_config_cache, cache,
+                               (GDestroyNotify) g_hash_table_destroy);
+
+      g_signal_connect (screen, "composited-changed",
+                        G_CALLBACK (gdk_gl_config_cache_clear), NULL);
+      g_signal_connect_object (gdk_screen_get_display (screen), "closed",
+                               G_CALLBACK (gdk_gl_config_cache_clear), screen,
+                               G_CONNECT_SWAPPED);
+    }
+
+  cached = g_hash_table_lookup (cache, key);
+  if (cached != NULL && cached != GDK_GL_CONFIG_CACHE_FAILED)
+    g_object_ref (cached);
+
+  G_UNLOCK (gl_config_cache);
+
+  if (cached != NULL)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- config cache hit: %s", key));
+      g_free (key);
+      return (cached != GDK_GL_CONFIG_CACHE_FAILED) ? cached : NULL;
+    }
+
+  GDK_GL_NOTE (MISC, g_message (" -- config cache miss: %s", key));
+
+  glconfig = gdk_gl_config_new_for_screen_common (screen, attrib_list, n_attribs);
+
+  /* set before the config becomes visible to other callers */
+  if (glconfig != NULL && as_single)
+    glconfig->impl->as_single_mode = TRUE;
+
+  G_LOCK (gl_config_cache);
+
+  cached = g_hash_table_lookup (cache, key);
+  if (cached != NULL)
+    {
+      /* another thread got there first; share its result */
+      if (glconfig != NULL)
+        g_object_unref (glconfig);
+      glconfig = (cached != GDK_GL_CONFIG_CACHE_FAILED) ? g_object_ref (cached) : NULL;
+      g_free (key);
+    }
+  else
+    {
+      g_hash_table_insert (cache, key,
+                           (glconfig != NULL) ? g_object_ref (glconfig)
+                                              : GDK_GL_CONFIG_CACHE_FAILED);
+    }
+
+  G_UNLOCK (gl_config_cache);
+
+  return glconfig;
+}
+
 static GdkGLConfig *
 gdk_gl_config_new_ci (GdkScreen       *screen,
-                      GdkGLConfigMode  mode)
+                      GdkGLConfigMode  mode,
+                      gboolean         as_single)
 {
   GdkGLConfig *glconfig = NULL;
   static const int buf_size_list[] = { 16, 12, 8, 4, 2, 1, 0 };
@@ -95,7 +403,7 @@ gdk_gl_config_new_ci (GdkScreen       *screen,
       /* XXX Assumes list[1] is where GDK_GL_BUFFER_SIZE parameter is. */
       list[1] = buf_size_list[i];
 
-      glconfig = gdk_gl_config_new_for_screen (screen, list, n);
+      glconfig = gdk_gl_config_new_for_screen_cached (screen, list, n, as_single);
 
       if (glconfig != NULL)
         return glconfig;
@@ -106,10 +414,14 @@ gdk_gl_config_new_ci (GdkScreen       *screen,
 
 static GdkGLConfig *
 gdk_gl_config_new_rgb (GdkScreen       *screen,
-                       GdkGLConfigMode  mode)
+                       GdkGLConfigMode  mode,
+                       gboolean         as_single)
 {
+  GdkGLConfig *glconfig;
+  static const int samples_list[] = { 16, 8, 4, 2, 0 };
   int list[32];
   int n = 0;
+  int i;
 
   list[n++] = GDK_GL_RGBA;
   list[n++] = GDK_GL_RED_SIZE;
@@ -155,8 +467,32 @@ gdk_gl_config_new_rgb (GdkScreen       *screen,
           list[n++] = 1;
         }
     }
+  if (mode & GDK_GL_MODE_MULTISAMPLE)
+    {
+      list[n++] = GDK_GL_SAMPLE_BUFFERS;
+      list[n++] = 1;
+      list[n++] = GDK_GL_SAMPLES;
+      list[n++] = 1;
+
+      /* Not every implementation offers the same sample counts. Start
+         with the highest one and step down until a matching config
+         exists; finally, fall back to no multisampling at all. */
+
+      for (i = 0; samples_list[i]; i++)
+        {
+          /* XXX Assumes list[n - 1] is where GDK_GL_SAMPLES parameter is. */
+          list[n - 1] = samples_list[i];
 
-  return gdk_gl_config_new_for_screen (screen, list, n);
+          glconfig = gdk_gl_config_new_for_screen_cached (screen, list, n, as_single);
+
+          if (glconfig != NULL)
+            return glconfig;
+        }
+
+      n -= 4;
+    }
+
+  return gdk_gl_config_new_for_screen_cached (screen, list, n, as_single);
 }
 
 static GdkGLConfig *
@@ -165,12 +501,12 @@ gdk_gl_config_new_by_mode_common (GdkScreen       *screen,
 {
   GdkGLConfig *glconfig;
 
-#define _GL_CONFIG_NEW_BY_MODE(__screen, __mode)        \
-  ( ((__mode) & GDK_GL_MODE_INDEX) ?                    \
-    gdk_gl_config_new_ci (__screen, __mode) :           \
-    gdk_gl_config_new_rgb (__screen, __mode) )
+#define _GL_CONFIG_NEW_BY_MODE(__screen, __mode, __as_single)    \
+  ( ((__mode) & GDK_GL_MODE_INDEX) ?                            \
+    gdk_gl_config_new_ci (__screen, __mode, __as_single) :      \
+    gdk_gl_config_new_rgb (__screen, __mode, __as_single) )
 
-  glconfig = _GL_CONFIG_NEW_BY_MODE (screen, mode);
+  glconfig = _GL_CONFIG_NEW_BY_MODE (screen, mode, FALSE);
   if (glconfig == NULL)
     {
       /* Fallback cases when can't get exactly what was asked for... */
@@ -182,9 +518,7 @@ gdk_gl_config_new_by_mode_common (GdkScreen       *screen,
              the draw buffer to GL_FRONT and treating any swap
              buffers as no-ops. */
           mode |= GDK_GL_MODE_DOUBLE;
-          glconfig = _GL_CONFIG_NEW_BY_MODE (screen, mode);
-          if (glconfig != NULL)
-            glconfig->impl->as_single_mode = TRUE;
+          glconfig = _GL_CONFIG_NEW_BY_MODE (screen, mode, TRUE);
         }
     }
 
@@ -198,7 +532,8 @@ gdk_gl_config_new_by_mode_common (GdkScreen       *screen,
  * @mode: display mode bit mask.
  *
  * Returns an OpenGL frame buffer configuration that match the specified
- * display mode.
+ * display mode. Configurations are cached per screen; requesting the same
+ * mode again returns a new reference to the same #GdkGLConfig.
  *
  * Return value: the new #GdkGLConfig.
  **/
@@ -218,7 +553,8 @@ gdk_gl_config_new_by_mode (GdkGLConfigMode mode)
  * @mode: display mode bit mask.
  *
  * Returns an OpenGL frame buffer configuration that match the specified
- * display mode.
+ * display mode. Configurations are cached per screen; requesting the same
+ * mode again returns a new reference to the same #GdkGLConfig.
  *
  * Return value: the new #GdkGLConfig.
  **/
@@ -410,7 +746,8 @@ gdk_gl_config_has_accum_buffer (GdkGLConfig *glconfig)
  * GDK_GL_DOUBLEBUFFER, GDK_GL_STEREO, GDK_GL_AUX_BUFFERS,
  * GDK_GL_RED_SIZE, GDK_GL_GREEN_SIZE, GDK_GL_BLUE_SIZE, GDK_GL_ALPHA_SIZE,
  * GDK_GL_DEPTH_SIZE, GDK_GL_STENCIL_SIZE, GDK_GL_ACCUM_RED_SIZE,
- * GDK_GL_ACCUM_GREEN_SIZE, GDK_GL_ACCUM_BLUE_SIZE, GDK_GL_ACCUM_ALPHA_SIZE.
+ * GDK_GL_ACCUM_GREEN_SIZE, GDK_GL_ACCUM_BLUE_SIZE, GDK_GL_ACCUM_ALPHA_SIZE,
+ * GDK_GL_SAMPLE_BUFFERS, GDK_GL_SAMPLES.
  *
  * Return value: the new #GdkGLConfig.
  **/
@@ -437,7 +774,8 @@ gdk_gl_config_new (const int *attrib_list, gsize n_attribs)
  * GDK_GL_DOUBLEBUFFER, GDK_GL_STEREO, GDK_GL_AUX_BUFFERS,
  * GDK_GL_RED_SIZE, GDK_GL_GREEN_SIZE, GDK_GL_BLUE_SIZE, GDK_GL_ALPHA_SIZE,
  * GDK_GL_DEPTH_SIZE, GDK_GL_STENCIL_SIZE, GDK_GL_ACCUM_RED_SIZE,
- * GDK_GL_ACCUM_GREEN_SIZE, GDK_GL_ACCUM_BLUE_SIZE, GDK_GL_ACCUM_ALPHA_SIZE.
+ * GDK_GL_ACCUM_GREEN_SIZE, GDK_GL_ACCUM_BLUE_SIZE, GDK_GL_ACCUM_ALPHA_SIZE,
+ * GDK_GL_SAMPLE_BUFFERS, GDK_GL_SAMPLES.
  *
  * Return value: the new #GdkGLConfig.
  **/
@@ -448,6 +786,15 @@ gdk_gl_config_new_for_display (GdkDisplay *display,
 {
   GdkGLConfig *glconfig = NULL;
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (_gdk_egl_gl_is_enabled_for_display(display))
+    {
+      glconfig = gdk_egl_gl_config_new_for_display(display,
+                                                   attrib_list,
+                                                   n_attribs);
+    }
+  else
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
   if (GDK_IS_X11_DISPLAY(display))
     {
@@ -488,7 +835,8 @@ gdk_gl_config_new_for_display (GdkDisplay *display,
  * GDK_GL_DOUBLEBUFFER, GDK_GL_STEREO, GDK_GL_AUX_BUFFERS,
  * GDK_GL_RED_SIZE, GDK_GL_GREEN_SIZE, GDK_GL_BLUE_SIZE, GDK_GL_ALPHA_SIZE,
  * GDK_GL_DEPTH_SIZE, GDK_GL_STENCIL_SIZE, GDK_GL_ACCUM_RED_SIZE,
- * GDK_GL_ACCUM_GREEN_SIZE, GDK_GL_ACCUM_BLUE_SIZE, GDK_GL_ACCUM_ALPHA_SIZE.
+ * GDK_GL_ACCUM_GREEN_SIZE, GDK_GL_ACCUM_BLUE_SIZE, GDK_GL_ACCUM_ALPHA_SIZE,
+ * GDK_GL_SAMPLE_BUFFERS, GDK_GL_SAMPLES.
  *
  * Return value: the new #GdkGLConfig.
  **/
@@ -497,32 +845,68 @@ gdk_gl_config_new_for_screen (GdkScreen *screen,
                               const int *attrib_list,
                               gsize n_attribs)
 {
-  GdkDisplay *display;
-  GdkGLConfig *glconfig = NULL;
+  return gdk_gl_config_new_for_screen_common (screen, attrib_list, n_attribs);
+}
 
-  /* The linker returns undefined symbol '_gdk_win32_screen_get_type'
-   * for win32 builds when using GDK_IS_WIN32_SCREEN. Thus we lookup
-   * the screen's display and test the display instead.
-   */
+/**
+ * gdk_gl_config_get_for_screen:
+ * @screen: target screen.
+ * @attrib_list: (array length=n_attribs): a list of attribute/value pairs.
+ * @n_attribs: the number of attributes and values in attrib_list.
+ *
+ * Like gdk_gl_config_new_for_screen(), but configurations are cached per
+ * screen: requesting an equivalent attribute list again returns a new
+ * reference to the same #GdkGLConfig, which must therefore be treated as
+ * immutable. A list that matches no configuration is remembered as well,
+ * until compositing changes or the display is closed.
+ * gdk_gl_config_new_by_mode() uses the same cache.
+ *
+ * Return value: (transfer full): the shared #GdkGLConfig, or NULL if no
+ *               configuration matches.
+ **/
+GdkGLConfig *
+gdk_gl_config_get_for_screen (GdkScreen *screen,
+                              const int *attrib_list,
+                              gsize      n_attribs)
+{
+  return gdk_gl_config_new_for_screen_cached (screen, attrib_list, n_attribs, FALSE);
+}
 
-  display = gdk_screen_get_display(screen);
-  g_return_val_if_fail(display != NULL, NULL);
+static const gchar quark_gl_config_list_string[] = "gdk-gl-config-list";
+static GQuark quark_gl_config_list = 0;
 
+static void
+gdk_gl_config_list_free (gpointer data)
+{
+  g_list_free_full (data, g_object_unref);
+}
+
+static GList *
+gdk_gl_config_list_for_screen_common (GdkScreen *screen)
+{
+  GList *list = NULL;
+  GdkDisplay *display;
+
+  display = gdk_screen_get_display (screen);
+
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (_gdk_egl_gl_is_enabled_for_display(display))
+    {
+      list = _gdk_egl_gl_config_impl_list_for_screen(screen);
+    }
+  else
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
   if (GDK_IS_X11_DISPLAY(display))
     {
-      glconfig = gdk_x11_gl_config_new_for_screen(screen,
-                                                  attrib_list,
-                                                  n_attribs);
+      list = _gdk_x11_gl_config_impl_list_for_screen(screen);
     }
   else
 #endif
 #ifdef GDKGLEXT_WINDOWING_WIN32
   if (GDK_IS_WIN32_DISPLAY(display))
     {
-      glconfig = gdk_win32_gl_config_new_for_screen(screen,
-                                                    attrib_list,
-                                                    n_attribs);
+      list = _gdk_win32_gl_config_impl_list_for_screen(screen);
     }
   else
 #endif
@@ -530,6 +914,357 @@ gdk_gl_config_new_for_screen (GdkScreen *screen,
       g_warning("Unsupported GDK backend");
     }
 
+  return list;
+}
+
+/**
+ * gdk_gl_config_list_for_screen:
+ * @screen: target screen.
+ *
+ * Returns the OpenGL frame buffer configurations of @screen that can be
+ * used for GL widgets and windows: those that support RGBA rendering to
+ * windows and have a visual. Color index configurations, and
+ * configurations usable only for pbuffers or pixmaps, are left out, since
+ * a #GdkGLConfig is created from a visual.
+ *
+ * The list is built once per screen, with the attributes of each
+ * configuration read at that time; later calls return the same
+ * configurations, which must therefore be treated as immutable.
+ *
+ * Return value: (element-type GdkGLConfig) (transfer full): a new list of
+ *               references to the configurations, or NULL. Free it with
+ *               g_list_free_full() and g_object_unref().
+ **/
+GList *
+gdk_gl_config_list_for_screen (GdkScreen *screen)
+{
+  GList *list;
+  GList *cached;
+
+  g_return_val_if_fail (GDK_IS_SCREEN (screen), NULL);
+
+  if (quark_gl_config_list == 0)
+    quark_gl_config_list = g_quark_from_static_string (quark_gl_config_list_string);
+
+  G_LOCK (gl_config_cache);
+  list = g_object_get_qdata (G_OBJECT (screen), quark_gl_config_list);
+  list = g_list_copy_deep (list, (GCopyFunc) g_object_ref, NULL);
+  G_UNLOCK (gl_config_cache);
+
+  if (list != NULL)
+    return list;
+
+  /* Enumerate without the lock held, like the config cache does. */
+  list = gdk_gl_config_list_for_screen_common (screen);
+  if (list == NULL)
+    return NULL;
+
+  G_LOCK (gl_config_cache);
+
+  cached = g_object_get_qdata (G_OBJECT (screen), quark_gl_config_list);
+  if (cached != NULL)
+    {
+      gdk_gl_config_list_free (list);
+      list = cached;
+    }
+  else
+    {
+      g_object_set_qdata_full (G_OBJECT (screen), quark_gl_config_list,
+                               list, gdk_gl_config_list_free);
+    }
+
+  list = g_list_copy_deep (list, (GCopyFunc) g_object_ref, NULL);
+
+  G_UNLOCK (gl_config_cache);
+
+  return list;
+}
+
+static int
+gdk_gl_config_attrib_pairs_lookup (const GdkGLConfigAttribPair *pairs,
+                                   gsize                        n_pairs,
+                                   int                          attrib,
+                                   int                          default_value)
+{
+  gsize i;
+
+  for (i = 0; i < n_pairs; ++i)
+    {
+      if (pairs[i].attrib == attrib)
+        return pairs[i].value;
+    }
+
+  return default_value;
+}
+
+static int
+gdk_gl_config_get_attrib_or (GdkGLConfig *glconfig,
+                             int          attrib,
+                             int          default_value)
+{
+  int value;
+
+  if (!gdk_gl_config_get_attrib (glconfig, attrib, &value))
+    return default_value;
+
+  return value;
+}
+
+/*
+ * Returns TRUE if glconfig satisfies every requested attribute. Size
+ * attributes are minimums, bit masks must be contained, everything else
+ * must match exactly unless GDK_GL_DONT_CARE was requested.
+ */
+static gboolean
+gdk_gl_config_matches (GdkGLConfig                 *glconfig,
+                       const GdkGLConfigAttribPair *pairs,
+                       gsize                        n_pairs)
+{
+  gsize i;
+
+  /* these default to FALSE and 0, and are never "at least" */
+  if (gdk_gl_config_is_double_buffered (glconfig) !=
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_DOUBLEBUFFER, FALSE))
+    return FALSE;
+  if (gdk_gl_config_is_stereo (glconfig) !=
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_STEREO, FALSE))
+    return FALSE;
+  if (gdk_gl_config_get_layer_plane (glconfig) !=
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_LEVEL, 0))
+    return FALSE;
+
+  for (i = 0; i < n_pairs; ++i)
+    {
+      int wanted = pairs[i].value;
+      int value;
+
+      switch (pairs[i].attrib)
+        {
+        case GDK_GL_USE_GL:
+        case GDK_GL_RGBA:
+        case GDK_GL_DOUBLEBUFFER:
+        case GDK_GL_STEREO:
+        case GDK_GL_LEVEL:
+        case GDK_GL_SCREEN:
+          /* checked above, or implied by the config list */
+          break;
+
+        case GDK_GL_BUFFER_SIZE:
+        case GDK_GL_AUX_BUFFERS:
+        case GDK_GL_RED_SIZE:
+        case GDK_GL_GREEN_SIZE:
+        case GDK_GL_BLUE_SIZE:
+        case GDK_GL_ALPHA_SIZE:
+        case GDK_GL_DEPTH_SIZE:
+        case GDK_GL_STENCIL_SIZE:
+        case GDK_GL_ACCUM_RED_SIZE:
+        case GDK_GL_ACCUM_GREEN_SIZE:
+        case GDK_GL_ACCUM_BLUE_SIZE:
+        case GDK_GL_ACCUM_ALPHA_SIZE:
+        case GDK_GL_SAMPLE_BUFFERS:
+        case GDK_GL_SAMPLES:
+          if (gdk_gl_config_get_attrib_or (glconfig, pairs[i].attrib, 0) < wanted)
+            return FALSE;
+          break;
+
+        case GDK_GL_DRAWABLE_TYPE:
+        case GDK_GL_RENDER_TYPE:
+          value = gdk_gl_config_get_attrib_or (glconfig, pairs[i].attrib, 0);
+          if ((value & wanted) != wanted)
+            return FALSE;
+          break;
+
+        default:
+          if (wanted == (int) GDK_GL_DONT_CARE)
+            break;
+          if (!gdk_gl_config_get_attrib (glconfig, pairs[i].attrib, &value) ||
+              value != wanted)
+            return FALSE;
+          break;
+        }
+    }
+
+  return TRUE;
+}
+
+/*
+ * Estimates the relative cost of rendering with glconfig; lower is
+ * better. Capabilities the caller asked for are free, unrequested extra
+ * buffers and non-native visuals are penalized.
+ */
+static int
+gdk_gl_config_estimate_cost (GdkGLConfig                 *glconfig,
+                             const GdkGLConfigAttribPair *pairs,
+                             gsize                        n_pairs,
+                             GdkVisual                   *system_visual)
+{
+  GdkVisual *visual;
+  int cost = 0;
+  int wanted, value;
+
+  switch (gdk_gl_config_get_attrib_or (glconfig, GDK_GL_CONFIG_CAVEAT,
+                                       GDK_GL_CONFIG_CAVEAT_NONE))
+    {
+    case GDK_GL_SLOW_CONFIG:
+      cost += 1000;
+      break;
+    case GDK_GL_NON_CONFORMANT_CONFIG:
+      cost += 100;
+      break;
+    default:
+      break;
+    }
+
+  if (gdk_gl_config_has_accum_buffer (glconfig) &&
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_ACCUM_RED_SIZE, 0) == 0 &&
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_ACCUM_GREEN_SIZE, 0) == 0 &&
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_ACCUM_BLUE_SIZE, 0) == 0 &&
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_ACCUM_ALPHA_SIZE, 0) == 0)
+    cost += 200;
+
+  if (gdk_gl_config_has_stencil_buffer (glconfig) &&
+      gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_STENCIL_SIZE, 0) == 0)
+    cost += 5;
+
+  wanted = gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_AUX_BUFFERS, 0);
+  value = gdk_gl_config_get_n_aux_buffers (glconfig);
+  if (value > wanted)
+    cost += (value - wanted) * 20;
+
+  wanted = gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_DEPTH_SIZE, 0);
+  value = gdk_gl_config_get_attrib_or (glconfig, GDK_GL_DEPTH_SIZE, 0);
+  if (value > 0 && wanted == 0)
+    cost += 20;
+  if (value > MAX (wanted, 24))
+    cost += (value - MAX (wanted, 24)) / 8 * 10;
+
+  wanted = gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_SAMPLES, 0);
+  value = gdk_gl_config_get_attrib_or (glconfig, GDK_GL_SAMPLES, 0);
+  if (value > wanted)
+    cost += (wanted == 0) ? 50 + value * 5 : (value - wanted) * 2;
+
+  visual = gdk_gl_config_get_visual (glconfig);
+  if (visual != NULL)
+    {
+      if (gdk_visual_get_visual_type (visual) != GDK_VISUAL_TRUE_COLOR)
+        cost += 100;
+
+      /* a non-native depth forces the server to convert on every copy */
+      if (gdk_visual_get_depth (visual) != gdk_visual_get_depth (system_visual) &&
+          gdk_gl_config_attrib_pairs_lookup (pairs, n_pairs, GDK_GL_ALPHA_SIZE, 0) == 0)
+        cost += 50;
+    }
+
+  value = gdk_gl_config_get_attrib_or (glconfig, GDK_GL_RED_SIZE, 8);
+  if (value < 8)
+    cost += (8 - value) * 5;
+
+  return cost;
+}
+
+typedef struct
+{
+  GdkGLConfig *glconfig;
+  int cost;
+} GdkGLConfigCandidate;
+
+static gint
+gdk_gl_config_candidate_compare (gconstpointer a,
+                                 gconstpointer b)
+{
+  const GdkGLConfigCandidate *ca = a;
+  const GdkGLConfigCandidate *cb = b;
+
+  return (ca->cost > cb->cost) - (ca->cost < cb->cost);
+}
+
+/**
+ * gdk_gl_config_choose_for_screen:
+ * @screen: target screen.
+ * @attrib_list: (array length=n_attribs): a list of attribute/value pairs.
+ * @n_attribs: the number of attributes and values in attrib_list.
+ *
+ * Returns the OpenGL frame buffer configuration of @screen that matches
+ * the specified attributes with the lowest estimated rendering cost.
+ * Candidates are the configurations returned by
+ * gdk_gl_config_list_for_screen(), whose per-screen list is reused, so
+ * the returned #GdkGLConfig is shared and must not be modified.
+ *
+ * Where gdk_gl_config_new_for_screen() takes the configuration preferred
+ * by the window system, this function ranks every matching configuration
+ * itself. Slow and non-conformant configurations, accumulation, stencil,
+ * auxiliary, depth and multisample buffers beyond what was requested, and
+ * visuals that differ from the screen's system visual are penalized.
+ *
+ * Size attributes are minimums. GDK_GL_DOUBLEBUFFER, GDK_GL_STEREO and
+ * GDK_GL_LEVEL must match exactly. GDK_GL_DRAWABLE_TYPE and
+ * GDK_GL_RENDER_TYPE are bit masks the configuration must contain. Other
+ * attributes must match exactly unless set to GDK_GL_DONT_CARE.
+ *
+ * Return value: the new #GdkGLConfig, or NULL if no configuration matches.
+ **/
+GdkGLConfig *
+gdk_gl_config_choose_for_screen (GdkScreen *screen,
+                                 const int *attrib_list,
+                                 gsize      n_attribs)
+{
+  GdkGLConfigAttribPair *pairs;
+  GdkGLConfigCandidate *candidate;
+  GdkGLConfig *glconfig = NULL;
+  GdkVisual *system_visual;
+  GList *configs, *candidates = NULL;
+  GList *l;
+  gsize n_pairs;
+
+  g_return_val_if_fail (GDK_IS_SCREEN (screen), NULL);
+  g_return_val_if_fail (attrib_list != NULL, NULL);
+
+  pairs = gdk_gl_config_parse_attrib_list (attrib_list, n_attribs, &n_pairs);
+  if (pairs == NULL)
+    {
+      g_warning ("Malformed attribute list");
+      return NULL;
+    }
+
+  system_visual = gdk_screen_get_system_visual (screen);
+
+  configs = gdk_gl_config_list_for_screen (screen);
+
+  for (l = configs; l != NULL; l = l->next)
+    {
+      if (!gdk_gl_config_matches (l->data, pairs, n_pairs))
+        continue;
+
+      candidate = g_new (GdkGLConfigCandidate, 1);
+      candidate->glconfig = l->data;
+      candidate->cost = gdk_gl_config_estimate_cost (l->data, pairs, n_pairs,
+                                                     system_visual);
+      candidates = g_list_prepend (candidates, candidate);
+    }
+
+  /* g_list_sort() is stable; keep the window system's order among ties */
+  candidates = g_list_sort (g_list_reverse (candidates),
+                            gdk_gl_config_candidate_compare);
+
+  GDK_GL_NOTE (MISC,
+    {
+      for (l = candidates; l != NULL; l = l->next)
+        {
+          candidate = l->data;
+          g_message (" -- config %p: cost %d", candidate->glconfig, candidate->cost);
+        }
+    });
+
+  if (candidates != NULL)
+    {
+      candidate = candidates->data;
+      glconfig = g_object_ref (candidate->glconfig);
+    }
+
+  g_list_free_full (candidates, g_free);
+  g_list_free_full (configs, g_object_unref);
+  g_free (pairs);
+
   return glconfig;
 }
 
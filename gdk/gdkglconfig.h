@@ -45,7 +45,7 @@ typedef enum
   GDK_GL_MODE_DEPTH       = 1 << 4,
   GDK_GL_MODE_STENCIL     = 1 << 5,
   GDK_GL_MODE_ACCUM       = 1 << 6,
-  GDK_GL_MODE_MULTISAMPLE = 1 << 7   /* not supported yet */
+  GDK_GL_MODE_MULTISAMPLE = 1 << 7
 } GdkGLConfigMode;
 
 struct _GdkGLConfigImpl;
@@ -85,6 +85,10 @@ GdkGLConfig *gdk_gl_config_new_for_screen         (GdkScreen       *screen,
                                                    const int       *attrib_list,
                                                    gsize            n_attribs);
 
+GdkGLConfig *gdk_gl_config_get_for_screen         (GdkScreen       *screen,
+                                                   const int       *attrib_list,
+                                                   gsize            n_attribs);
+
 #ifndef GDK_MULTIHEAD_SAFE
 GdkGLConfig *gdk_gl_config_new_by_mode            (GdkGLConfigMode  mode);
 #endif /* GDK_MULTIHEAD_SAFE */
@@ -92,6 +96,12 @@ GdkGLConfig *gdk_gl_config_new_by_mode            (GdkGLConfigMode  mode);
 GdkGLConfig *gdk_gl_config_new_by_mode_for_screen (GdkScreen       *screen,
                                                    GdkGLConfigMode  mode);
 
+GList       *gdk_gl_config_list_for_screen        (GdkScreen       *screen);
+
+GdkGLConfig *gdk_gl_config_choose_for_screen      (GdkScreen       *screen,
+                                                   const int       *attrib_list,
+                                                   gsize            n_attribs);
+
 GdkScreen   *gdk_gl_config_get_screen             (GdkGLConfig     *glconfig);
 
 gboolean     gdk_gl_config_get_attrib             (GdkGLConfig     *glconfig,
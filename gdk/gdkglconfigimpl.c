@@ -61,6 +61,7 @@ gdk_gl_config_impl_class_init (GdkGLConfigImplClass *klass)
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
   klass->create_gl_window = NULL;
+  klass->create_gl_pbuffer = NULL;
   klass->get_screen = NULL;
   klass->get_attrib = NULL;
   klass->get_visual = NULL;
@@ -57,6 +57,10 @@ typedef struct _GdkGLConfigImplClass
   GdkGLWindow* (*create_gl_window) (GdkGLConfig *glconfig,
                                     GdkWindow   *window,
                                     const int   *attrib_list);
+  GdkGLPbuffer* (*create_gl_pbuffer) (GdkGLConfig *glconfig,
+                                      int          width,
+                                      int          height,
+                                      const int   *attrib_list);
 
   GdkScreen* (*get_screen) (GdkGLConfig *glconfig);
   gboolean   (*get_attrib) (GdkGLConfig *glconfig,
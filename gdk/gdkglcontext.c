@@ -32,8 +32,18 @@
 #include "gdkglconfig.h"
 #include "gdkglcontext.h"
 #include "gdkglcontextimpl.h"
+#include "gdkglframebuffer.h"
+#include "gdkglwindow.h"
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+#include "egl/gdkeglglconfig.h"
+#include "egl/gdkeglglcontext.h"
+#include "egl/gdkglcontext-egl.h"
+#include "egl/gdkglquery-egl.h"
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
+#include "x11/gdkx11glconfig.h"
+#include "x11/gdkx11glcontext.h"
 #include "x11/gdkglcontext-x11.h"
 #endif
 #ifdef GDKGLEXT_WINDOWING_WIN32
@@ -41,6 +51,10 @@
 #endif
 
 gboolean _gdk_gl_context_force_indirect = FALSE;
+gboolean _gdk_gl_context_no_error = FALSE;
+
+gint _gdk_gl_context_n_make_current = 0;
+gint _gdk_gl_context_n_make_current_skipped = 0;
 
 G_DEFINE_TYPE (GdkGLContext,    \
                gdk_gl_context,  \
@@ -85,6 +99,234 @@ gdk_gl_context_new (GdkGLDrawable *gldrawable,
                                                                     render_type);
 }
 
+/**
+ * gdk_gl_context_new_full:
+ * @gldrawable: a #GdkGLDrawable.
+ * @share_list: the #GdkGLContext with which to share display lists and texture
+ *              objects. NULL indicates that no sharing is to take place.
+ * @direct: whether rendering is to be done with a direct connection to
+ *          the graphics system.
+ * @render_type: GDK_GL_RGBA_TYPE.
+ * @major_version: the requested OpenGL major version, or 0 for any.
+ * @minor_version: the requested OpenGL minor version.
+ * @profile: the requested #GdkGLContextProfile.
+ * @flags: a combination of #GdkGLContextFlags.
+ *
+ * Creates a new OpenGL rendering context of a specific version and profile.
+ * Core profile contexts skip the validation of deprecated state that
+ * compatibility contexts must perform on every draw.
+ *
+ * The context is created with GLX_ARB_create_context when it is available.
+ * If the window system does not support it, a legacy context is created
+ * as with gdk_gl_context_new(); check GL_VERSION to find out what you got.
+ * If the extension is available but the requested version, profile or
+ * flags are not supported, NULL is returned.
+ *
+ * GDK_GL_CONTEXT_NO_ERROR_BIT requests a context that skips error
+ * checking (GLX_ARB_create_context_no_error); glGetError() then returns
+ * either GL_NO_ERROR or GL_OUT_OF_MEMORY and invalid calls have undefined
+ * results. The flag is ignored when the extension is missing, when
+ * GDK_GL_CONTEXT_DEBUG_BIT is also set, or when @share_list is not a
+ * no-error context. Setting the <envar>GDK_GL_NO_ERROR</envar>
+ * environment variable turns it on for every context.
+ *
+ * Return value: the new #GdkGLContext.
+ **/
+GdkGLContext *
+gdk_gl_context_new_full (GdkGLDrawable       *gldrawable,
+                         GdkGLContext        *share_list,
+                         gboolean             direct,
+                         int                  render_type,
+                         int                  major_version,
+                         int                  minor_version,
+                         GdkGLContextProfile  profile,
+                         GdkGLContextFlags    flags)
+{
+  GdkGLDrawableClass *iface;
+
+  g_return_val_if_fail (GDK_IS_GL_DRAWABLE (gldrawable), NULL);
+  g_return_val_if_fail (major_version >= 0 && minor_version >= 0, NULL);
+
+  iface = GDK_GL_DRAWABLE_GET_CLASS (gldrawable);
+
+  if (iface->create_gl_context_full == NULL)
+    return iface->create_gl_context (gldrawable,
+                                     share_list,
+                                     direct,
+                                     render_type);
+
+  return iface->create_gl_context_full (gldrawable,
+                                        share_list,
+                                        direct,
+                                        render_type,
+                                        major_version,
+                                        minor_version,
+                                        profile,
+                                        flags);
+}
+
+/**
+ * gdk_gl_context_new_offscreen:
+ * @glconfig: a #GdkGLConfig.
+ * @share_list: the #GdkGLContext with which to share display lists and texture
+ *              objects. NULL indicates that no sharing is to take place.
+ * @direct: whether rendering is to be done with a direct connection to
+ *          the graphics system.
+ * @render_type: GDK_GL_RGBA_TYPE.
+ * @major_version: the requested OpenGL major version, or 0 for any.
+ * @minor_version: the requested OpenGL minor version.
+ * @profile: the requested #GdkGLContextProfile.
+ * @flags: a combination of #GdkGLContextFlags.
+ *
+ * Creates an OpenGL rendering context that needs no window, for batch
+ * rendering, thumbnailing or tests. Bind it with
+ * gdk_gl_context_make_current() passing NULL drawables, then render into
+ * a framebuffer object.
+ *
+ * On X11 the context is bound to a hidden 1x1 pbuffer when @glconfig
+ * supports pbuffers (ask for GDK_GL_PBUFFER_BIT in GDK_GL_DRAWABLE_TYPE).
+ * Otherwise OpenGL 3.0 and later contexts are bound with no drawable at
+ * all, as GLX_ARB_create_context allows. With EGL, the context is bound
+ * to a 1x1 pbuffer or, with EGL_KHR_surfaceless_context, to no surface;
+ * configs from gdk_egl_gl_config_new_surfaceless() need no display
+ * server at all. The other parameters are handled as in
+ * gdk_gl_context_new_full().
+ *
+ * Return value: the new #GdkGLContext, or NULL if it cannot be created.
+ **/
+GdkGLContext *
+gdk_gl_context_new_offscreen (GdkGLConfig         *glconfig,
+                              GdkGLContext        *share_list,
+                              gboolean             direct,
+                              int                  render_type,
+                              int                  major_version,
+                              int                  minor_version,
+                              GdkGLContextProfile  profile,
+                              GdkGLContextFlags    flags)
+{
+  GdkGLContext *glcontext = NULL;
+  GdkGLContextImpl *impl = NULL;
+
+  g_return_val_if_fail (GDK_IS_GL_CONFIG (glconfig), NULL);
+  g_return_val_if_fail (major_version >= 0 && minor_version >= 0, NULL);
+
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (GDK_IS_EGL_GL_CONFIG (glconfig))
+    {
+      glcontext = g_object_new (GDK_TYPE_EGL_GL_CONTEXT, NULL);
+      impl = _gdk_egl_gl_context_impl_new_offscreen (glcontext,
+                                                     glconfig,
+                                                     share_list,
+                                                     direct,
+                                                     render_type,
+                                                     major_version,
+                                                     minor_version,
+                                                     profile,
+                                                     flags);
+    }
+#endif
+#ifdef GDKGLEXT_WINDOWING_X11
+  if (GDK_IS_X11_GL_CONFIG (glconfig))
+    {
+      glcontext = g_object_new (GDK_TYPE_X11_GL_CONTEXT, NULL);
+      impl = _gdk_x11_gl_context_impl_new_offscreen (glcontext,
+                                                     glconfig,
+                                                     share_list,
+                                                     direct,
+                                                     render_type,
+                                                     major_version,
+                                                     minor_version,
+                                                     profile,
+                                                     flags);
+    }
+#endif
+
+  if (glcontext != NULL && impl == NULL)
+    {
+      g_object_unref (glcontext);
+      glcontext = NULL;
+    }
+
+  return glcontext;
+}
+
+/**
+ * gdk_gl_context_new_worker:
+ * @share_list: the #GdkGLContext whose display lists, textures and buffer
+ *              objects the new context shares.
+ *
+ * Creates a hidden OpenGL rendering context in the share group of
+ * @share_list, for uploading resources from another thread. The context
+ * is created with the same config, version, profile and flags as
+ * @share_list and brings its own offscreen drawable; bind it with
+ * gdk_gl_context_make_current() passing NULL drawables. See also
+ * #GdkGLWorkerPool.
+ *
+ * On X11 this requires GLX 1.3 and a config that supports pbuffers, or
+ * an OpenGL 3.0 or later @share_list (see gdk_gl_context_new_offscreen()).
+ * Create the context from the thread running the GDK main loop, since
+ * creation uses GDK error traps; binding it from other threads does not.
+ *
+ * Return value: the new #GdkGLContext, or NULL if it cannot be created.
+ **/
+GdkGLContext *
+gdk_gl_context_new_worker (GdkGLContext *share_list)
+{
+  GdkGLContext *glcontext = NULL;
+  GdkGLContextImpl *impl = NULL;
+
+  g_return_val_if_fail (GDK_IS_GL_CONTEXT (share_list), NULL);
+
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (GDK_IS_EGL_GL_CONTEXT (share_list))
+    {
+      glcontext = g_object_new (GDK_TYPE_EGL_GL_CONTEXT, NULL);
+      impl = _gdk_egl_gl_context_impl_new_worker (glcontext, share_list);
+    }
+#endif
+#ifdef GDKGLEXT_WINDOWING_X11
+  if (GDK_IS_X11_GL_CONTEXT (share_list))
+    {
+      glcontext = g_object_new (GDK_TYPE_X11_GL_CONTEXT, NULL);
+      impl = _gdk_x11_gl_context_impl_new_worker (glcontext, share_list);
+    }
+#endif
+
+  if (glcontext != NULL && impl == NULL)
+    {
+      g_object_unref (glcontext);
+      glcontext = NULL;
+    }
+
+  return glcontext;
+}
+
+/*
+ * Like gdk_gl_context_new_worker(), but the new context does not keep
+ * share_list alive, for helpers that share_list itself owns. The caller
+ * must destroy the context before share_list is disposed of.
+ */
+GdkGLContext *
+_gdk_gl_context_new_owned_worker (GdkGLContext *share_list)
+{
+  GdkGLContext *glcontext;
+
+  glcontext = gdk_gl_context_new_worker (share_list);
+  if (glcontext == NULL)
+    return NULL;
+
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (GDK_IS_EGL_GL_CONTEXT (glcontext))
+    _gdk_egl_gl_context_impl_weaken_share_list (glcontext);
+#endif
+#ifdef GDKGLEXT_WINDOWING_X11
+  if (GDK_IS_X11_GL_CONTEXT (glcontext))
+    _gdk_x11_gl_context_impl_weaken_share_list (glcontext);
+#endif
+
+  return glcontext;
+}
+
 /**
  * gdk_gl_context_copy:
  * @glcontext: a #GdkGLContext.
@@ -192,16 +434,55 @@ gdk_gl_context_get_render_type (GdkGLContext *glcontext)
   return GDK_GL_CONTEXT_IMPL_GET_CLASS (glcontext->impl)->get_render_type(glcontext);
 }
 
+/**
+ * gdk_gl_context_make_current:
+ * @glcontext: a #GdkGLContext.
+ * @draw: the #GdkGLDrawable to render into, or NULL for the hidden
+ *        drawable of an offscreen or worker context.
+ * @read: the #GdkGLDrawable to read pixels from, or NULL to use @draw.
+ *
+ * Binds @glcontext to the calling thread with @draw as the draw drawable
+ * and @read as the read drawable. With a separate @read drawable,
+ * glCopyPixels() and glReadPixels() read from @read, so pixels can be
+ * copied from one drawable into another without going through client
+ * memory. On X11 this requires GLX 1.3.
+ *
+ * A #GdkGLFramebuffer can only be bound with the context it was created
+ * with, and only together with another framebuffer as @read.
+ *
+ * If gdk_gl_window_queue_wait_gdk() was called on @draw, this also waits
+ * for GDK once the context is current.
+ *
+ * Return value: TRUE if it is successful, FALSE otherwise.
+ **/
 gboolean
 gdk_gl_context_make_current(GdkGLContext  *glcontext,
                             GdkGLDrawable *draw,
                             GdkGLDrawable *read)
 {
+  gboolean ret;
+
   g_return_val_if_fail (GDK_IS_GL_CONTEXT (glcontext), FALSE);
 
-  return GDK_GL_CONTEXT_IMPL_GET_CLASS (glcontext->impl)->make_current(glcontext,
-                                                                       draw,
-                                                                       read);
+  g_atomic_int_inc (&_gdk_gl_context_n_make_current);
+
+  /* Framebuffer objects are bound inside the context, not by the
+     window system. */
+  if (draw != NULL && GDK_IS_GL_FRAMEBUFFER (draw))
+    return _gdk_gl_framebuffer_make_current (glcontext, draw, read);
+
+  ret = GDK_GL_CONTEXT_IMPL_GET_CLASS (glcontext->impl)->make_current(glcontext,
+                                                                      draw,
+                                                                      read);
+  if (ret)
+    {
+      _gdk_gl_framebuffer_unbind (glcontext);
+
+      if (draw != NULL && GDK_IS_GL_WINDOW (draw))
+        _gdk_gl_window_flush_wait_gdk (GDK_GL_WINDOW (draw));
+    }
+
+  return ret;
 }
 
 /**
@@ -225,6 +506,9 @@ gdk_gl_context_release_current ()
  *
  * Returns the current #GdkGLContext.
  *
+ * The current context is tracked per thread, so each rendering thread
+ * sees the context it made current itself.
+ *
  * Return value: the current #GdkGLContext or NULL if there is no current
  *               context.
  **/
@@ -240,7 +524,12 @@ gdk_gl_context_get_current ()
 
   GdkGLContext *current = NULL;
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (_gdk_egl_gl_is_enabled())
+    current = _gdk_egl_gl_context_impl_get_current();
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
+  if (current == NULL)
     current = _gdk_x11_gl_context_impl_get_current();
 #endif
 #ifdef GDKGLEXT_WINDOWING_WIN32
@@ -252,3 +541,26 @@ gdk_gl_context_get_current ()
 
   return current;
 }
+
+/**
+ * gdk_gl_context_get_make_current_stats:
+ * @n_calls: return location for the number of gdk_gl_context_make_current()
+ *           calls, or NULL.
+ * @n_skipped: return location for the number of those calls that found
+ *             the context and drawables already bound, or NULL.
+ *
+ * Gets process-wide counters for gdk_gl_context_make_current(). Calls
+ * that find the requested binding already current in the calling thread
+ * return without going to the window system, and are counted in
+ * @n_skipped.
+ **/
+void
+gdk_gl_context_get_make_current_stats (guint *n_calls,
+                                       guint *n_skipped)
+{
+  if (n_calls != NULL)
+    *n_calls = g_atomic_int_get (&_gdk_gl_context_n_make_current);
+
+  if (n_skipped != NULL)
+    *n_skipped = g_atomic_int_get (&_gdk_gl_context_n_make_current_skipped);
+}
@@ -24,6 +24,7 @@
 #define __GDK_GL_CONTEXT_H__
 
 #include <gdk/gdkgldefs.h>
+#include <gdk/gdkgltokens.h>
 #include <gdk/gdkgltypes.h>
 
 G_BEGIN_DECLS
@@ -57,6 +58,26 @@ GdkGLContext  *gdk_gl_context_new             (GdkGLDrawable *gldrawable,
                                                gboolean       direct,
                                                int            render_type);
 
+GdkGLContext  *gdk_gl_context_new_full        (GdkGLDrawable       *gldrawable,
+                                               GdkGLContext        *share_list,
+                                               gboolean             direct,
+                                               int                  render_type,
+                                               int                  major_version,
+                                               int                  minor_version,
+                                               GdkGLContextProfile  profile,
+                                               GdkGLContextFlags    flags);
+
+GdkGLContext  *gdk_gl_context_new_offscreen   (GdkGLConfig         *glconfig,
+                                               GdkGLContext        *share_list,
+                                               gboolean             direct,
+                                               int                  render_type,
+                                               int                  major_version,
+                                               int                  minor_version,
+                                               GdkGLContextProfile  profile,
+                                               GdkGLContextFlags    flags);
+
+GdkGLContext  *gdk_gl_context_new_worker      (GdkGLContext  *share_list);
+
 gboolean       gdk_gl_context_copy            (GdkGLContext  *glcontext,
                                                GdkGLContext  *src,
                                                unsigned long  mask);
@@ -79,6 +100,9 @@ void           gdk_gl_context_release_current (void);
 
 GdkGLContext  *gdk_gl_context_get_current     (void);
 
+void           gdk_gl_context_get_make_current_stats (guint *n_calls,
+                                                      guint *n_skipped);
+
 G_END_DECLS
 
 #endif /* __GDK_GL_CONTEXT_H__ */
@@ -124,3 +124,127 @@ gdk_gl_drawable_get_gl_config (GdkGLDrawable *gldrawable)
 
   return GDK_GL_DRAWABLE_GET_CLASS (gldrawable)->get_gl_config (gldrawable);
 }
+
+/**
+ * gdk_gl_drawable_set_swap_interval:
+ * @gldrawable: a #GdkGLDrawable.
+ * @interval: the minimum number of video frames between buffer swaps.
+ *
+ * Sets how gdk_gl_drawable_swap_buffers() synchronizes with the vertical
+ * retrace. 0 swaps immediately, 1 waits for the next retrace, and so on.
+ * A negative interval asks for adaptive vsync: swaps wait for retrace
+ * -@interval, but a swap that misses it happens immediately, with
+ * tearing, instead of stalling for another frame. Where adaptive vsync
+ * is not available, -@interval is used as a plain interval.
+ *
+ * On X11 this uses GLX_EXT_swap_control (and GLX_EXT_swap_control_tear
+ * for negative intervals), GLX_MESA_swap_control or GLX_SGI_swap_control.
+ * The last two set the interval of the current drawable, so a context
+ * must be current on @gldrawable for them; GLX_SGI_swap_control also
+ * cannot turn synchronization off.
+ *
+ * Return value: TRUE if the interval has been set, FALSE otherwise.
+ **/
+gboolean
+gdk_gl_drawable_set_swap_interval (GdkGLDrawable *gldrawable,
+                                   int            interval)
+{
+  GdkGLDrawableClass *iface;
+
+  g_return_val_if_fail (GDK_IS_GL_DRAWABLE (gldrawable), FALSE);
+
+  iface = GDK_GL_DRAWABLE_GET_CLASS (gldrawable);
+
+  if (iface->set_swap_interval == NULL)
+    return FALSE;
+
+  return iface->set_swap_interval (gldrawable, interval);
+}
+
+/**
+ * gdk_gl_drawable_get_swap_interval:
+ * @gldrawable: a #GdkGLDrawable.
+ *
+ * Gets the swap interval in effect for @gldrawable, negative if late
+ * swaps tear. See gdk_gl_drawable_set_swap_interval(). When the window
+ * system cannot be asked, this is the last interval that was set, or 1.
+ *
+ * Return value: the swap interval, or 0 if @gldrawable is not
+ *               synchronized with the vertical retrace.
+ **/
+int
+gdk_gl_drawable_get_swap_interval (GdkGLDrawable *gldrawable)
+{
+  GdkGLDrawableClass *iface;
+
+  g_return_val_if_fail (GDK_IS_GL_DRAWABLE (gldrawable), 0);
+
+  iface = GDK_GL_DRAWABLE_GET_CLASS (gldrawable);
+
+  if (iface->get_swap_interval == NULL)
+    return 0;
+
+  return iface->get_swap_interval (gldrawable);
+}
+
+/**
+ * gdk_gl_drawable_get_buffer_age:
+ * @gldrawable: a #GdkGLDrawable.
+ *
+ * Gets the age of the back buffer of @gldrawable: how many swaps ago
+ * its contents were the current frame. An age of 1 means the back
+ * buffer holds the previous frame, so only what changed since then has
+ * to be redrawn; an age of N means the damage of the last N - 1 frames
+ * must be redrawn as well. Call this after making a context current on
+ * @gldrawable and before drawing.
+ *
+ * This uses GLX_EXT_buffer_age or EGL_EXT_buffer_age where available.
+ *
+ * Return value: the buffer age, or 0 if the contents of the back buffer
+ *               are undefined and the whole frame must be redrawn.
+ **/
+int
+gdk_gl_drawable_get_buffer_age (GdkGLDrawable *gldrawable)
+{
+  GdkGLDrawableClass *iface;
+
+  g_return_val_if_fail (GDK_IS_GL_DRAWABLE (gldrawable), 0);
+
+  iface = GDK_GL_DRAWABLE_GET_CLASS (gldrawable);
+
+  if (iface->get_buffer_age == NULL)
+    return 0;
+
+  return iface->get_buffer_age (gldrawable);
+}
+
+/**
+ * gdk_gl_drawable_swap_buffers_with_damage:
+ * @gldrawable: a #GdkGLDrawable.
+ * @damage: (allow-none): the region that changed since the last swap, in
+ *          window coordinates with the origin at the top left, or NULL.
+ *
+ * Like gdk_gl_drawable_swap_buffers(), but only the pixels in @damage
+ * need to reach the screen. The window system may use this to present
+ * less. A NULL @damage means the whole drawable.
+ *
+ * With EGL this uses EGL_KHR_swap_buffers_with_damage. On X11 without
+ * GLX_EXT_buffer_age, the damaged rectangles are copied to the front
+ * buffer with GLX_MESA_copy_sub_buffer, which keeps the back buffer
+ * intact so that its age stays 1. Otherwise the whole buffer is swapped.
+ **/
+void
+gdk_gl_drawable_swap_buffers_with_damage (GdkGLDrawable        *gldrawable,
+                                          const cairo_region_t *damage)
+{
+  GdkGLDrawableClass *iface;
+
+  g_return_if_fail (GDK_IS_GL_DRAWABLE (gldrawable));
+
+  iface = GDK_GL_DRAWABLE_GET_CLASS (gldrawable);
+
+  if (damage == NULL || iface->swap_buffers_with_damage == NULL)
+    iface->swap_buffers (gldrawable);
+  else
+    iface->swap_buffers_with_damage (gldrawable, damage);
+}
@@ -24,6 +24,7 @@
 #define __GDK_GL_DRAWABLE_H__
 
 #include <gdk/gdkgldefs.h>
+#include <gdk/gdkgltokens.h>
 #include <gdk/gdkgltypes.h>
 
 G_BEGIN_DECLS
@@ -45,12 +46,26 @@ struct _GdkGLDrawableClass
                                       GdkGLContext  *share_list,
                                       gboolean       direct,
                                       int            render_type);
+  GdkGLContext* (*create_gl_context_full) (GdkGLDrawable       *gldrawable,
+                                           GdkGLContext        *share_list,
+                                           gboolean             direct,
+                                           int                  render_type,
+                                           int                  major_version,
+                                           int                  minor_version,
+                                           GdkGLContextProfile  profile,
+                                           GdkGLContextFlags    flags);
 
   gboolean      (*is_double_buffered)   (GdkGLDrawable *gldrawable);
   void          (*swap_buffers)         (GdkGLDrawable *gldrawable);
   void          (*wait_gl)              (GdkGLDrawable *gldrawable);
   void          (*wait_gdk)             (GdkGLDrawable *gldrawable);
   GdkGLConfig*  (*get_gl_config)        (GdkGLDrawable *gldrawable);
+  gboolean      (*set_swap_interval)    (GdkGLDrawable *gldrawable,
+                                         int            interval);
+  int           (*get_swap_interval)    (GdkGLDrawable *gldrawable);
+  int           (*get_buffer_age)       (GdkGLDrawable *gldrawable);
+  void          (*swap_buffers_with_damage) (GdkGLDrawable        *gldrawable,
+                                             const cairo_region_t *damage);
 };
 
 GType          gdk_gl_drawable_get_type           (void);
@@ -65,6 +80,33 @@ void           gdk_gl_drawable_wait_gdk           (GdkGLDrawable *gldrawable);
 
 GdkGLConfig   *gdk_gl_drawable_get_gl_config      (GdkGLDrawable *gldrawable);
 
+gboolean       gdk_gl_drawable_set_swap_interval  (GdkGLDrawable *gldrawable,
+                                                   int            interval);
+
+int            gdk_gl_drawable_get_swap_interval  (GdkGLDrawable *gldrawable);
+
+int            gdk_gl_drawable_get_buffer_age     (GdkGLDrawable *gldrawable);
+
+void           gdk_gl_drawable_swap_buffers_with_damage (GdkGLDrawable        *gldrawable,
+                                                         const cairo_region_t *damage);
+
+void           gdk_gl_drawable_read_pixels_async  (GdkGLDrawable        *gldrawable,
+                                                   int                   x,
+                                                   int                   y,
+                                                   int                   width,
+                                                   int                   height,
+                                                   GCancellable         *cancellable,
+                                                   GAsyncReadyCallback   callback,
+                                                   gpointer              user_data);
+
+GBytes        *gdk_gl_drawable_read_pixels_finish (GdkGLDrawable        *gldrawable,
+                                                   GAsyncResult         *result,
+                                                   GError              **error);
+
+cairo_surface_t *gdk_gl_drawable_read_pixels_finish_surface (GdkGLDrawable  *gldrawable,
+                                                             GAsyncResult   *result,
+                                                             GError        **error);
+
 G_END_DECLS
 
 #endif /* __GDK_GL_DRAWABLE_H__ */
@@ -0,0 +1,983 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gdkglprivate.h"
+#include "gdkglquery.h"
+#include "gdkglcontext.h"
+#include "gdkglfence.h"
+
+#ifdef G_OS_WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#endif
+
+#ifdef GDK_WINDOWING_QUARTZ
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+/* OpenGL 3.2 and GL_ARB_sync share these names and values. */
+#if !defined (GL_ARB_sync) && !defined (GL_VERSION_3_2)
+typedef struct __GLsync *GLsync;
+typedef guint64 GLuint64;
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT        0x00000001
+#define GL_ALREADY_SIGNALED               0x911A
+#define GL_TIMEOUT_EXPIRED                0x911B
+#define GL_CONDITION_SATISFIED            0x911C
+#define GL_WAIT_FAILED                    0x911D
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED                G_GUINT64_CONSTANT (0xFFFFFFFFFFFFFFFF)
+#endif
+
+/* Client waits without a timeout are done in steps of this many
+   nanoseconds, so that no implementation limit is hit. */
+#define GDK_GL_FENCE_WAIT_STEP            G_GUINT64_CONSTANT (1000000000)
+
+typedef struct
+{
+  GLsync (APIENTRY *FenceSync)      (GLenum condition, GLbitfield flags);
+  void   (APIENTRY *DeleteSync)     (GLsync sync);
+  GLenum (APIENTRY *ClientWaitSync) (GLsync sync, GLbitfield flags, GLuint64 timeout);
+  void   (APIENTRY *WaitSync)       (GLsync sync, GLbitfield flags, GLuint64 timeout);
+} GdkGLFenceProcs;
+
+/*
+ * Per-context state, attached to the context the fences are created in.
+ * Sync objects can only be deleted while a context of their share group
+ * is current; fences released elsewhere leave their sync object on the
+ * orphan list, which is emptied the next time a fence is created. When
+ * the context is disposed, whatever is left is handed to its share list,
+ * which keeps the share group alive.
+ */
+typedef struct
+{
+  gboolean supported;
+  GdkGLFenceProcs procs;
+
+  GMutex orphans_lock;
+  GSList *orphans;
+} GdkGLFenceContextData;
+
+struct _GdkGLFence
+{
+  GObject parent_instance;
+
+  GdkGLContext *glcontext;
+  GdkGLFenceContextData *data;
+
+  /* NULL if sync objects are not supported; the fence is then created
+     signaled */
+  GLsync sync;
+
+  volatile gint signaled;
+};
+
+G_DEFINE_TYPE (GdkGLFence, gdk_gl_fence, G_TYPE_OBJECT)
+
+static void gdk_gl_fence_context_disposed (gpointer  user_data,
+                                           GObject  *where_the_object_was);
+
+static const gchar quark_fence_data_string[] = "gdk-gl-context-fence-data";
+static GQuark quark_fence_data = 0;
+
+/* Context data may be attached from another thread when orphans are
+   handed over. */
+G_LOCK_DEFINE_STATIC (fence_data);
+
+static void
+gdk_gl_fence_init (GdkGLFence *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  self->glcontext = NULL;
+  self->data = NULL;
+  self->sync = NULL;
+  self->signaled = FALSE;
+}
+
+static void
+gdk_gl_fence_finalize (GObject *object)
+{
+  GdkGLFence *glfence = GDK_GL_FENCE (object);
+  GdkGLFenceContextData *data = glfence->data;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (glfence->sync != NULL)
+    {
+      if (gdk_gl_context_get_current () == glfence->glcontext)
+        {
+          data->procs.DeleteSync (glfence->sync);
+        }
+      else
+        {
+          GDK_GL_NOTE (MISC,
+            g_message (" -- context not current, sync object deleted later"));
+
+          g_mutex_lock (&data->orphans_lock);
+          data->orphans = g_slist_prepend (data->orphans, glfence->sync);
+          g_mutex_unlock (&data->orphans_lock);
+        }
+
+      glfence->sync = NULL;
+    }
+
+  if (glfence->glcontext != NULL)
+    {
+      g_object_unref (G_OBJECT (glfence->glcontext));
+      glfence->glcontext = NULL;
+    }
+
+  G_OBJECT_CLASS (gdk_gl_fence_parent_class)->finalize (object);
+}
+
+static void
+gdk_gl_fence_class_init (GdkGLFenceClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  quark_fence_data = g_quark_from_static_string (quark_fence_data_string);
+
+  object_class->finalize = gdk_gl_fence_finalize;
+}
+
+static void
+gdk_gl_fence_context_data_free (gpointer user_data)
+{
+  GdkGLFenceContextData *data = user_data;
+
+  /* Anything still here belongs to a share group that was destroyed
+     with the context; see gdk_gl_fence_context_disposed(). */
+  g_slist_free (data->orphans);
+  g_mutex_clear (&data->orphans_lock);
+
+  g_free (data);
+}
+
+static GdkGLFenceContextData *
+gdk_gl_fence_context_data_new (GdkGLContext *glcontext)
+{
+  GdkGLFenceContextData *data;
+
+  data = g_new0 (GdkGLFenceContextData, 1);
+  g_mutex_init (&data->orphans_lock);
+  data->orphans = NULL;
+
+  g_object_set_qdata_full (G_OBJECT (glcontext), quark_fence_data,
+                           data, gdk_gl_fence_context_data_free);
+  g_object_weak_ref (G_OBJECT (glcontext),
+                     gdk_gl_fence_context_disposed, data);
+
+  return data;
+}
+
+/*
+ * Looks the entry points up in the current context.
+ */
+static gboolean
+gdk_gl_fence_load_procs (GdkGLFenceProcs *procs)
+{
+  const char *version;
+  const char *dot;
+  gboolean is_es;
+  int major, minor;
+
+  version = (const char *) glGetString (GL_VERSION);
+  if (version == NULL)
+    return FALSE;
+
+  is_es = g_str_has_prefix (version, "OpenGL ES ");
+  if (is_es)
+    version += strlen ("OpenGL ES ");
+
+  major = atoi (version);
+  dot = strchr (version, '.');
+  minor = (dot != NULL) ? atoi (dot + 1) : 0;
+
+  /* Sync objects are core in OpenGL 3.2 and OpenGL ES 3.0. */
+  if (!(is_es ? major >= 3 : (major > 3 || (major == 3 && minor >= 2))) &&
+      !gdk_gl_query_gl_extension ("GL_ARB_sync"))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Sync objects not supported"));
+      return FALSE;
+    }
+
+#define LOAD_PROC(name)                                                 \
+  if ((procs->name = (gpointer) gdk_gl_get_proc_address ("gl" #name)) == NULL) \
+    return FALSE
+
+  LOAD_PROC (FenceSync);
+  LOAD_PROC (DeleteSync);
+  LOAD_PROC (ClientWaitSync);
+  LOAD_PROC (WaitSync);
+
+#undef LOAD_PROC
+
+  return TRUE;
+}
+
+/*
+ * Gets the data of glcontext, which must be current.
+ */
+static GdkGLFenceContextData *
+gdk_gl_fence_get_context_data (GdkGLContext *glcontext)
+{
+  GdkGLFenceContextData *data;
+
+  G_LOCK (fence_data);
+
+  data = g_object_get_qdata (G_OBJECT (glcontext), quark_fence_data);
+  if (data == NULL)
+    {
+      data = gdk_gl_fence_context_data_new (glcontext);
+      data->supported = gdk_gl_fence_load_procs (&data->procs);
+    }
+
+  G_UNLOCK (fence_data);
+
+  return data;
+}
+
+static void
+gdk_gl_fence_delete_orphans (GdkGLFenceContextData *data)
+{
+  GSList *orphans, *l;
+
+  g_mutex_lock (&data->orphans_lock);
+  orphans = data->orphans;
+  data->orphans = NULL;
+  g_mutex_unlock (&data->orphans_lock);
+
+  for (l = orphans; l != NULL; l = l->next)
+    data->procs.DeleteSync (l->data);
+
+  g_slist_free (orphans);
+}
+
+/*
+ * Called while glcontext is disposed, before its GL context is
+ * destroyed. Sync objects still on the orphan list are deleted if the
+ * context happens to be current, and otherwise handed to the share list,
+ * whose next fence deletes them. A context without a share list takes
+ * its whole share group with it, so its sync objects need no deleting.
+ */
+static void
+gdk_gl_fence_context_disposed (gpointer  user_data,
+                               GObject  *where_the_object_was)
+{
+  GdkGLFenceContextData *data = user_data;
+  GdkGLContext *glcontext = GDK_GL_CONTEXT (where_the_object_was);
+  GdkGLContext *share_list;
+  GdkGLFenceContextData *share_data;
+  GSList *orphans;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (gdk_gl_context_get_current () == glcontext)
+    {
+      gdk_gl_fence_delete_orphans (data);
+      return;
+    }
+
+  share_list = gdk_gl_context_get_share_list (glcontext);
+  if (share_list == NULL)
+    return;
+
+  g_mutex_lock (&data->orphans_lock);
+  orphans = data->orphans;
+  data->orphans = NULL;
+  g_mutex_unlock (&data->orphans_lock);
+
+  if (orphans == NULL)
+    return;
+
+  GDK_GL_NOTE (MISC,
+    g_message (" -- %u sync objects handed to the share list",
+               g_slist_length (orphans)));
+
+  G_LOCK (fence_data);
+
+  share_data = g_object_get_qdata (G_OBJECT (share_list), quark_fence_data);
+  if (share_data == NULL)
+    {
+      /* Both contexts run on the same implementation. */
+      share_data = gdk_gl_fence_context_data_new (share_list);
+      share_data->supported = TRUE;
+      share_data->procs = data->procs;
+    }
+
+  g_mutex_lock (&share_data->orphans_lock);
+  share_data->orphans = g_slist_concat (orphans, share_data->orphans);
+  g_mutex_unlock (&share_data->orphans_lock);
+
+  G_UNLOCK (fence_data);
+}
+
+/*
+ * Interprets a glClientWaitSync() result. A failed wait is reported as
+ * signaled, so that nobody waits for the fence forever.
+ */
+static gboolean
+gdk_gl_fence_check_wait_result (GdkGLFence *glfence,
+                                GLenum      result)
+{
+  switch (result)
+    {
+    case GL_ALREADY_SIGNALED:
+    case GL_CONDITION_SATISFIED:
+      break;
+    case GL_TIMEOUT_EXPIRED:
+      return FALSE;
+    default:
+      g_warning ("cannot wait for the OpenGL fence");
+      break;
+    }
+
+  g_atomic_int_set (&glfence->signaled, TRUE);
+
+  return TRUE;
+}
+
+/**
+ * gdk_gl_fence_new:
+ *
+ * Inserts a fence into the command stream of the current context. The
+ * fence is signaled once every command issued before it has completed,
+ * so it can stand in for glFinish() without stalling the caller: poll
+ * it with gdk_gl_fence_is_signaled(), block on it with
+ * gdk_gl_fence_client_wait(), or make another context wait for it on
+ * the GPU with gdk_gl_fence_server_wait().
+ *
+ * The command stream is flushed, so that the fence can be waited for
+ * from any context in the share group and from any thread.
+ *
+ * Fences use OpenGL 3.2 or GL_ARB_sync. Without them, this function
+ * calls glFinish() and returns a fence that is already signaled.
+ *
+ * Return value: the new #GdkGLFence, or NULL if no context is current.
+ **/
+GdkGLFence *
+gdk_gl_fence_new (void)
+{
+  GdkGLContext *glcontext;
+  GdkGLFenceContextData *data;
+  GdkGLFence *glfence;
+
+  GDK_GL_NOTE_FUNC ();
+
+  glcontext = gdk_gl_context_get_current ();
+  g_return_val_if_fail (glcontext != NULL, NULL);
+
+  data = gdk_gl_fence_get_context_data (glcontext);
+
+  glfence = g_object_new (GDK_TYPE_GL_FENCE, NULL);
+
+  glfence->glcontext = glcontext;
+  g_object_ref (G_OBJECT (glfence->glcontext));
+  glfence->data = data;
+
+  if (data->supported)
+    {
+      gdk_gl_fence_delete_orphans (data);
+
+      glfence->sync = data->procs.FenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+  if (glfence->sync != NULL)
+    {
+      glFlush ();
+    }
+  else
+    {
+      glFinish ();
+      glfence->signaled = TRUE;
+    }
+
+  return glfence;
+}
+
+/**
+ * gdk_gl_fence_is_signaled:
+ * @glfence: a #GdkGLFence.
+ *
+ * Checks whether the commands before @glfence have completed, without
+ * waiting. Unless the fence is already known to be signaled, a context
+ * sharing objects with the one that created @glfence must be current.
+ *
+ * Return value: TRUE if the fence is signaled, FALSE otherwise.
+ **/
+gboolean
+gdk_gl_fence_is_signaled (GdkGLFence *glfence)
+{
+  g_return_val_if_fail (GDK_IS_GL_FENCE (glfence), FALSE);
+
+  if (g_atomic_int_get (&glfence->signaled))
+    return TRUE;
+
+  if (gdk_gl_context_get_current () == NULL)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- no current context, fence not checked"));
+      return FALSE;
+    }
+
+  return gdk_gl_fence_check_wait_result (glfence,
+                                         glfence->data->procs.ClientWaitSync (glfence->sync,
+                                                                              0, 0));
+}
+
+/**
+ * gdk_gl_fence_client_wait:
+ * @glfence: a #GdkGLFence.
+ * @timeout: the time to wait, in microseconds, or a negative value to
+ *           wait until the fence is signaled.
+ *
+ * Blocks the calling thread until @glfence is signaled or @timeout has
+ * passed. Unlike glFinish(), only the commands before the fence are
+ * waited for. A context sharing objects with the one that created
+ * @glfence must be current.
+ *
+ * Return value: TRUE if the fence is signaled, FALSE if the wait timed out.
+ **/
+gboolean
+gdk_gl_fence_client_wait (GdkGLFence *glfence,
+                          gint64      timeout)
+{
+  GdkGLFenceProcs *procs;
+  GLenum result;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_GL_FENCE (glfence), FALSE);
+
+  if (g_atomic_int_get (&glfence->signaled))
+    return TRUE;
+
+  g_return_val_if_fail (gdk_gl_context_get_current () != NULL, FALSE);
+
+  procs = &glfence->data->procs;
+
+  if (timeout >= 0)
+    {
+      result = procs->ClientWaitSync (glfence->sync, 0, (GLuint64) timeout * 1000);
+    }
+  else
+    {
+      do
+        result = procs->ClientWaitSync (glfence->sync, 0, GDK_GL_FENCE_WAIT_STEP);
+      while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+  return gdk_gl_fence_check_wait_result (glfence, result);
+}
+
+/**
+ * gdk_gl_fence_server_wait:
+ * @glfence: a #GdkGLFence.
+ *
+ * Makes the current context wait for @glfence before it executes any
+ * command issued after this call. The wait happens on the GPU, so the
+ * calling thread does not block; this is how a context consumes objects
+ * produced by another context in its share group. The current context
+ * must share objects with the one that created @glfence.
+ **/
+void
+gdk_gl_fence_server_wait (GdkGLFence *glfence)
+{
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_if_fail (GDK_IS_GL_FENCE (glfence));
+
+  if (g_atomic_int_get (&glfence->signaled))
+    return;
+
+  g_return_if_fail (gdk_gl_context_get_current () != NULL);
+
+  glfence->data->procs.WaitSync (glfence->sync, 0, GL_TIMEOUT_IGNORED);
+}
+
+/**
+ * gdk_gl_fence_get_gl_context:
+ * @glfence: a #GdkGLFence.
+ *
+ * Gets the #GdkGLContext that @glfence was created in.
+ *
+ * Return value: the #GdkGLContext.
+ **/
+GdkGLContext *
+gdk_gl_fence_get_gl_context (GdkGLFence *glfence)
+{
+  g_return_val_if_fail (GDK_IS_GL_FENCE (glfence), NULL);
+
+  return glfence->glcontext;
+}
+
+/*
+ * Fence source.
+ *
+ * Fences can only be checked with a context of their share group
+ * current, which the main loop thread cannot count on. Each source
+ * therefore owns a watcher thread with a worker context in the share
+ * group. The thread blocks in glClientWaitSync() on the oldest pending
+ * fence, moves the signaled ones to the ready queue and wakes up the
+ * main context, which then dispatches them. With nothing pending it
+ * sleeps on the incoming queue, so an idle source costs no wakeups.
+ *
+ * A wait in glClientWaitSync() cannot be interrupted, so fences queued
+ * meanwhile, and the quit request, are picked up once the oldest fence
+ * is signaled. Fences of a share group complete in about the order they
+ * were issued, so this seldom delays a newer one.
+ */
+
+typedef struct
+{
+  GdkGLFence *glfence;
+  GdkGLFenceFunc func;
+  gpointer user_data;
+  GDestroyNotify notify;
+
+  /* call func from the watcher thread, with its context current */
+  gboolean in_thread;
+} GdkGLFenceWatch;
+
+/*
+ * State shared by a source and its watcher thread. It belongs to the
+ * thread, which frees it on exit, so that the source can even be
+ * dropped from a function running in the thread.
+ */
+typedef struct
+{
+  GThread *thread;
+  GdkGLContext *glcontext;
+
+  /* watches for the thread; a watch without a fence makes it quit */
+  GAsyncQueue *incoming;
+
+  /* protected by lock; main_context is NULL once the source is gone */
+  GMutex lock;
+  GQueue ready;
+  GMainContext *main_context;
+} GdkGLFenceWatcher;
+
+typedef struct
+{
+  GSource source;
+
+  GdkGLFenceWatcher *watcher;
+} GdkGLFenceSource;
+
+static void
+gdk_gl_fence_watch_free (GdkGLFenceWatch *watch)
+{
+  if (watch->notify != NULL)
+    watch->notify (watch->user_data);
+
+  if (watch->glfence != NULL)
+    g_object_unref (watch->glfence);
+
+  g_slice_free (GdkGLFenceWatch, watch);
+}
+
+static void
+gdk_gl_fence_watch_queue_free (GQueue *queue)
+{
+  GdkGLFenceWatch *watch;
+
+  while ((watch = g_queue_pop_head (queue)) != NULL)
+    gdk_gl_fence_watch_free (watch);
+}
+
+/*
+ * Hands signaled watches over to the main context. Called with the
+ * lock held.
+ */
+static void
+gdk_gl_fence_watcher_push_ready (GdkGLFenceWatcher *watcher,
+                                 GdkGLFenceWatch   *watch)
+{
+  g_queue_push_tail (&watcher->ready, watch);
+
+  if (watcher->main_context != NULL)
+    g_main_context_wakeup (watcher->main_context);
+}
+
+static gpointer
+gdk_gl_fence_watcher_thread_main (gpointer data)
+{
+  GdkGLFenceWatcher *watcher = data;
+  GQueue pending = G_QUEUE_INIT;
+  GQueue signaled = G_QUEUE_INIT;
+  GQueue ready;
+  GdkGLFenceWatch *watch;
+  GList *l, *next;
+  gboolean is_current;
+  gboolean quit = FALSE;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  /* Without a current context fences cannot be checked; they are then
+     handed over at once, like fences without sync object support. */
+  is_current = gdk_gl_context_make_current (watcher->glcontext, NULL, NULL);
+  if (!is_current)
+    g_warning ("cannot make the fence watcher context current");
+
+  while (!quit)
+    {
+      /* Sleep until there is something to watch; otherwise only pick
+         up what was queued during the last wait. */
+      if (g_queue_is_empty (&pending))
+        watch = g_async_queue_pop (watcher->incoming);
+      else
+        watch = g_async_queue_try_pop (watcher->incoming);
+
+      for (; watch != NULL; watch = g_async_queue_try_pop (watcher->incoming))
+        {
+          if (watch->glfence == NULL)
+            {
+              g_slice_free (GdkGLFenceWatch, watch);
+              quit = TRUE;
+              break;
+            }
+
+          g_queue_push_tail (&pending, watch);
+        }
+
+      if (quit)
+        break;
+
+      watch = g_queue_peek_head (&pending);
+      if (is_current)
+        gdk_gl_fence_client_wait (watch->glfence, -1);
+
+      g_mutex_lock (&watcher->lock);
+
+      for (l = pending.head; l != NULL; l = next)
+        {
+          next = l->next;
+          watch = l->data;
+
+          if (!is_current || gdk_gl_fence_is_signaled (watch->glfence))
+            {
+              g_queue_delete_link (&pending, l);
+
+              if (watch->in_thread)
+                g_queue_push_tail (&signaled, watch);
+              else
+                gdk_gl_fence_watcher_push_ready (watcher, watch);
+            }
+        }
+
+      g_mutex_unlock (&watcher->lock);
+
+      /* This may drop the last reference on the source. */
+      while ((watch = g_queue_pop_head (&signaled)) != NULL)
+        {
+          watch->func (watch->glfence, watch->user_data);
+          gdk_gl_fence_watch_free (watch);
+        }
+    }
+
+  /* The source is gone; release what it did not dispatch. */
+  g_mutex_lock (&watcher->lock);
+  ready = watcher->ready;
+  g_queue_init (&watcher->ready);
+  g_mutex_unlock (&watcher->lock);
+
+  gdk_gl_fence_watch_queue_free (&ready);
+  gdk_gl_fence_watch_queue_free (&pending);
+
+  while ((watch = g_async_queue_try_pop (watcher->incoming)) != NULL)
+    gdk_gl_fence_watch_free (watch);
+  g_async_queue_unref (watcher->incoming);
+
+  g_mutex_clear (&watcher->lock);
+
+  /* Nothing but this thread used the worker context. Dropping it also
+     drops the worker's reference on the share list. */
+  g_object_unref (watcher->glcontext);
+  g_free (watcher);
+
+  return NULL;
+}
+
+static gboolean
+gdk_gl_fence_source_prepare (GSource *source,
+                             gint    *timeout)
+{
+  GdkGLFenceWatcher *watcher = ((GdkGLFenceSource *) source)->watcher;
+  gboolean is_ready;
+
+  *timeout = -1;
+
+  g_mutex_lock (&watcher->lock);
+
+  if (watcher->main_context == NULL)
+    watcher->main_context = g_main_context_ref (g_source_get_context (source));
+
+  is_ready = !g_queue_is_empty (&watcher->ready);
+
+  g_mutex_unlock (&watcher->lock);
+
+  return is_ready;
+}
+
+static gboolean
+gdk_gl_fence_source_check (GSource *source)
+{
+  GdkGLFenceWatcher *watcher = ((GdkGLFenceSource *) source)->watcher;
+  gboolean is_ready;
+
+  g_mutex_lock (&watcher->lock);
+  is_ready = !g_queue_is_empty (&watcher->ready);
+  g_mutex_unlock (&watcher->lock);
+
+  return is_ready;
+}
+
+static gboolean
+gdk_gl_fence_source_dispatch (GSource     *source,
+                              GSourceFunc  callback,
+                              gpointer     user_data)
+{
+  GdkGLFenceWatcher *watcher = ((GdkGLFenceSource *) source)->watcher;
+  GQueue ready;
+  GdkGLFenceWatch *watch;
+
+  g_mutex_lock (&watcher->lock);
+  ready = watcher->ready;
+  g_queue_init (&watcher->ready);
+  g_mutex_unlock (&watcher->lock);
+
+  while ((watch = g_queue_pop_head (&ready)) != NULL)
+    {
+      watch->func (watch->glfence, watch->user_data);
+      gdk_gl_fence_watch_free (watch);
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+gdk_gl_fence_source_finalize (GSource *source)
+{
+  GdkGLFenceWatcher *watcher = ((GdkGLFenceSource *) source)->watcher;
+  GThread *thread = watcher->thread;
+  GQueue ready;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  /* The watcher thread must not wake up the main context from now on. */
+  g_mutex_lock (&watcher->lock);
+  if (watcher->main_context != NULL)
+    {
+      g_main_context_unref (watcher->main_context);
+      watcher->main_context = NULL;
+    }
+  ready = watcher->ready;
+  g_queue_init (&watcher->ready);
+  g_mutex_unlock (&watcher->lock);
+
+  gdk_gl_fence_watch_queue_free (&ready);
+
+  /* The watcher frees itself once it sees the quit request. */
+  g_async_queue_push (watcher->incoming, g_slice_new0 (GdkGLFenceWatch));
+
+  if (thread == g_thread_self ())
+    g_thread_unref (thread);
+  else
+    g_thread_join (thread);
+}
+
+static GSourceFuncs gdk_gl_fence_source_funcs = {
+  gdk_gl_fence_source_prepare,
+  gdk_gl_fence_source_check,
+  gdk_gl_fence_source_dispatch,
+  gdk_gl_fence_source_finalize
+};
+
+/*
+ * Starts a watcher thread for glcontext, which it takes over.
+ */
+static GSource *
+gdk_gl_fence_source_new_common (GdkGLContext *glcontext)
+{
+  GSource *source;
+  GdkGLFenceWatcher *watcher;
+
+  if (glcontext == NULL)
+    return NULL;
+
+  watcher = g_new0 (GdkGLFenceWatcher, 1);
+  watcher->glcontext = glcontext;
+  watcher->incoming = g_async_queue_new ();
+  g_mutex_init (&watcher->lock);
+  g_queue_init (&watcher->ready);
+  watcher->main_context = NULL;
+
+  source = g_source_new (&gdk_gl_fence_source_funcs, sizeof (GdkGLFenceSource));
+  g_source_set_name (source, "GdkGLFenceSource");
+  ((GdkGLFenceSource *) source)->watcher = watcher;
+
+  watcher->thread = g_thread_new ("gdkglext-fence-watcher",
+                                  gdk_gl_fence_watcher_thread_main,
+                                  watcher);
+
+  return source;
+}
+
+/**
+ * gdk_gl_fence_source_new:
+ * @share_list: a #GdkGLContext in the share group of the fences to watch.
+ *
+ * Creates a #GSource that calls a function in its main context once a
+ * fence is signaled. Fences are added with gdk_gl_fence_source_add();
+ * they must be created in contexts that share objects with @share_list.
+ * Attach the source with g_source_attach().
+ *
+ * Fences are waited for in a thread of the source with its own worker
+ * context (see gdk_gl_context_new_worker()), so the main loop neither
+ * blocks nor polls. Upload completions, readbacks and frame retirement
+ * can thus be handled without calling gdk_gl_drawable_wait_gl() or
+ * glFinish() from the main loop. The worker context keeps @share_list
+ * alive until the source is destroyed.
+ *
+ * The callback set with g_source_set_callback() is not used. Dropping
+ * the last reference on the source blocks until the fence its thread is
+ * waiting for, if any, is signaled.
+ *
+ * Return value: the new #GSource, or NULL if the worker context cannot
+ *               be created.
+ **/
+GSource *
+gdk_gl_fence_source_new (GdkGLContext *share_list)
+{
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_GL_CONTEXT (share_list), NULL);
+
+  return gdk_gl_fence_source_new_common (gdk_gl_context_new_worker (share_list));
+}
+
+/*
+ * Like gdk_gl_fence_source_new(), but the source does not keep
+ * share_list alive, so that share_list can own it. The source must be
+ * destroyed before share_list is disposed of.
+ */
+GSource *
+_gdk_gl_fence_source_new_owned (GdkGLContext *share_list)
+{
+  g_return_val_if_fail (GDK_IS_GL_CONTEXT (share_list), NULL);
+
+  return gdk_gl_fence_source_new_common (_gdk_gl_context_new_owned_worker (share_list));
+}
+
+static void
+gdk_gl_fence_source_add_watch (GSource        *source,
+                               GdkGLFence     *glfence,
+                               GdkGLFenceFunc  func,
+                               gpointer        user_data,
+                               GDestroyNotify  notify,
+                               gboolean        in_thread)
+{
+  GdkGLFenceWatcher *watcher = ((GdkGLFenceSource *) source)->watcher;
+  GdkGLFenceWatch *watch;
+
+  watch = g_slice_new (GdkGLFenceWatch);
+  watch->glfence = g_object_ref (glfence);
+  watch->func = func;
+  watch->user_data = user_data;
+  watch->notify = notify;
+  watch->in_thread = in_thread;
+
+  /* Fences that are known to be signaled skip the watcher thread,
+     unless the function has to run there. */
+  if (!in_thread && g_atomic_int_get (&glfence->signaled))
+    {
+      g_mutex_lock (&watcher->lock);
+      gdk_gl_fence_watcher_push_ready (watcher, watch);
+      g_mutex_unlock (&watcher->lock);
+    }
+  else
+    {
+      g_async_queue_push (watcher->incoming, watch);
+    }
+}
+
+/**
+ * gdk_gl_fence_source_add:
+ * @source: a #GSource created with gdk_gl_fence_source_new().
+ * @glfence: the #GdkGLFence to watch.
+ * @func: function to call once @glfence is signaled.
+ * @user_data: data to pass to @func.
+ * @notify: (allow-none): function to call when @user_data is no longer
+ *          used, or NULL.
+ *
+ * Calls @func from the main context of @source once @glfence is
+ * signaled. @source holds a reference on @glfence until then. If
+ * @source is destroyed first, @func is not called but @notify is, from
+ * the source's watcher thread if @glfence was still pending.
+ **/
+void
+gdk_gl_fence_source_add (GSource        *source,
+                         GdkGLFence     *glfence,
+                         GdkGLFenceFunc  func,
+                         gpointer        user_data,
+                         GDestroyNotify  notify)
+{
+  g_return_if_fail (source != NULL);
+  g_return_if_fail (source->source_funcs == &gdk_gl_fence_source_funcs);
+  g_return_if_fail (GDK_IS_GL_FENCE (glfence));
+  g_return_if_fail (func != NULL);
+
+  gdk_gl_fence_source_add_watch (source, glfence, func, user_data, notify, FALSE);
+}
+
+/*
+ * Like gdk_gl_fence_source_add(), but calls func from the watcher thread
+ * with the source's worker context current, or no context if it could
+ * not be made current. The source does not need to be attached. notify
+ * is called from the watcher thread as well, or from the thread that
+ * drops the source.
+ */
+void
+_gdk_gl_fence_source_add_in_thread (GSource        *source,
+                                    GdkGLFence     *glfence,
+                                    GdkGLFenceFunc  func,
+                                    gpointer        user_data,
+                                    GDestroyNotify  notify)
+{
+  g_return_if_fail (source != NULL);
+  g_return_if_fail (source->source_funcs == &gdk_gl_fence_source_funcs);
+  g_return_if_fail (GDK_IS_GL_FENCE (glfence));
+  g_return_if_fail (func != NULL);
+
+  gdk_gl_fence_source_add_watch (source, glfence, func, user_data, notify, TRUE);
+}
@@ -0,0 +1,79 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#if !defined (__GDKGL_H_INSIDE__) && !defined (GDK_GL_COMPILATION)
+#error "Only <gdk/gdkgl.h> can be included directly."
+#endif
+
+#ifndef __GDK_GL_FENCE_H__
+#define __GDK_GL_FENCE_H__
+
+#include <gdk/gdkgldefs.h>
+#include <gdk/gdkgltypes.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkGLFenceClass GdkGLFenceClass;
+
+#define GDK_TYPE_GL_FENCE              (gdk_gl_fence_get_type ())
+#define GDK_GL_FENCE(object)           (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_FENCE, GdkGLFence))
+#define GDK_GL_FENCE_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_FENCE, GdkGLFenceClass))
+#define GDK_IS_GL_FENCE(object)        (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_FENCE))
+#define GDK_IS_GL_FENCE_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_FENCE))
+#define GDK_GL_FENCE_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_FENCE, GdkGLFenceClass))
+
+struct _GdkGLFenceClass
+{
+  GObjectClass parent_class;
+};
+
+/**
+ * GdkGLFenceFunc:
+ * @glfence: the #GdkGLFence, which is signaled.
+ * @user_data: the data passed to gdk_gl_fence_source_add().
+ *
+ * Called from the main context of a fence source once a fence is
+ * signaled.
+ */
+typedef void (*GdkGLFenceFunc) (GdkGLFence *glfence,
+                                gpointer    user_data);
+
+GType         gdk_gl_fence_get_type       (void);
+
+GdkGLFence   *gdk_gl_fence_new            (void);
+
+gboolean      gdk_gl_fence_is_signaled    (GdkGLFence *glfence);
+
+gboolean      gdk_gl_fence_client_wait    (GdkGLFence *glfence,
+                                           gint64      timeout);
+
+void          gdk_gl_fence_server_wait    (GdkGLFence *glfence);
+
+GdkGLContext *gdk_gl_fence_get_gl_context (GdkGLFence *glfence);
+
+GSource      *gdk_gl_fence_source_new     (GdkGLContext   *share_list);
+
+void          gdk_gl_fence_source_add     (GSource        *source,
+                                           GdkGLFence     *glfence,
+                                           GdkGLFenceFunc  func,
+                                           gpointer        user_data,
+                                           GDestroyNotify  notify);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_FENCE_H__ */
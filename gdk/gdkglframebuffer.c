@@ -0,0 +1,708 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdlib.h>
+
+#include "gdkglprivate.h"
+#include "gdkglquery.h"
+#include "gdkglconfig.h"
+#include "gdkglcontext.h"
+#include "gdkglcontextimpl.h"
+#include "gdkglframebuffer.h"
+
+#ifdef G_OS_WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#endif
+
+#ifdef GDK_WINDOWING_QUARTZ
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+/* OpenGL 3.0, GL_ARB_framebuffer_object and GL_EXT_framebuffer_object
+   share these values. */
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER                    0x8D40
+#define GL_RENDERBUFFER                   0x8D41
+#define GL_FRAMEBUFFER_BINDING            0x8CA6
+#define GL_RENDERBUFFER_BINDING           0x8CA7
+#define GL_FRAMEBUFFER_COMPLETE           0x8CD5
+#define GL_COLOR_ATTACHMENT0              0x8CE0
+#define GL_DEPTH_ATTACHMENT               0x8D00
+#define GL_STENCIL_ATTACHMENT             0x8D20
+#endif
+#ifndef GL_READ_FRAMEBUFFER
+#define GL_READ_FRAMEBUFFER               0x8CA8
+#define GL_DRAW_FRAMEBUFFER               0x8CA9
+#endif
+#ifndef GL_DEPTH24_STENCIL8
+#define GL_DEPTH24_STENCIL8               0x88F0
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24              0x81A6
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE                  0x812F
+#endif
+
+typedef struct
+{
+  void   (APIENTRY *GenFramebuffers)         (GLsizei n, GLuint *framebuffers);
+  void   (APIENTRY *DeleteFramebuffers)      (GLsizei n, const GLuint *framebuffers);
+  void   (APIENTRY *BindFramebuffer)         (GLenum target, GLuint framebuffer);
+  GLenum (APIENTRY *CheckFramebufferStatus)  (GLenum target);
+  void   (APIENTRY *FramebufferTexture2D)    (GLenum target, GLenum attachment,
+                                              GLenum textarget, GLuint texture,
+                                              GLint level);
+  void   (APIENTRY *FramebufferRenderbuffer) (GLenum target, GLenum attachment,
+                                              GLenum renderbuffertarget,
+                                              GLuint renderbuffer);
+  void   (APIENTRY *GenRenderbuffers)        (GLsizei n, GLuint *renderbuffers);
+  void   (APIENTRY *DeleteRenderbuffers)     (GLsizei n, const GLuint *renderbuffers);
+  void   (APIENTRY *BindRenderbuffer)        (GLenum target, GLuint renderbuffer);
+  void   (APIENTRY *RenderbufferStorage)     (GLenum target, GLenum internalformat,
+                                              GLsizei width, GLsizei height);
+} GdkGLFramebufferProcs;
+
+struct _GdkGLFramebuffer
+{
+  GObject parent_instance;
+
+  GdkGLContext *glcontext;
+
+  /* entry points are looked up in glcontext, where they are valid */
+  GdkGLFramebufferProcs procs;
+
+  GdkGLFramebufferAttachments attachments;
+  GLenum color_format;
+
+  GLuint fbo;
+  GLuint color_texture;
+  GLuint depth_stencil_renderbuffer;
+
+  /* size rendered to, and size of the storage behind it */
+  int width;
+  int height;
+  int alloc_width;
+  int alloc_height;
+};
+
+static GdkGLContext *_gdk_gl_framebuffer_create_gl_context   (GdkGLDrawable *gldrawable,
+                                                              GdkGLContext  *share_list,
+                                                              gboolean       direct,
+                                                              int            render_type);
+static gboolean      _gdk_gl_framebuffer_is_double_buffered  (GdkGLDrawable *gldrawable);
+static void          _gdk_gl_framebuffer_swap_buffers        (GdkGLDrawable *gldrawable);
+static void          _gdk_gl_framebuffer_wait_gl             (GdkGLDrawable *gldrawable);
+static void          _gdk_gl_framebuffer_wait_gdk            (GdkGLDrawable *gldrawable);
+static GdkGLConfig  *_gdk_gl_framebuffer_get_gl_config       (GdkGLDrawable *gldrawable);
+
+static void gdk_gl_framebuffer_gl_drawable_interface_init (GdkGLDrawableClass *iface);
+
+G_DEFINE_TYPE_EXTENDED  (GdkGLFramebuffer,
+                         gdk_gl_framebuffer,
+                         G_TYPE_OBJECT,
+                         0,
+                         G_IMPLEMENT_INTERFACE (
+                          GDK_TYPE_GL_DRAWABLE,
+                          gdk_gl_framebuffer_gl_drawable_interface_init))
+
+/* The framebuffer a context last bound, so that binding a window or
+   pbuffer afterwards can unbind it again. */
+static const gchar quark_bound_framebuffer_string[] = "gdk-gl-context-bound-framebuffer";
+static GQuark quark_bound_framebuffer = 0;
+
+static void
+gdk_gl_framebuffer_init (GdkGLFramebuffer *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  self->glcontext = NULL;
+  self->attachments = 0;
+  self->color_format = GL_RGBA8;
+  self->fbo = 0;
+  self->color_texture = 0;
+  self->depth_stencil_renderbuffer = 0;
+  self->width = 0;
+  self->height = 0;
+  self->alloc_width = 0;
+  self->alloc_height = 0;
+}
+
+static void
+gdk_gl_framebuffer_finalize (GObject *object)
+{
+  GdkGLFramebuffer *glframebuffer = GDK_GL_FRAMEBUFFER (object);
+  GdkGLFramebufferProcs *procs = &glframebuffer->procs;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (glframebuffer->glcontext != NULL)
+    {
+      if (g_object_get_qdata (G_OBJECT (glframebuffer->glcontext),
+                              quark_bound_framebuffer) == glframebuffer)
+        g_object_set_qdata (G_OBJECT (glframebuffer->glcontext),
+                            quark_bound_framebuffer, NULL);
+
+      /* GL objects can only be deleted through a current context;
+         otherwise they live as long as the share group does. */
+      if (gdk_gl_context_get_current () == glframebuffer->glcontext)
+        {
+          if (glframebuffer->fbo != 0)
+            procs->DeleteFramebuffers (1, &glframebuffer->fbo);
+          if (glframebuffer->depth_stencil_renderbuffer != 0)
+            procs->DeleteRenderbuffers (1, &glframebuffer->depth_stencil_renderbuffer);
+          if (glframebuffer->color_texture != 0)
+            glDeleteTextures (1, &glframebuffer->color_texture);
+        }
+      else
+        {
+          GDK_GL_NOTE (MISC,
+            g_message (" -- context not current, framebuffer objects not deleted"));
+        }
+
+      g_object_unref (G_OBJECT (glframebuffer->glcontext));
+      glframebuffer->glcontext = NULL;
+    }
+
+  G_OBJECT_CLASS (gdk_gl_framebuffer_parent_class)->finalize (object);
+}
+
+static void
+gdk_gl_framebuffer_class_init (GdkGLFramebufferClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  quark_bound_framebuffer = g_quark_from_static_string (quark_bound_framebuffer_string);
+
+  object_class->finalize = gdk_gl_framebuffer_finalize;
+}
+
+static void
+gdk_gl_framebuffer_gl_drawable_interface_init (GdkGLDrawableClass *iface)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  iface->create_gl_context      = _gdk_gl_framebuffer_create_gl_context;
+  iface->create_gl_context_full = NULL;
+  iface->is_double_buffered     = _gdk_gl_framebuffer_is_double_buffered;
+  iface->swap_buffers           = _gdk_gl_framebuffer_swap_buffers;
+  iface->wait_gl                = _gdk_gl_framebuffer_wait_gl;
+  iface->wait_gdk               = _gdk_gl_framebuffer_wait_gdk;
+  iface->get_gl_config          = _gdk_gl_framebuffer_get_gl_config;
+}
+
+static GdkGLContext *
+_gdk_gl_framebuffer_create_gl_context (GdkGLDrawable *gldrawable,
+                                       GdkGLContext  *share_list,
+                                       gboolean       direct,
+                                       int            render_type)
+{
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (gldrawable), NULL);
+
+  /* Framebuffer objects are not shared between contexts. */
+  g_warning ("a framebuffer is rendered with the context it was created with");
+
+  return NULL;
+}
+
+static gboolean
+_gdk_gl_framebuffer_is_double_buffered (GdkGLDrawable *gldrawable)
+{
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (gldrawable), FALSE);
+
+  return FALSE;
+}
+
+static void
+_gdk_gl_framebuffer_swap_buffers (GdkGLDrawable *gldrawable)
+{
+  g_return_if_fail (GDK_IS_GL_FRAMEBUFFER (gldrawable));
+
+  /* There is nothing to swap; flushing lets other contexts in the
+     share group see the color texture. */
+  if (gdk_gl_context_get_current () == GDK_GL_FRAMEBUFFER (gldrawable)->glcontext)
+    glFlush ();
+}
+
+static void
+_gdk_gl_framebuffer_wait_gl (GdkGLDrawable *gldrawable)
+{
+  g_return_if_fail (GDK_IS_GL_FRAMEBUFFER (gldrawable));
+
+  if (gdk_gl_context_get_current () == GDK_GL_FRAMEBUFFER (gldrawable)->glcontext)
+    glFinish ();
+}
+
+static void
+_gdk_gl_framebuffer_wait_gdk (GdkGLDrawable *gldrawable)
+{
+  g_return_if_fail (GDK_IS_GL_FRAMEBUFFER (gldrawable));
+
+  /* GDK never draws into a framebuffer object. */
+}
+
+static GdkGLConfig *
+_gdk_gl_framebuffer_get_gl_config (GdkGLDrawable *gldrawable)
+{
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (gldrawable), NULL);
+
+  return gdk_gl_context_get_gl_config (GDK_GL_FRAMEBUFFER (gldrawable)->glcontext);
+}
+
+static GdkGLProc
+gdk_gl_framebuffer_get_proc (const char *name,
+                             const char *suffix)
+{
+  GdkGLProc proc;
+  gchar *full_name;
+
+  full_name = g_strconcat (name, suffix, NULL);
+  proc = gdk_gl_get_proc_address (full_name);
+  g_free (full_name);
+
+  return proc;
+}
+
+/*
+ * Looks the entry points up in the current context. OpenGL 3.0 and
+ * GL_ARB_framebuffer_object use the same names; GL_EXT_framebuffer_object
+ * needs GL_EXT_packed_depth_stencil as well for stencil attachments.
+ */
+static gboolean
+gdk_gl_framebuffer_load_procs (GdkGLFramebufferProcs       *procs,
+                               GdkGLFramebufferAttachments  attachments)
+{
+  const char *version;
+  const char *suffix;
+
+  version = (const char *) glGetString (GL_VERSION);
+  if (version == NULL)
+    return FALSE;
+
+  if (atoi (version) >= 3 ||
+      gdk_gl_query_gl_extension ("GL_ARB_framebuffer_object"))
+    {
+      suffix = "";
+    }
+  else if (gdk_gl_query_gl_extension ("GL_EXT_framebuffer_object") &&
+           (!(attachments & GDK_GL_FRAMEBUFFER_STENCIL_BIT) ||
+            gdk_gl_query_gl_extension ("GL_EXT_packed_depth_stencil")))
+    {
+      suffix = "EXT";
+    }
+  else
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Framebuffer objects not supported"));
+      return FALSE;
+    }
+
+#define LOAD_PROC(name)                                                 \
+  if ((procs->name = (gpointer) gdk_gl_framebuffer_get_proc ("gl" #name, suffix)) == NULL) \
+    return FALSE
+
+  LOAD_PROC (GenFramebuffers);
+  LOAD_PROC (DeleteFramebuffers);
+  LOAD_PROC (BindFramebuffer);
+  LOAD_PROC (CheckFramebufferStatus);
+  LOAD_PROC (FramebufferTexture2D);
+  LOAD_PROC (FramebufferRenderbuffer);
+  LOAD_PROC (GenRenderbuffers);
+  LOAD_PROC (DeleteRenderbuffers);
+  LOAD_PROC (BindRenderbuffer);
+  LOAD_PROC (RenderbufferStorage);
+
+#undef LOAD_PROC
+
+  return TRUE;
+}
+
+/*
+ * (Re)allocates the attachment storage. Attachments keep referring to
+ * the same objects, so the framebuffer does not need to be rebuilt.
+ */
+static gboolean
+gdk_gl_framebuffer_allocate (GdkGLFramebuffer *glframebuffer,
+                             int               width,
+                             int               height)
+{
+  GdkGLFramebufferProcs *procs = &glframebuffer->procs;
+  GLint texture_binding, renderbuffer_binding, framebuffer_binding;
+  GLenum status;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  glGetIntegerv (GL_TEXTURE_BINDING_2D, &texture_binding);
+  glGetIntegerv (GL_RENDERBUFFER_BINDING, &renderbuffer_binding);
+  glGetIntegerv (GL_FRAMEBUFFER_BINDING, &framebuffer_binding);
+
+  if (glframebuffer->color_texture != 0)
+    {
+      glBindTexture (GL_TEXTURE_2D, glframebuffer->color_texture);
+      glTexImage2D (GL_TEXTURE_2D, 0, glframebuffer->color_format,
+                    width, height, 0,
+                    GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+
+  if (glframebuffer->depth_stencil_renderbuffer != 0)
+    {
+      procs->BindRenderbuffer (GL_RENDERBUFFER, glframebuffer->depth_stencil_renderbuffer);
+      procs->RenderbufferStorage (GL_RENDERBUFFER,
+                                  (glframebuffer->attachments & GDK_GL_FRAMEBUFFER_STENCIL_BIT) ?
+                                  GL_DEPTH24_STENCIL8 : GL_DEPTH_COMPONENT24,
+                                  width, height);
+    }
+
+  procs->BindFramebuffer (GL_FRAMEBUFFER, glframebuffer->fbo);
+  status = procs->CheckFramebufferStatus (GL_FRAMEBUFFER);
+
+  glBindTexture (GL_TEXTURE_2D, texture_binding);
+  procs->BindRenderbuffer (GL_RENDERBUFFER, renderbuffer_binding);
+  procs->BindFramebuffer (GL_FRAMEBUFFER, framebuffer_binding);
+
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Framebuffer incomplete: 0x%x", status));
+      return FALSE;
+    }
+
+  glframebuffer->alloc_width = width;
+  glframebuffer->alloc_height = height;
+
+  return TRUE;
+}
+
+/**
+ * gdk_gl_framebuffer_new:
+ * @glcontext: the #GdkGLContext to render with, which must be current.
+ * @width: the width in pixels.
+ * @height: the height in pixels.
+ * @attachments: the buffers to attach, a combination of
+ *               #GdkGLFramebufferAttachments.
+ * @color_format: the internal format of the color texture, such as
+ *                GL_RGBA8, or 0 for GL_RGBA8.
+ *
+ * Creates an off-screen rendering area backed by a framebuffer object.
+ * The color buffer is a texture, see gdk_gl_framebuffer_get_texture();
+ * depth and stencil buffers are renderbuffers.
+ *
+ * A framebuffer object belongs to the context it was created in, so
+ * the framebuffer is made current with gdk_gl_context_make_current()
+ * and @glcontext only. If @glcontext is not current at that time, it is
+ * first bound to the drawable it was last bound to, or to the hidden
+ * drawable of an offscreen or worker context.
+ *
+ * Requires OpenGL 3.0, GL_ARB_framebuffer_object or
+ * GL_EXT_framebuffer_object.
+ *
+ * Return value: the new #GdkGLFramebuffer, or NULL if framebuffer objects
+ *               are not supported or the attachments are not renderable.
+ **/
+GdkGLFramebuffer *
+gdk_gl_framebuffer_new (GdkGLContext                *glcontext,
+                        int                          width,
+                        int                          height,
+                        GdkGLFramebufferAttachments  attachments,
+                        unsigned int                 color_format)
+{
+  GdkGLFramebuffer *glframebuffer;
+  GdkGLFramebufferProcs *procs;
+  GLint texture_binding, framebuffer_binding;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_GL_CONTEXT (glcontext), NULL);
+  g_return_val_if_fail (gdk_gl_context_get_current () == glcontext, NULL);
+  g_return_val_if_fail (width > 0 && height > 0, NULL);
+
+  glframebuffer = g_object_new (GDK_TYPE_GL_FRAMEBUFFER, NULL);
+  procs = &glframebuffer->procs;
+
+  if (!gdk_gl_framebuffer_load_procs (procs, attachments))
+    {
+      g_object_unref (glframebuffer);
+      return NULL;
+    }
+
+  glframebuffer->glcontext = glcontext;
+  g_object_ref (G_OBJECT (glframebuffer->glcontext));
+
+  glframebuffer->attachments = attachments;
+  if (color_format != 0)
+    glframebuffer->color_format = color_format;
+
+  glGetIntegerv (GL_TEXTURE_BINDING_2D, &texture_binding);
+  glGetIntegerv (GL_FRAMEBUFFER_BINDING, &framebuffer_binding);
+
+  procs->GenFramebuffers (1, &glframebuffer->fbo);
+  procs->BindFramebuffer (GL_FRAMEBUFFER, glframebuffer->fbo);
+
+  if (attachments & GDK_GL_FRAMEBUFFER_COLOR_BIT)
+    {
+      glGenTextures (1, &glframebuffer->color_texture);
+      glBindTexture (GL_TEXTURE_2D, glframebuffer->color_texture);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glBindTexture (GL_TEXTURE_2D, texture_binding);
+
+      procs->FramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                   GL_TEXTURE_2D, glframebuffer->color_texture, 0);
+    }
+  else
+    {
+      glDrawBuffer (GL_NONE);
+      glReadBuffer (GL_NONE);
+    }
+
+  if (attachments & (GDK_GL_FRAMEBUFFER_DEPTH_BIT | GDK_GL_FRAMEBUFFER_STENCIL_BIT))
+    {
+      /* Stencil-only renderbuffers are poorly supported, so stencil
+         always comes packed with depth. */
+      procs->GenRenderbuffers (1, &glframebuffer->depth_stencil_renderbuffer);
+
+      if (attachments & GDK_GL_FRAMEBUFFER_DEPTH_BIT)
+        procs->FramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                        GL_RENDERBUFFER,
+                                        glframebuffer->depth_stencil_renderbuffer);
+
+      if (attachments & GDK_GL_FRAMEBUFFER_STENCIL_BIT)
+        procs->FramebufferRenderbuffer (GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                                        GL_RENDERBUFFER,
+                                        glframebuffer->depth_stencil_renderbuffer);
+    }
+
+  procs->BindFramebuffer (GL_FRAMEBUFFER, framebuffer_binding);
+
+  if (!gdk_gl_framebuffer_allocate (glframebuffer, width, height))
+    {
+      g_object_unref (glframebuffer);
+      return NULL;
+    }
+
+  glframebuffer->width = width;
+  glframebuffer->height = height;
+
+  return glframebuffer;
+}
+
+/**
+ * gdk_gl_framebuffer_resize:
+ * @glframebuffer: a #GdkGLFramebuffer.
+ * @width: the new width in pixels.
+ * @height: the new height in pixels.
+ *
+ * Changes the size rendered to. Storage is only reallocated when the
+ * framebuffer grows beyond its current storage; shrinking, or growing
+ * back within it, only changes the size reported by
+ * gdk_gl_framebuffer_get_size(), so set the viewport from that. The
+ * framebuffer's context must be current.
+ *
+ * Return value: TRUE if it is successful, FALSE otherwise.
+ **/
+gboolean
+gdk_gl_framebuffer_resize (GdkGLFramebuffer *glframebuffer,
+                           int               width,
+                           int               height)
+{
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (glframebuffer), FALSE);
+  g_return_val_if_fail (gdk_gl_context_get_current () == glframebuffer->glcontext, FALSE);
+  g_return_val_if_fail (width > 0 && height > 0, FALSE);
+
+  if (width > glframebuffer->alloc_width ||
+      height > glframebuffer->alloc_height)
+    {
+      /* Never shrink a dimension here, so that growing one side while
+         shrinking the other does not reallocate every time. */
+      if (!gdk_gl_framebuffer_allocate (glframebuffer,
+                                        MAX (width, glframebuffer->alloc_width),
+                                        MAX (height, glframebuffer->alloc_height)))
+        return FALSE;
+    }
+
+  glframebuffer->width = width;
+  glframebuffer->height = height;
+
+  return TRUE;
+}
+
+/**
+ * gdk_gl_framebuffer_get_size:
+ * @glframebuffer: a #GdkGLFramebuffer.
+ * @width: (out) (allow-none): return location for the width, or NULL.
+ * @height: (out) (allow-none): return location for the height, or NULL.
+ *
+ * Gets the size rendered to, as last set by gdk_gl_framebuffer_new() or
+ * gdk_gl_framebuffer_resize().
+ **/
+void
+gdk_gl_framebuffer_get_size (GdkGLFramebuffer *glframebuffer,
+                             int              *width,
+                             int              *height)
+{
+  g_return_if_fail (GDK_IS_GL_FRAMEBUFFER (glframebuffer));
+
+  if (width != NULL)
+    *width = glframebuffer->width;
+
+  if (height != NULL)
+    *height = glframebuffer->height;
+}
+
+/**
+ * gdk_gl_framebuffer_get_texture:
+ * @glframebuffer: a #GdkGLFramebuffer.
+ *
+ * Gets the GL_TEXTURE_2D name of the color attachment. Texture names
+ * are shared, so any context in the share group of the framebuffer's
+ * context can sample it once the rendering has been flushed with
+ * gdk_gl_drawable_swap_buffers(). The rendered image covers the
+ * lower-left gdk_gl_framebuffer_get_size() pixels of a texture of
+ * gdk_gl_framebuffer_get_texture_size().
+ *
+ * Return value: the texture name, or 0 if there is no color attachment.
+ **/
+unsigned int
+gdk_gl_framebuffer_get_texture (GdkGLFramebuffer *glframebuffer)
+{
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (glframebuffer), 0);
+
+  return glframebuffer->color_texture;
+}
+
+/**
+ * gdk_gl_framebuffer_get_texture_size:
+ * @glframebuffer: a #GdkGLFramebuffer.
+ * @width: (out) (allow-none): return location for the width, or NULL.
+ * @height: (out) (allow-none): return location for the height, or NULL.
+ *
+ * Gets the size of the storage behind the attachments, which is at least
+ * the size rendered to. Use it to scale texture coordinates.
+ **/
+void
+gdk_gl_framebuffer_get_texture_size (GdkGLFramebuffer *glframebuffer,
+                                     int              *width,
+                                     int              *height)
+{
+  g_return_if_fail (GDK_IS_GL_FRAMEBUFFER (glframebuffer));
+
+  if (width != NULL)
+    *width = glframebuffer->alloc_width;
+
+  if (height != NULL)
+    *height = glframebuffer->alloc_height;
+}
+
+/**
+ * gdk_gl_framebuffer_get_gl_context:
+ * @glframebuffer: a #GdkGLFramebuffer.
+ *
+ * Gets the #GdkGLContext the framebuffer belongs to.
+ *
+ * Return value: the #GdkGLContext.
+ **/
+GdkGLContext *
+gdk_gl_framebuffer_get_gl_context (GdkGLFramebuffer *glframebuffer)
+{
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (glframebuffer), NULL);
+
+  return glframebuffer->glcontext;
+}
+
+/*< private >*/
+gboolean
+_gdk_gl_framebuffer_make_current (GdkGLContext  *glcontext,
+                                  GdkGLDrawable *draw,
+                                  GdkGLDrawable *read)
+{
+  GdkGLFramebuffer *draw_framebuffer;
+  GdkGLFramebuffer *read_framebuffer;
+  GdkGLDrawable *host;
+  GdkGLFramebufferProcs *procs;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (read == NULL)
+    read = draw;
+
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (draw), FALSE);
+  g_return_val_if_fail (GDK_IS_GL_FRAMEBUFFER (read), FALSE);
+
+  draw_framebuffer = GDK_GL_FRAMEBUFFER (draw);
+  read_framebuffer = GDK_GL_FRAMEBUFFER (read);
+
+  if (draw_framebuffer->glcontext != glcontext ||
+      read_framebuffer->glcontext != glcontext)
+    {
+      g_warning ("a framebuffer is rendered with the context it was created with");
+      return FALSE;
+    }
+
+  if (gdk_gl_context_get_current () != glcontext)
+    {
+      host = gdk_gl_context_get_gl_drawable (glcontext);
+
+      if (!GDK_GL_CONTEXT_IMPL_GET_CLASS (glcontext->impl)->make_current (glcontext,
+                                                                          host,
+                                                                          host))
+        return FALSE;
+    }
+
+  procs = &draw_framebuffer->procs;
+
+  if (read_framebuffer == draw_framebuffer)
+    {
+      procs->BindFramebuffer (GL_FRAMEBUFFER, draw_framebuffer->fbo);
+    }
+  else
+    {
+      procs->BindFramebuffer (GL_DRAW_FRAMEBUFFER, draw_framebuffer->fbo);
+      procs->BindFramebuffer (GL_READ_FRAMEBUFFER, read_framebuffer->fbo);
+    }
+
+  g_object_set_qdata (G_OBJECT (glcontext), quark_bound_framebuffer, draw_framebuffer);
+
+  return TRUE;
+}
+
+/*< private >*/
+void
+_gdk_gl_framebuffer_unbind (GdkGLContext *glcontext)
+{
+  GdkGLFramebuffer *glframebuffer;
+
+  if (quark_bound_framebuffer == 0)
+    return;
+
+  glframebuffer = g_object_get_qdata (G_OBJECT (glcontext), quark_bound_framebuffer);
+  if (glframebuffer == NULL)
+    return;
+
+  glframebuffer->procs.BindFramebuffer (GL_FRAMEBUFFER, 0);
+
+  g_object_set_qdata (G_OBJECT (glcontext), quark_bound_framebuffer, NULL);
+}
@@ -0,0 +1,81 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#if !defined (__GDKGL_H_INSIDE__) && !defined (GDK_GL_COMPILATION)
+#error "Only <gdk/gdkgl.h> can be included directly."
+#endif
+
+#ifndef __GDK_GL_FRAMEBUFFER_H__
+#define __GDK_GL_FRAMEBUFFER_H__
+
+#include <gdk/gdkgldefs.h>
+#include <gdk/gdkgltypes.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkGLFramebufferClass GdkGLFramebufferClass;
+
+#define GDK_TYPE_GL_FRAMEBUFFER              (gdk_gl_framebuffer_get_type ())
+#define GDK_GL_FRAMEBUFFER(object)           (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_FRAMEBUFFER, GdkGLFramebuffer))
+#define GDK_GL_FRAMEBUFFER_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_FRAMEBUFFER, GdkGLFramebufferClass))
+#define GDK_IS_GL_FRAMEBUFFER(object)        (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_FRAMEBUFFER))
+#define GDK_IS_GL_FRAMEBUFFER_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_FRAMEBUFFER))
+#define GDK_GL_FRAMEBUFFER_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_FRAMEBUFFER, GdkGLFramebufferClass))
+
+/*
+ * Framebuffer attachments.
+ */
+typedef enum
+{
+  GDK_GL_FRAMEBUFFER_COLOR_BIT      = 1 << 0, /* 0x00000001 */
+  GDK_GL_FRAMEBUFFER_DEPTH_BIT      = 1 << 1, /* 0x00000002 */
+  GDK_GL_FRAMEBUFFER_STENCIL_BIT    = 1 << 2  /* 0x00000004 */
+} GdkGLFramebufferAttachments;
+
+struct _GdkGLFramebufferClass
+{
+  GObjectClass parent_class;
+};
+
+GType              gdk_gl_framebuffer_get_type         (void);
+
+GdkGLFramebuffer  *gdk_gl_framebuffer_new              (GdkGLContext                *glcontext,
+                                                        int                          width,
+                                                        int                          height,
+                                                        GdkGLFramebufferAttachments  attachments,
+                                                        unsigned int                 color_format);
+
+gboolean           gdk_gl_framebuffer_resize           (GdkGLFramebuffer            *glframebuffer,
+                                                        int                          width,
+                                                        int                          height);
+
+void               gdk_gl_framebuffer_get_size         (GdkGLFramebuffer            *glframebuffer,
+                                                        int                         *width,
+                                                        int                         *height);
+
+unsigned int       gdk_gl_framebuffer_get_texture      (GdkGLFramebuffer            *glframebuffer);
+
+void               gdk_gl_framebuffer_get_texture_size (GdkGLFramebuffer            *glframebuffer,
+                                                        int                         *width,
+                                                        int                         *height);
+
+GdkGLContext      *gdk_gl_framebuffer_get_gl_context   (GdkGLFramebuffer            *glframebuffer);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_FRAMEBUFFER_H__ */
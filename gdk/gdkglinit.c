@@ -72,6 +72,27 @@ gdk_gl_parse_args (int    *argc,
       env_string = NULL;
     }
 
+  env_string = g_getenv ("GDK_GL_NO_ERROR");
+  if (env_string != NULL)
+    {
+      _gdk_gl_context_no_error = !!g_ascii_strtoll (env_string, NULL, 0);
+      env_string = NULL;
+    }
+
+  env_string = g_getenv ("GDK_GL_NO_CONFIG_CACHE");
+  if (env_string != NULL)
+    {
+      _gdk_gl_config_no_disk_cache = !!g_ascii_strtoll (env_string, NULL, 0);
+      env_string = NULL;
+    }
+
+  env_string = g_getenv ("GDK_GL_EGL");
+  if (env_string != NULL)
+    {
+      _gdk_gl_use_egl = !!g_ascii_strtoll (env_string, NULL, 0);
+      env_string = NULL;
+    }
+
 #ifdef G_ENABLE_DEBUG
   env_string = g_getenv ("GDK_GL_DEBUG");
   if (env_string != NULL)
@@ -94,6 +115,21 @@ gdk_gl_parse_args (int    *argc,
               _gdk_gl_context_force_indirect = TRUE;
               (*argv)[i] = NULL;
             }
+          else if (strcmp ("--gdk-gl-no-error", (*argv)[i]) == 0)
+            {
+              _gdk_gl_context_no_error = TRUE;
+              (*argv)[i] = NULL;
+            }
+          else if (strcmp ("--gdk-gl-no-config-cache", (*argv)[i]) == 0)
+            {
+              _gdk_gl_config_no_disk_cache = TRUE;
+              (*argv)[i] = NULL;
+            }
+          else if (strcmp ("--gdk-gl-egl", (*argv)[i]) == 0)
+            {
+              _gdk_gl_use_egl = TRUE;
+              (*argv)[i] = NULL;
+            }
 #ifdef G_ENABLE_DEBUG
           else if ((strcmp ("--gdk-gl-debug", (*argv)[i]) == 0) ||
                    (strncmp ("--gdk-gl-debug=", (*argv)[i], 15) == 0))
@@ -0,0 +1,299 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <gdk/gdk.h>
+
+#include "gdkglprivate.h"
+#include "gdkglconfig.h"
+#include "gdkglconfigimpl.h"
+#include "gdkglpbuffer.h"
+#include "gdkglpbufferimpl.h"
+
+static GdkGLContext *_gdk_gl_pbuffer_create_gl_context   (GdkGLDrawable *gldrawable,
+                                                          GdkGLContext  *share_list,
+                                                          gboolean       direct,
+                                                          int            render_type);
+static GdkGLContext *_gdk_gl_pbuffer_create_gl_context_full (GdkGLDrawable       *gldrawable,
+                                                             GdkGLContext        *share_list,
+                                                             gboolean             direct,
+                                                             int                  render_type,
+                                                             int                  major_version,
+                                                             int                  minor_version,
+                                                             GdkGLContextProfile  profile,
+                                                             GdkGLContextFlags    flags);
+static gboolean      _gdk_gl_pbuffer_is_double_buffered  (GdkGLDrawable *gldrawable);
+static void          _gdk_gl_pbuffer_swap_buffers        (GdkGLDrawable *gldrawable);
+static void          _gdk_gl_pbuffer_wait_gl             (GdkGLDrawable *gldrawable);
+static void          _gdk_gl_pbuffer_wait_gdk            (GdkGLDrawable *gldrawable);
+static GdkGLConfig  *_gdk_gl_pbuffer_get_gl_config       (GdkGLDrawable *gldrawable);
+
+static void gdk_gl_pbuffer_gl_drawable_interface_init (GdkGLDrawableClass *iface);
+
+G_DEFINE_TYPE_EXTENDED  (GdkGLPbuffer,
+                         gdk_gl_pbuffer,
+                         G_TYPE_OBJECT,
+                         0,
+                         G_IMPLEMENT_INTERFACE (
+                          GDK_TYPE_GL_DRAWABLE,
+                          gdk_gl_pbuffer_gl_drawable_interface_init))
+
+static void
+gdk_gl_pbuffer_init (GdkGLPbuffer *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  self->impl = NULL;
+  self->width = 0;
+  self->height = 0;
+}
+
+static void
+gdk_gl_pbuffer_finalize (GObject *object)
+{
+  GdkGLPbuffer *glpbuffer = GDK_GL_PBUFFER (object);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (glpbuffer->impl != NULL)
+    {
+      GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl)->destroy_gl_pbuffer_impl (glpbuffer);
+
+      g_object_unref (G_OBJECT (glpbuffer->impl));
+      glpbuffer->impl = NULL;
+    }
+
+  G_OBJECT_CLASS (gdk_gl_pbuffer_parent_class)->finalize (object);
+}
+
+static void
+gdk_gl_pbuffer_class_init (GdkGLPbufferClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  object_class->finalize = gdk_gl_pbuffer_finalize;
+}
+
+static void
+gdk_gl_pbuffer_gl_drawable_interface_init (GdkGLDrawableClass *iface)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  iface->create_gl_context      = _gdk_gl_pbuffer_create_gl_context;
+  iface->create_gl_context_full = _gdk_gl_pbuffer_create_gl_context_full;
+  iface->is_double_buffered     = _gdk_gl_pbuffer_is_double_buffered;
+  iface->swap_buffers           = _gdk_gl_pbuffer_swap_buffers;
+  iface->wait_gl                = _gdk_gl_pbuffer_wait_gl;
+  iface->wait_gdk               = _gdk_gl_pbuffer_wait_gdk;
+  iface->get_gl_config          = _gdk_gl_pbuffer_get_gl_config;
+}
+
+static GdkGLContext *
+_gdk_gl_pbuffer_create_gl_context (GdkGLDrawable *gldrawable,
+                                   GdkGLContext  *share_list,
+                                   gboolean       direct,
+                                   int            render_type)
+{
+  GdkGLPbuffer *glpbuffer;
+
+  g_return_val_if_fail (GDK_IS_GL_PBUFFER (gldrawable), NULL);
+
+  glpbuffer = GDK_GL_PBUFFER (gldrawable);
+
+  return GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl)->create_gl_context (glpbuffer,
+                                                                             share_list,
+                                                                             direct,
+                                                                             render_type);
+}
+
+static GdkGLContext *
+_gdk_gl_pbuffer_create_gl_context_full (GdkGLDrawable       *gldrawable,
+                                        GdkGLContext        *share_list,
+                                        gboolean             direct,
+                                        int                  render_type,
+                                        int                  major_version,
+                                        int                  minor_version,
+                                        GdkGLContextProfile  profile,
+                                        GdkGLContextFlags    flags)
+{
+  GdkGLPbuffer *glpbuffer;
+  GdkGLPbufferImplClass *impl_class;
+
+  g_return_val_if_fail (GDK_IS_GL_PBUFFER (gldrawable), NULL);
+
+  glpbuffer = GDK_GL_PBUFFER (gldrawable);
+  impl_class = GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl);
+
+  if (impl_class->create_gl_context_full == NULL)
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- backend cannot create versioned contexts, using a legacy one"));
+
+      return impl_class->create_gl_context (glpbuffer,
+                                            share_list,
+                                            direct,
+                                            render_type);
+    }
+
+  return impl_class->create_gl_context_full (glpbuffer,
+                                             share_list,
+                                             direct,
+                                             render_type,
+                                             major_version,
+                                             minor_version,
+                                             profile,
+                                             flags);
+}
+
+static gboolean
+_gdk_gl_pbuffer_is_double_buffered (GdkGLDrawable *gldrawable)
+{
+  GdkGLPbuffer *glpbuffer;
+
+  g_return_val_if_fail (GDK_IS_GL_PBUFFER (gldrawable), FALSE);
+
+  glpbuffer = GDK_GL_PBUFFER (gldrawable);
+
+  return GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl)->is_double_buffered (glpbuffer);
+}
+
+static void
+_gdk_gl_pbuffer_swap_buffers (GdkGLDrawable *gldrawable)
+{
+  GdkGLPbuffer *glpbuffer;
+
+  g_return_if_fail (GDK_IS_GL_PBUFFER (gldrawable));
+
+  glpbuffer = GDK_GL_PBUFFER (gldrawable);
+
+  GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl)->swap_buffers (glpbuffer);
+}
+
+static void
+_gdk_gl_pbuffer_wait_gl (GdkGLDrawable *gldrawable)
+{
+  GdkGLPbuffer *glpbuffer;
+
+  g_return_if_fail (GDK_IS_GL_PBUFFER (gldrawable));
+
+  glpbuffer = GDK_GL_PBUFFER (gldrawable);
+
+  GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl)->wait_gl (glpbuffer);
+}
+
+static void
+_gdk_gl_pbuffer_wait_gdk (GdkGLDrawable *gldrawable)
+{
+  GdkGLPbuffer *glpbuffer;
+
+  g_return_if_fail (GDK_IS_GL_PBUFFER (gldrawable));
+
+  glpbuffer = GDK_GL_PBUFFER (gldrawable);
+
+  GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl)->wait_gdk (glpbuffer);
+}
+
+static GdkGLConfig *
+_gdk_gl_pbuffer_get_gl_config (GdkGLDrawable *gldrawable)
+{
+  GdkGLPbuffer *glpbuffer;
+
+  g_return_val_if_fail (GDK_IS_GL_PBUFFER (gldrawable), NULL);
+
+  glpbuffer = GDK_GL_PBUFFER (gldrawable);
+
+  return GDK_GL_PBUFFER_IMPL_GET_CLASS (glpbuffer->impl)->get_gl_config (glpbuffer);
+}
+
+/**
+ * gdk_gl_pbuffer_new:
+ * @glconfig: a #GdkGLConfig whose drawable types include %GDK_GL_PBUFFER_BIT.
+ * @width: the requested width in pixels.
+ * @height: the requested height in pixels.
+ * @attrib_list: (allow-none): pbuffer attributes terminated by None, or NULL.
+ *
+ * Creates an off-screen rendering area. @attrib_list may set
+ * %GDK_GL_PRESERVED_CONTENTS, so that the contents survive display mode
+ * changes, and %GDK_GL_LARGEST_PBUFFER, so that a smaller pbuffer is
+ * returned instead of failing when memory is short; use
+ * gdk_gl_pbuffer_get_size() to find the size actually allocated.
+ * See GLX 1.3 spec.
+ *
+ * Contexts for the pbuffer are created with gdk_gl_context_new() and
+ * bound with gdk_gl_context_make_current(), like those of a #GdkGLWindow.
+ *
+ * On X11, GLX 1.3 pbuffers are used, or GLX_SGIX_pbuffer when only
+ * GLX 1.2 is available.
+ *
+ * Return value: the new #GdkGLPbuffer, or NULL if the pbuffer cannot be
+ *               created.
+ **/
+GdkGLPbuffer *
+gdk_gl_pbuffer_new (GdkGLConfig *glconfig,
+                    int          width,
+                    int          height,
+                    const int   *attrib_list)
+{
+  GdkGLConfigImplClass *impl_class;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_GL_CONFIG (glconfig), NULL);
+  g_return_val_if_fail (width > 0 && height > 0, NULL);
+
+  impl_class = GDK_GL_CONFIG_IMPL_GET_CLASS (glconfig->impl);
+
+  if (impl_class->create_gl_pbuffer == NULL)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- backend has no pbuffer support"));
+      return NULL;
+    }
+
+  return impl_class->create_gl_pbuffer (glconfig,
+                                        width,
+                                        height,
+                                        attrib_list);
+}
+
+/**
+ * gdk_gl_pbuffer_get_size:
+ * @glpbuffer: a #GdkGLPbuffer.
+ * @width: (out) (allow-none): return location for the width, or NULL.
+ * @height: (out) (allow-none): return location for the height, or NULL.
+ *
+ * Gets the size of @glpbuffer, which may be smaller than requested if
+ * it was created with %GDK_GL_LARGEST_PBUFFER.
+ **/
+void
+gdk_gl_pbuffer_get_size (GdkGLPbuffer *glpbuffer,
+                         int          *width,
+                         int          *height)
+{
+  g_return_if_fail (GDK_IS_GL_PBUFFER (glpbuffer));
+
+  if (width != NULL)
+    *width = glpbuffer->width;
+
+  if (height != NULL)
+    *height = glpbuffer->height;
+}
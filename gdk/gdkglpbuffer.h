@@ -0,0 +1,75 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#if !defined (__GDKGL_H_INSIDE__) && !defined (GDK_GL_COMPILATION)
+#error "Only <gdk/gdkgl.h> can be included directly."
+#endif
+
+#ifndef __GDK_GL_PBUFFER_H__
+#define __GDK_GL_PBUFFER_H__
+
+#include <gdk/gdkgldefs.h>
+#include <gdk/gdkgltypes.h>
+
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+struct _GdkGLPbufferImpl;
+typedef struct _GdkGLPbufferClass GdkGLPbufferClass;
+
+#define GDK_TYPE_GL_PBUFFER              (gdk_gl_pbuffer_get_type ())
+#define GDK_GL_PBUFFER(object)           (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_PBUFFER, GdkGLPbuffer))
+#define GDK_GL_PBUFFER_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_PBUFFER, GdkGLPbufferClass))
+#define GDK_IS_GL_PBUFFER(object)        (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_PBUFFER))
+#define GDK_IS_GL_PBUFFER_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_PBUFFER))
+#define GDK_GL_PBUFFER_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_PBUFFER, GdkGLPbufferClass))
+
+struct _GdkGLPbuffer
+{
+  GObject parent_instance;
+
+  struct _GdkGLPbufferImpl *impl;
+
+  int width;                /* Actual size, which GDK_GL_LARGEST_PBUFFER */
+  int height;               /* may make smaller than requested */
+};
+
+struct _GdkGLPbufferClass
+{
+  GObjectClass parent_class;
+};
+
+GType         gdk_gl_pbuffer_get_type (void);
+
+/*
+ * attrib_list may hold GDK_GL_PRESERVED_CONTENTS and
+ * GDK_GL_LARGEST_PBUFFER, terminated by None. See GLX 1.3 spec.
+ */
+GdkGLPbuffer *gdk_gl_pbuffer_new      (GdkGLConfig  *glconfig,
+                                       int           width,
+                                       int           height,
+                                       const int    *attrib_list);
+
+void          gdk_gl_pbuffer_get_size (GdkGLPbuffer *glpbuffer,
+                                       int          *width,
+                                       int          *height);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_PBUFFER_H__ */
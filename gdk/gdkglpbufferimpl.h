@@ -0,0 +1,66 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifndef __GDK_GL_PBUFFER_IMPL_H__
+#define __GDK_GL_PBUFFER_IMPL_H__
+
+#include <gdk/gdkgl.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_GL_PBUFFER_IMPL             (gdk_gl_pbuffer_impl_get_type ())
+#define GDK_GL_PBUFFER_IMPL(object)          (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_PBUFFER_IMPL, GdkGLPbufferImpl))
+#define GDK_GL_PBUFFER_IMPL_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_PBUFFER_IMPL, GdkGLPbufferImplClass))
+#define GDK_IS_GL_PBUFFER_IMPL(object)       (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_PBUFFER_IMPL))
+#define GDK_IS_GL_PBUFFER_IMPL_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_PBUFFER_IMPL))
+#define GDK_GL_PBUFFER_IMPL_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_PBUFFER_IMPL, GdkGLPbufferImplClass))
+
+typedef struct _GdkGLPbufferImpl
+{
+  GObject parent;
+} GdkGLPbufferImpl;
+
+typedef struct _GdkGLPbufferImplClass
+{
+  GObjectClass parent_class;
+
+  GdkGLContext* (*create_gl_context)       (GdkGLPbuffer *glpbuffer,
+                                            GdkGLContext *share_list,
+                                            gboolean      direct,
+                                            int           render_type);
+  GdkGLContext* (*create_gl_context_full)  (GdkGLPbuffer        *glpbuffer,
+                                            GdkGLContext        *share_list,
+                                            gboolean             direct,
+                                            int                  render_type,
+                                            int                  major_version,
+                                            int                  minor_version,
+                                            GdkGLContextProfile  profile,
+                                            GdkGLContextFlags    flags);
+  gboolean      (*is_double_buffered)      (GdkGLPbuffer *glpbuffer);
+  void          (*swap_buffers)            (GdkGLPbuffer *glpbuffer);
+  void          (*wait_gl)                 (GdkGLPbuffer *glpbuffer);
+  void          (*wait_gdk)                (GdkGLPbuffer *glpbuffer);
+  GdkGLConfig*  (*get_gl_config)           (GdkGLPbuffer *glpbuffer);
+  void          (*destroy_gl_pbuffer_impl) (GdkGLPbuffer *glpbuffer);
+} GdkGLPbufferImplClass;
+
+GType gdk_gl_pbuffer_impl_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_PBUFFER_IMPL_H__ */
@@ -24,6 +24,7 @@
 #include <gdk/gdkgltokens.h>
 #include <gdk/gdkgltypes.h>
 #include <gdk/gdkgldrawable.h>
+#include <gdk/gdkglfence.h>
 
 G_BEGIN_DECLS
 
@@ -35,11 +36,34 @@ void _gdk_gl_window_get_size (GdkGLDrawable *gldrawable,
                               gint          *width,
                               gint          *height);
 
+void _gdk_gl_window_flush_wait_gdk (GdkGLWindow *glwindow);
+
 void _gdk_gl_print_gl_info (void);
 
+GdkGLContext *_gdk_gl_context_new_owned_worker (GdkGLContext *share_list);
+
+gboolean _gdk_gl_framebuffer_make_current (GdkGLContext  *glcontext,
+                                           GdkGLDrawable *draw,
+                                           GdkGLDrawable *read);
+void     _gdk_gl_framebuffer_unbind       (GdkGLContext  *glcontext);
+
+GSource *_gdk_gl_fence_source_new_owned (GdkGLContext *share_list);
+
+void _gdk_gl_fence_source_add_in_thread (GSource        *source,
+                                         GdkGLFence     *glfence,
+                                         GdkGLFenceFunc  func,
+                                         gpointer        user_data,
+                                         GDestroyNotify  notify);
+
 /* Internal globals */
 
 extern gboolean _gdk_gl_context_force_indirect;
+extern gboolean _gdk_gl_context_no_error;
+extern gboolean _gdk_gl_config_no_disk_cache;
+extern gboolean _gdk_gl_use_egl;
+
+extern gint _gdk_gl_context_n_make_current;
+extern gint _gdk_gl_context_n_make_current_skipped;
 
 G_END_DECLS
 
@@ -37,6 +37,10 @@
 #include <GL/gl.h>
 #endif
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+#include <gdk/gdkx.h>
+#include "egl/gdkglquery-egl.h"
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
 #include <gdk/gdkx.h>
 #include "x11/gdkglquery-x11.h"
@@ -141,6 +145,13 @@ gdk_gl_query_extension_for_display (GdkDisplay *display)
 {
   gboolean supp = FALSE;
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (_gdk_egl_gl_is_enabled_for_display(display))
+    {
+      supp = _gdk_egl_gl_query_extension_for_display(display);
+    }
+  else
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
   if (GDK_IS_X11_DISPLAY(display))
     {
@@ -169,7 +180,8 @@ gdk_gl_query_extension_for_display (GdkDisplay *display)
  *
  * Returns the version numbers of the OpenGL extension to the window system.
  *
- * In the X Window System, it returns the GLX version.
+ * In the X Window System, it returns the GLX version, or the EGL version
+ * if the EGL backend is in use.
  *
  * In the Microsoft Windows, it returns the Windows version.
  *
@@ -190,7 +202,8 @@ gdk_gl_query_version (int *major,
  *
  * Returns the version numbers of the OpenGL extension to the window system.
  *
- * In the X Window System, it returns the GLX version.
+ * In the X Window System, it returns the GLX version, or the EGL version
+ * if the EGL backend is in use.
  *
  * In the Microsoft Windows, it returns the Windows version.
  *
@@ -203,6 +216,13 @@ gdk_gl_query_version_for_display (GdkDisplay *display,
 {
   gboolean succ = FALSE;
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (_gdk_egl_gl_is_enabled_for_display(display))
+    {
+      succ = _gdk_egl_gl_query_version_for_display(display, major, minor);
+    }
+  else
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
   if (GDK_IS_X11_DISPLAY(display))
     {
@@ -237,6 +257,12 @@ gdk_gl_get_proc_address (const char *proc_name)
 {
   GdkGLProc addr = NULL;
 
+#ifdef GDKGLEXT_WINDOWING_EGL
+  if (!addr && _gdk_egl_gl_is_enabled())
+    {
+      addr = _gdk_egl_gl_get_proc_address(proc_name);
+    }
+#endif
 #ifdef GDKGLEXT_WINDOWING_X11
   if (!addr)
     {
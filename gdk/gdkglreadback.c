@@ -0,0 +1,593 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <gio/gio.h>
+
+#include "gdkglprivate.h"
+#include "gdkglquery.h"
+#include "gdkglcontext.h"
+#include "gdkgldrawable.h"
+#include "gdkglfence.h"
+
+#ifdef G_OS_WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#endif
+
+#ifdef GDK_WINDOWING_QUARTZ
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+/* OpenGL 2.1 and GL_ARB_pixel_buffer_object share these values. */
+#ifndef GL_VERSION_1_5
+typedef ptrdiff_t GLsizeiptr;
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER              0x88EB
+#define GL_PIXEL_PACK_BUFFER_BINDING      0x88ED
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ                    0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY                      0x88B8
+#endif
+#ifndef GL_BGRA
+#define GL_BGRA                           0x80E1
+#endif
+#ifndef GL_UNSIGNED_INT_8_8_8_8_REV
+#define GL_UNSIGNED_INT_8_8_8_8_REV       0x8367
+#endif
+
+/*
+ * Pixels are read as GL_BGRA with GL_UNSIGNED_INT_8_8_8_8_REV, which is
+ * the layout of CAIRO_FORMAT_ARGB32 on any byte order.
+ */
+#define GDK_GL_READBACK_BYTES_PER_PIXEL   4
+
+/* Number of readbacks a context can have in flight. */
+#define GDK_GL_READBACK_RING_SIZE         3
+
+typedef struct
+{
+  void      (APIENTRY *GenBuffers)    (GLsizei n, GLuint *buffers);
+  void      (APIENTRY *DeleteBuffers) (GLsizei n, const GLuint *buffers);
+  void      (APIENTRY *BindBuffer)    (GLenum target, GLuint buffer);
+  void      (APIENTRY *BufferData)    (GLenum target, GLsizeiptr size,
+                                       const GLvoid *data, GLenum usage);
+  GLvoid   *(APIENTRY *MapBuffer)     (GLenum target, GLenum access);
+  GLboolean (APIENTRY *UnmapBuffer)   (GLenum target);
+} GdkGLReadbackProcs;
+
+typedef struct
+{
+  GLuint pbo;
+  gsize size;
+
+  /* set while a readback owns the slot; cleared by the watcher thread */
+  volatile gint busy;
+} GdkGLReadbackSlot;
+
+/*
+ * Per-context ring of pixel pack buffers. Pixels are read into the next
+ * free buffer, a fence is put behind the read, and the fence source's
+ * watcher thread maps the buffer once the fence is signaled. The render
+ * loop only blocks when every buffer is still in flight.
+ *
+ * The watcher's context does not keep the ring's context alive, which
+ * owns the ring; the watcher is stopped when that context is disposed.
+ */
+typedef struct
+{
+  /* held by the context and by each readback in flight */
+  volatile gint ref_count;
+
+  gboolean supported;
+  GdkGLReadbackProcs procs;
+
+  GdkGLReadbackSlot slots[GDK_GL_READBACK_RING_SIZE];
+  guint next_slot;
+
+  GSource *fence_source;
+} GdkGLReadbackRing;
+
+typedef struct
+{
+  GdkGLReadbackRing *ring;
+  GdkGLReadbackSlot *slot;
+  int width;
+  int height;
+  gboolean returned;
+} GdkGLReadbackJob;
+
+static const gchar quark_readback_ring_string[] = "gdk-gl-context-readback-ring";
+static GQuark quark_readback_ring = 0;
+
+static const cairo_user_data_key_t gdk_gl_readback_bytes_key;
+
+static GdkGLProc
+gdk_gl_readback_get_proc (const char *name,
+                          const char *suffix)
+{
+  GdkGLProc proc;
+  gchar *full_name;
+
+  full_name = g_strconcat (name, suffix, NULL);
+  proc = gdk_gl_get_proc_address (full_name);
+  g_free (full_name);
+
+  return proc;
+}
+
+/*
+ * Looks the entry points up in the current context. OpenGL 2.1 has
+ * pixel buffer objects in core; GL_ARB_pixel_buffer_object uses the
+ * GL_ARB_vertex_buffer_object entry points.
+ */
+static gboolean
+gdk_gl_readback_load_procs (GdkGLReadbackProcs *procs)
+{
+  const char *version;
+  const char *dot;
+  const char *suffix;
+  int major, minor;
+
+  version = (const char *) glGetString (GL_VERSION);
+  if (version == NULL)
+    return FALSE;
+
+  major = atoi (version);
+  dot = strchr (version, '.');
+  minor = (dot != NULL) ? atoi (dot + 1) : 0;
+
+  if (major > 2 || (major == 2 && minor >= 1))
+    {
+      suffix = "";
+    }
+  else if (gdk_gl_query_gl_extension ("GL_ARB_pixel_buffer_object") &&
+           gdk_gl_query_gl_extension ("GL_ARB_vertex_buffer_object"))
+    {
+      suffix = "ARB";
+    }
+  else
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Pixel buffer objects not supported"));
+      return FALSE;
+    }
+
+#define LOAD_PROC(name)                                                 \
+  if ((procs->name = (gpointer) gdk_gl_readback_get_proc ("gl" #name, suffix)) == NULL) \
+    return FALSE
+
+  LOAD_PROC (GenBuffers);
+  LOAD_PROC (DeleteBuffers);
+  LOAD_PROC (BindBuffer);
+  LOAD_PROC (BufferData);
+  LOAD_PROC (MapBuffer);
+  LOAD_PROC (UnmapBuffer);
+
+#undef LOAD_PROC
+
+  return TRUE;
+}
+
+static GdkGLReadbackRing *
+gdk_gl_readback_ring_ref (GdkGLReadbackRing *ring)
+{
+  g_atomic_int_inc (&ring->ref_count);
+
+  return ring;
+}
+
+static void
+gdk_gl_readback_ring_unref (gpointer data)
+{
+  GdkGLReadbackRing *ring = data;
+
+  if (!g_atomic_int_dec_and_test (&ring->ref_count))
+    return;
+
+  /* The watcher and the buffers went when the context was disposed. */
+  g_free (ring);
+}
+
+/*
+ * Called while the ring's context is disposed, before its GL context is
+ * destroyed. Stopping the watcher cancels the readbacks still in flight.
+ * The buffers can only be deleted if the context happens to be current;
+ * otherwise they are freed with the share group.
+ */
+static void
+gdk_gl_readback_ring_context_disposed (gpointer  data,
+                                       GObject  *where_the_object_was)
+{
+  GdkGLReadbackRing *ring = data;
+  guint i;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (ring->fence_source != NULL)
+    {
+      g_source_unref (ring->fence_source);
+      ring->fence_source = NULL;
+    }
+
+  if (gdk_gl_context_get_current () != GDK_GL_CONTEXT (where_the_object_was))
+    return;
+
+  for (i = 0; i < GDK_GL_READBACK_RING_SIZE; i++)
+    {
+      if (ring->slots[i].pbo != 0)
+        ring->procs.DeleteBuffers (1, &ring->slots[i].pbo);
+      ring->slots[i].pbo = 0;
+    }
+}
+
+static GdkGLReadbackRing *
+gdk_gl_readback_get_ring (GdkGLContext *glcontext)
+{
+  GdkGLReadbackRing *ring;
+
+  if (quark_readback_ring == 0)
+    quark_readback_ring = g_quark_from_static_string (quark_readback_ring_string);
+
+  ring = g_object_get_qdata (G_OBJECT (glcontext), quark_readback_ring);
+  if (ring == NULL)
+    {
+      ring = g_new0 (GdkGLReadbackRing, 1);
+      ring->ref_count = 1;
+
+      ring->supported = gdk_gl_readback_load_procs (&ring->procs);
+      if (ring->supported)
+        {
+          ring->fence_source = _gdk_gl_fence_source_new_owned (glcontext);
+          if (ring->fence_source == NULL)
+            {
+              GDK_GL_NOTE (MISC, g_message (" -- no fence watcher, readbacks block"));
+              ring->supported = FALSE;
+            }
+        }
+
+      g_object_set_qdata_full (G_OBJECT (glcontext), quark_readback_ring,
+                               ring, gdk_gl_readback_ring_unref);
+      g_object_weak_ref (G_OBJECT (glcontext),
+                         gdk_gl_readback_ring_context_disposed, ring);
+    }
+
+  return ring;
+}
+
+/*
+ * Copies rows from OpenGL's bottom-to-top order into top-to-bottom order.
+ */
+static void
+gdk_gl_readback_copy_rows (guchar       *dest,
+                           const guchar *src,
+                           int           width,
+                           int           height)
+{
+  gsize stride = (gsize) width * GDK_GL_READBACK_BYTES_PER_PIXEL;
+  int i;
+
+  for (i = 0; i < height; i++)
+    memcpy (dest + i * stride, src + (height - 1 - i) * stride, stride);
+}
+
+/*
+ * Runs in the fence watcher thread once the read into the slot's buffer
+ * has completed.
+ */
+static void
+gdk_gl_readback_job_complete (GdkGLFence *glfence,
+                              gpointer    user_data)
+{
+  GTask *task = user_data;
+  GdkGLReadbackJob *job = g_task_get_task_data (task);
+  GdkGLReadbackProcs *procs = &job->ring->procs;
+  gsize size;
+  guchar *pixels = NULL;
+  const guchar *data;
+
+  size = (gsize) job->width * job->height * GDK_GL_READBACK_BYTES_PER_PIXEL;
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_atomic_int_set (&job->slot->busy, FALSE);
+      job->returned = TRUE;
+      return;
+    }
+
+  if (gdk_gl_context_get_current () != NULL)
+    {
+      procs->BindBuffer (GL_PIXEL_PACK_BUFFER, job->slot->pbo);
+
+      data = procs->MapBuffer (GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+      if (data != NULL)
+        {
+          pixels = g_malloc (size);
+          gdk_gl_readback_copy_rows (pixels, data, job->width, job->height);
+          procs->UnmapBuffer (GL_PIXEL_PACK_BUFFER);
+        }
+
+      procs->BindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+  g_atomic_int_set (&job->slot->busy, FALSE);
+
+  job->returned = TRUE;
+
+  if (pixels != NULL)
+    g_task_return_pointer (task, g_bytes_new_take (pixels, size),
+                           (GDestroyNotify) g_bytes_unref);
+  else
+    g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED,
+                             "Cannot map the pixel buffer");
+}
+
+static void
+gdk_gl_readback_job_release (gpointer user_data)
+{
+  GTask *task = user_data;
+  GdkGLReadbackJob *job = g_task_get_task_data (task);
+
+  if (!job->returned)
+    g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                             "The OpenGL context was destroyed");
+
+  gdk_gl_readback_ring_unref (job->ring);
+  job->ring = NULL;
+
+  g_object_unref (task);
+}
+
+/*
+ * Reads the pixels into client memory, stalling until they are there.
+ */
+static GBytes *
+gdk_gl_readback_read_blocking (GdkGLReadbackRing *ring,
+                               int                x,
+                               int                y,
+                               int                width,
+                               int                height)
+{
+  gsize size;
+  guchar *data, *pixels;
+  GLint pack_buffer_binding = 0;
+
+  size = (gsize) width * height * GDK_GL_READBACK_BYTES_PER_PIXEL;
+  data = g_malloc (size);
+  pixels = g_malloc (size);
+
+  if (ring->supported)
+    {
+      glGetIntegerv (GL_PIXEL_PACK_BUFFER_BINDING, &pack_buffer_binding);
+      ring->procs.BindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+  glReadPixels (x, y, width, height,
+                GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, data);
+
+  if (ring->supported)
+    ring->procs.BindBuffer (GL_PIXEL_PACK_BUFFER, pack_buffer_binding);
+
+  gdk_gl_readback_copy_rows (pixels, data, width, height);
+  g_free (data);
+
+  return g_bytes_new_take (pixels, size);
+}
+
+/**
+ * gdk_gl_drawable_read_pixels_async:
+ * @gldrawable: a #GdkGLDrawable.
+ * @x: the left edge of the area to read.
+ * @y: the bottom edge of the area to read, in OpenGL window coordinates.
+ * @width: the width of the area.
+ * @height: the height of the area.
+ * @cancellable: (allow-none): a #GCancellable, or NULL.
+ * @callback: function to call when the pixels are available.
+ * @user_data: data to pass to @callback.
+ *
+ * Starts reading an area of the current read buffer of @gldrawable,
+ * which must be bound to the current context. Call this before swapping
+ * to read back the frame just rendered.
+ *
+ * The pixels are read into one of a small ring of pixel buffer objects
+ * kept per context, and copied out in another thread once the GPU has
+ * written them, so the render loop does not stall. @callback is called
+ * from the thread-default main context of the caller; get the pixels
+ * with gdk_gl_drawable_read_pixels_finish() or
+ * gdk_gl_drawable_read_pixels_finish_surface().
+ *
+ * When every buffer of the ring is in flight, or pixel buffer objects
+ * (OpenGL 2.1 or GL_ARB_pixel_buffer_object) or worker contexts are not
+ * supported, the pixels are read right away, which blocks. The first
+ * readback in a context creates a worker context for it, so make it
+ * from the thread running the GDK main loop (see
+ * gdk_gl_context_new_worker()).
+ *
+ * If @cancellable is cancelled before the pixels have been copied out,
+ * nothing more is read or copied and the readback fails with
+ * %G_IO_ERROR_CANCELLED.
+ **/
+void
+gdk_gl_drawable_read_pixels_async (GdkGLDrawable       *gldrawable,
+                                   int                  x,
+                                   int                  y,
+                                   int                  width,
+                                   int                  height,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data)
+{
+  GdkGLContext *glcontext;
+  GdkGLReadbackRing *ring;
+  GdkGLReadbackSlot *slot;
+  GdkGLReadbackJob *job;
+  GdkGLFence *glfence;
+  GTask *task;
+  gsize size;
+  GLint pack_buffer_binding, pack_alignment;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_if_fail (GDK_IS_GL_DRAWABLE (gldrawable));
+  g_return_if_fail (width > 0 && height > 0);
+
+  glcontext = gdk_gl_context_get_current ();
+  g_return_if_fail (glcontext != NULL);
+
+  task = g_task_new (gldrawable, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gdk_gl_drawable_read_pixels_async);
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_unref (task);
+      return;
+    }
+
+  job = g_new0 (GdkGLReadbackJob, 1);
+  job->width = width;
+  job->height = height;
+  g_task_set_task_data (task, job, g_free);
+
+  ring = gdk_gl_readback_get_ring (glcontext);
+  slot = &ring->slots[ring->next_slot];
+
+  glGetIntegerv (GL_PACK_ALIGNMENT, &pack_alignment);
+  glPixelStorei (GL_PACK_ALIGNMENT, 4);
+
+  if (!ring->supported || g_atomic_int_get (&slot->busy))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- no free pixel buffer, reading back now"));
+
+      job->returned = TRUE;
+      g_task_return_pointer (task,
+                             gdk_gl_readback_read_blocking (ring, x, y, width, height),
+                             (GDestroyNotify) g_bytes_unref);
+      g_object_unref (task);
+
+      glPixelStorei (GL_PACK_ALIGNMENT, pack_alignment);
+      return;
+    }
+
+  ring->next_slot = (ring->next_slot + 1) % GDK_GL_READBACK_RING_SIZE;
+
+  glGetIntegerv (GL_PIXEL_PACK_BUFFER_BINDING, &pack_buffer_binding);
+
+  if (slot->pbo == 0)
+    ring->procs.GenBuffers (1, &slot->pbo);
+  ring->procs.BindBuffer (GL_PIXEL_PACK_BUFFER, slot->pbo);
+
+  /* Buffers only grow, like framebuffer storage. */
+  size = (gsize) width * height * GDK_GL_READBACK_BYTES_PER_PIXEL;
+  if (slot->size < size)
+    {
+      ring->procs.BufferData (GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+      slot->size = size;
+    }
+
+  glReadPixels (x, y, width, height,
+                GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, NULL);
+
+  ring->procs.BindBuffer (GL_PIXEL_PACK_BUFFER, pack_buffer_binding);
+  glPixelStorei (GL_PACK_ALIGNMENT, pack_alignment);
+
+  g_atomic_int_set (&slot->busy, TRUE);
+
+  job->ring = gdk_gl_readback_ring_ref (ring);
+  job->slot = slot;
+
+  glfence = gdk_gl_fence_new ();
+  _gdk_gl_fence_source_add_in_thread (ring->fence_source, glfence,
+                                      gdk_gl_readback_job_complete,
+                                      task, gdk_gl_readback_job_release);
+  g_object_unref (glfence);
+}
+
+/**
+ * gdk_gl_drawable_read_pixels_finish:
+ * @gldrawable: a #GdkGLDrawable.
+ * @result: the #GAsyncResult passed to the callback.
+ * @error: return location for a #GError, or NULL.
+ *
+ * Finishes a readback started with gdk_gl_drawable_read_pixels_async().
+ * The pixels are in #CAIRO_FORMAT_ARGB32 layout, rows top to bottom with
+ * a stride of 4 times the width. Alpha is copied as it is in the
+ * framebuffer.
+ *
+ * Return value: (transfer full): the pixels, or NULL on error.
+ **/
+GBytes *
+gdk_gl_drawable_read_pixels_finish (GdkGLDrawable  *gldrawable,
+                                    GAsyncResult   *result,
+                                    GError        **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, gldrawable), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) ==
+                        gdk_gl_drawable_read_pixels_async, NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * gdk_gl_drawable_read_pixels_finish_surface:
+ * @gldrawable: a #GdkGLDrawable.
+ * @result: the #GAsyncResult passed to the callback.
+ * @error: return location for a #GError, or NULL.
+ *
+ * Like gdk_gl_drawable_read_pixels_finish(), but wraps the pixels in a
+ * cairo image surface without copying them.
+ *
+ * Return value: (transfer full): a new #CAIRO_FORMAT_ARGB32 image surface,
+ *               or NULL on error.
+ **/
+cairo_surface_t *
+gdk_gl_drawable_read_pixels_finish_surface (GdkGLDrawable  *gldrawable,
+                                            GAsyncResult   *result,
+                                            GError        **error)
+{
+  GdkGLReadbackJob *job;
+  GBytes *bytes;
+  cairo_surface_t *surface;
+
+  bytes = gdk_gl_drawable_read_pixels_finish (gldrawable, result, error);
+  if (bytes == NULL)
+    return NULL;
+
+  job = g_task_get_task_data (G_TASK (result));
+
+  surface = cairo_image_surface_create_for_data ((guchar *) g_bytes_get_data (bytes, NULL),
+                                                 CAIRO_FORMAT_ARGB32,
+                                                 job->width,
+                                                 job->height,
+                                                 job->width * GDK_GL_READBACK_BYTES_PER_PIXEL);
+  cairo_surface_set_user_data (surface, &gdk_gl_readback_bytes_key,
+                               bytes, (cairo_destroy_func_t) g_bytes_unref);
+
+  return surface;
+}
@@ -178,6 +178,7 @@ typedef enum
 typedef enum
 {
   GDK_GL_WINDOW_BIT                 = 1 << 0, /* 0x00000001 */
+  GDK_GL_PBUFFER_BIT                = 1 << 2, /* 0x00000004 */
 } GdkGLDrawableTypeMask;
 
 /*
@@ -229,6 +230,28 @@ typedef enum
   GDK_GL_RGBA_TYPE                  = 0x8014,
 } GdkGLRenderType;
 
+/*
+ * gdk_gl_context_new_full profile mask bits.
+ * [ GLX_ARB_create_context_profile ]
+ */
+typedef enum
+{
+  GDK_GL_CONTEXT_PROFILE_DEFAULT            = 0,
+  GDK_GL_CONTEXT_CORE_PROFILE_BIT           = 1 << 0, /* 0x00000001 */
+  GDK_GL_CONTEXT_COMPATIBILITY_PROFILE_BIT  = 1 << 1, /* 0x00000002 */
+} GdkGLContextProfile;
+
+/*
+ * gdk_gl_context_new_full flag bits.
+ * [ GLX_ARB_create_context, GLX_ARB_create_context_no_error ]
+ */
+typedef enum
+{
+  GDK_GL_CONTEXT_DEBUG_BIT                  = 1 << 0, /* 0x00000001 */
+  GDK_GL_CONTEXT_FORWARD_COMPATIBLE_BIT     = 1 << 1, /* 0x00000002 */
+  GDK_GL_CONTEXT_NO_ERROR_BIT               = 1 << 8, /* 0x00000100, not a GLX flag */
+} GdkGLContextFlags;
+
 /*
  * glXQueryDrawable attributes.
  * [ GLX 1.3 and later ]
@@ -236,6 +259,7 @@ typedef enum
 typedef enum
 {
   GDK_GL_PRESERVED_CONTENTS         = 0x801B,
+  GDK_GL_LARGEST_PBUFFER            = 0x801C,
   GDK_GL_WIDTH                      = 0x801D,
   GDK_GL_HEIGHT                     = 0x801E,
   GDK_GL_EVENT_MASK                 = 0x801F
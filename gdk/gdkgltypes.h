@@ -39,6 +39,10 @@ typedef struct _GdkGLContext  GdkGLContext;
 typedef struct _GdkGLDrawable GdkGLDrawable;
 
 typedef struct _GdkGLWindow   GdkGLWindow;
+typedef struct _GdkGLPbuffer  GdkGLPbuffer;
+typedef struct _GdkGLFramebuffer GdkGLFramebuffer;
+
+typedef struct _GdkGLFence    GdkGLFence;
 
 G_END_DECLS
 
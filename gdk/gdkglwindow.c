@@ -32,11 +32,25 @@ static GdkGLContext *_gdk_gl_window_create_gl_context   (GdkGLDrawable *gldrawab
                                                          GdkGLContext  *share_list,
                                                          gboolean       direct,
                                                          int            render_type);
+static GdkGLContext *_gdk_gl_window_create_gl_context_full (GdkGLDrawable       *gldrawable,
+                                                            GdkGLContext        *share_list,
+                                                            gboolean             direct,
+                                                            int                  render_type,
+                                                            int                  major_version,
+                                                            int                  minor_version,
+                                                            GdkGLContextProfile  profile,
+                                                            GdkGLContextFlags    flags);
 static gboolean      _gdk_gl_window_is_double_buffered  (GdkGLDrawable *gldrawable);
 static void          _gdk_gl_window_swap_buffers        (GdkGLDrawable *gldrawable);
 static void          _gdk_gl_window_wait_gl             (GdkGLDrawable *gldrawable);
 static void          _gdk_gl_window_wait_gdk            (GdkGLDrawable *gldrawable);
 static GdkGLConfig  *_gdk_gl_window_get_gl_config       (GdkGLDrawable *gldrawable);
+static gboolean      _gdk_gl_window_set_swap_interval   (GdkGLDrawable *gldrawable,
+                                                         int            interval);
+static int           _gdk_gl_window_get_swap_interval   (GdkGLDrawable *gldrawable);
+static int           _gdk_gl_window_get_buffer_age      (GdkGLDrawable *gldrawable);
+static void          _gdk_gl_window_swap_buffers_with_damage (GdkGLDrawable        *gldrawable,
+                                                              const cairo_region_t *damage);
 
 static void gdk_gl_window_gl_drawable_interface_init (GdkGLDrawableClass *iface);
 
@@ -54,6 +68,15 @@ gdk_gl_window_init (GdkGLWindow *self)
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
   self->window = NULL;
+
+  self->sbc = 0;
+  self->swap_ust = 0;
+  self->swap_msc = 0;
+
+  self->counts_swaps = TRUE;
+  self->fallback_rate = 60000;
+
+  self->wait_gdk_pending = 0;
 }
 
 static void
@@ -86,11 +109,16 @@ gdk_gl_window_gl_drawable_interface_init (GdkGLDrawableClass *iface)
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
   iface->create_gl_context  = _gdk_gl_window_create_gl_context;
+  iface->create_gl_context_full = _gdk_gl_window_create_gl_context_full;
   iface->is_double_buffered = _gdk_gl_window_is_double_buffered;
   iface->swap_buffers       = _gdk_gl_window_swap_buffers;
   iface->wait_gl            = _gdk_gl_window_wait_gl;
   iface->wait_gdk           = _gdk_gl_window_wait_gdk;
   iface->get_gl_config      = _gdk_gl_window_get_gl_config;
+  iface->set_swap_interval  = _gdk_gl_window_set_swap_interval;
+  iface->get_swap_interval  = _gdk_gl_window_get_swap_interval;
+  iface->get_buffer_age     = _gdk_gl_window_get_buffer_age;
+  iface->swap_buffers_with_damage = _gdk_gl_window_swap_buffers_with_damage;
 }
 
 static GdkGLContext *
@@ -111,6 +139,45 @@ _gdk_gl_window_create_gl_context  (GdkGLDrawable *gldrawable,
                                                                            render_type);
 }
 
+static GdkGLContext *
+_gdk_gl_window_create_gl_context_full (GdkGLDrawable       *gldrawable,
+                                       GdkGLContext        *share_list,
+                                       gboolean             direct,
+                                       int                  render_type,
+                                       int                  major_version,
+                                       int                  minor_version,
+                                       GdkGLContextProfile  profile,
+                                       GdkGLContextFlags    flags)
+{
+  GdkGLWindow *glwindow;
+  GdkGLWindowImplClass *impl_class;
+
+  g_return_val_if_fail(GDK_IS_GL_WINDOW(gldrawable), NULL);
+
+  glwindow = GDK_GL_WINDOW (gldrawable);
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->create_gl_context_full == NULL)
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- backend cannot create versioned contexts, using a legacy one"));
+
+      return impl_class->create_gl_context (glwindow,
+                                            share_list,
+                                            direct,
+                                            render_type);
+    }
+
+  return impl_class->create_gl_context_full (glwindow,
+                                             share_list,
+                                             direct,
+                                             render_type,
+                                             major_version,
+                                             minor_version,
+                                             profile,
+                                             flags);
+}
+
 static gboolean
 _gdk_gl_window_is_double_buffered (GdkGLDrawable *gldrawable)
 {
@@ -123,6 +190,121 @@ _gdk_gl_window_is_double_buffered (GdkGLDrawable *gldrawable)
   return GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl)->is_double_buffered (glwindow);
 }
 
+/*
+ * Clock-based presentation timing.
+ *
+ * Without GLX_OML_sync_control the UST is g_get_monotonic_time() and the
+ * MSC is derived from it and the refresh rate of the window's monitor,
+ * so MSC boundaries are only approximately aligned with the real
+ * retrace. The SBC counts the swaps made through GdkGLExt. The refresh
+ * rate is cached, since swaps may be made from a render thread, where
+ * GDK must not be called.
+ */
+
+G_LOCK_DEFINE_STATIC (swap_counters);
+
+/*
+ * Reads the refresh rate of the window's monitor. GDK is only called
+ * from the main thread: when the GdkGLWindow is created, and when the
+ * screen's monitors change.
+ */
+static void
+_gdk_gl_window_update_fallback_rate (GdkGLWindow *glwindow)
+{
+  /* refresh rate in mHz */
+  int rate = 0;
+
+#ifdef GDK_VERSION_3_22
+  if (glwindow->window != NULL)
+    {
+      GdkDisplay *display = gdk_window_get_display (glwindow->window);
+      GdkMonitor *monitor = gdk_display_get_monitor_at_window (display, glwindow->window);
+
+      if (monitor != NULL)
+        rate = gdk_monitor_get_refresh_rate (monitor);
+    }
+#endif
+
+  if (rate <= 0)
+    rate = 60000;
+
+  g_atomic_int_set (&glwindow->fallback_rate, rate);
+}
+
+static void
+_gdk_gl_window_get_fallback_msc_rate (GdkGLWindow *glwindow,
+                                      gint32      *numerator,
+                                      gint32      *denominator)
+{
+  *numerator = g_atomic_int_get (&glwindow->fallback_rate);
+  *denominator = 1000;
+}
+
+/*
+ * Sets up the clock-based fallback for a new window, on the main thread.
+ * Swaps are only counted when the backend cannot report sync values.
+ */
+static void
+_gdk_gl_window_init_timing (GdkGLWindow *glwindow)
+{
+  GdkGLWindowImplClass *impl_class;
+  gint64 ust, msc, sbc;
+
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  glwindow->counts_swaps = !(impl_class->get_sync_values != NULL &&
+                             impl_class->get_sync_values (glwindow, &ust, &msc, &sbc));
+  if (!glwindow->counts_swaps || glwindow->window == NULL)
+    return;
+
+  _gdk_gl_window_update_fallback_rate (glwindow);
+
+  g_signal_connect_object (gdk_window_get_screen (glwindow->window),
+                           "monitors-changed",
+                           G_CALLBACK (_gdk_gl_window_update_fallback_rate),
+                           glwindow, G_CONNECT_SWAPPED);
+}
+
+static gint64
+_gdk_gl_window_ust_to_msc (GdkGLWindow *glwindow,
+                           gint64       ust)
+{
+  gint32 numerator, denominator;
+
+  _gdk_gl_window_get_fallback_msc_rate (glwindow, &numerator, &denominator);
+
+  return ust * numerator / ((gint64) denominator * G_USEC_PER_SEC);
+}
+
+static gint64
+_gdk_gl_window_msc_to_ust (GdkGLWindow *glwindow,
+                           gint64       msc)
+{
+  gint32 numerator, denominator;
+
+  _gdk_gl_window_get_fallback_msc_rate (glwindow, &numerator, &denominator);
+
+  /* round up so that the MSC has been reached at the returned time */
+  return (msc * denominator * G_USEC_PER_SEC + numerator - 1) / numerator;
+}
+
+static gint64
+_gdk_gl_window_count_swap (GdkGLWindow *glwindow)
+{
+  gint64 ust, msc, sbc;
+
+  ust = g_get_monotonic_time ();
+  msc = _gdk_gl_window_ust_to_msc (glwindow, ust);
+
+  G_LOCK (swap_counters);
+  sbc = ++glwindow->sbc;
+  glwindow->swap_ust = ust;
+  glwindow->swap_msc = msc;
+  G_UNLOCK (swap_counters);
+
+  return sbc;
+}
+
 static void
 _gdk_gl_window_swap_buffers (GdkGLDrawable *gldrawable)
 {
@@ -133,6 +315,9 @@ _gdk_gl_window_swap_buffers (GdkGLDrawable *gldrawable)
   glwindow = GDK_GL_WINDOW (gldrawable);
 
   GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl)->swap_buffers (glwindow);
+
+  if (glwindow->counts_swaps)
+    _gdk_gl_window_count_swap (glwindow);
 }
 
 static void
@@ -171,6 +356,84 @@ _gdk_gl_window_get_gl_config (GdkGLDrawable *gldrawable)
   return GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl)->get_gl_config (glwindow);
 }
 
+static gboolean
+_gdk_gl_window_set_swap_interval (GdkGLDrawable *gldrawable,
+                                  int            interval)
+{
+  GdkGLWindow *glwindow;
+  GdkGLWindowImplClass *impl_class;
+
+  g_return_val_if_fail(GDK_IS_GL_WINDOW(gldrawable), FALSE);
+
+  glwindow = GDK_GL_WINDOW (gldrawable);
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->set_swap_interval == NULL)
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- backend cannot set the swap interval"));
+      return FALSE;
+    }
+
+  return impl_class->set_swap_interval (glwindow, interval);
+}
+
+static int
+_gdk_gl_window_get_swap_interval (GdkGLDrawable *gldrawable)
+{
+  GdkGLWindow *glwindow;
+  GdkGLWindowImplClass *impl_class;
+
+  g_return_val_if_fail(GDK_IS_GL_WINDOW(gldrawable), 0);
+
+  glwindow = GDK_GL_WINDOW (gldrawable);
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  /* the usual driver default */
+  if (impl_class->get_swap_interval == NULL)
+    return 1;
+
+  return impl_class->get_swap_interval (glwindow);
+}
+
+static int
+_gdk_gl_window_get_buffer_age (GdkGLDrawable *gldrawable)
+{
+  GdkGLWindow *glwindow;
+  GdkGLWindowImplClass *impl_class;
+
+  g_return_val_if_fail(GDK_IS_GL_WINDOW(gldrawable), 0);
+
+  glwindow = GDK_GL_WINDOW (gldrawable);
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->get_buffer_age == NULL)
+    return 0;
+
+  return impl_class->get_buffer_age (glwindow);
+}
+
+static void
+_gdk_gl_window_swap_buffers_with_damage (GdkGLDrawable        *gldrawable,
+                                         const cairo_region_t *damage)
+{
+  GdkGLWindow *glwindow;
+  GdkGLWindowImplClass *impl_class;
+
+  g_return_if_fail(GDK_IS_GL_WINDOW(gldrawable));
+
+  glwindow = GDK_GL_WINDOW (gldrawable);
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->swap_buffers_with_damage == NULL)
+    impl_class->swap_buffers (glwindow);
+  else
+    impl_class->swap_buffers_with_damage (glwindow, damage);
+
+  if (glwindow->counts_swaps)
+    _gdk_gl_window_count_swap (glwindow);
+}
+
 /**
  * gdk_gl_window_new:
  * @glconfig: a #GdkGLConfig.
@@ -188,11 +451,17 @@ gdk_gl_window_new (GdkGLConfig *glconfig,
                    GdkWindow   *window,
                    const int   *attrib_list)
 {
+  GdkGLWindow *glwindow;
+
   g_return_val_if_fail (GDK_IS_GL_CONFIG (glconfig), NULL);
 
-  return GDK_GL_CONFIG_IMPL_GET_CLASS (glconfig->impl)->create_gl_window (glconfig,
-                                                                          window,
-                                                                          attrib_list);
+  glwindow = GDK_GL_CONFIG_IMPL_GET_CLASS (glconfig->impl)->create_gl_window (glconfig,
+                                                                              window,
+                                                                              attrib_list);
+  if (glwindow != NULL)
+    _gdk_gl_window_init_timing (glwindow);
+
+  return glwindow;
 }
 
 /**
@@ -211,6 +480,249 @@ gdk_gl_window_get_window (GdkGLWindow *glwindow)
   return glwindow->window;
 }
 
+/**
+ * gdk_gl_window_get_sync_values:
+ * @glwindow: a #GdkGLWindow.
+ * @ust: (out): return location for the unadjusted system time.
+ * @msc: (out): return location for the media stream counter.
+ * @sbc: (out): return location for the swap buffer counter.
+ *
+ * Gets the current UST (a monotonic time), MSC (the number of vertical
+ * retraces) and SBC (the number of completed buffer swaps) of @glwindow,
+ * as defined by GLX_OML_sync_control.
+ *
+ * Where the extension is not available, the UST is
+ * g_get_monotonic_time() in microseconds, the MSC is computed from it and
+ * the refresh rate given by gdk_gl_window_get_msc_rate(), and the SBC
+ * counts the swaps made on @glwindow.
+ *
+ * Return value: TRUE if the values have been read.
+ **/
+gboolean
+gdk_gl_window_get_sync_values (GdkGLWindow *glwindow,
+                               gint64      *ust,
+                               gint64      *msc,
+                               gint64      *sbc)
+{
+  GdkGLWindowImplClass *impl_class;
+  gint64 now;
+
+  g_return_val_if_fail (GDK_IS_GL_WINDOW (glwindow), FALSE);
+  g_return_val_if_fail (ust != NULL && msc != NULL && sbc != NULL, FALSE);
+
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->get_sync_values != NULL &&
+      impl_class->get_sync_values (glwindow, ust, msc, sbc))
+    return TRUE;
+
+  now = g_get_monotonic_time ();
+
+  *ust = now;
+  *msc = _gdk_gl_window_ust_to_msc (glwindow, now);
+
+  G_LOCK (swap_counters);
+  *sbc = glwindow->sbc;
+  G_UNLOCK (swap_counters);
+
+  return TRUE;
+}
+
+/**
+ * gdk_gl_window_get_msc_rate:
+ * @glwindow: a #GdkGLWindow.
+ * @numerator: (out): return location for the numerator of the rate.
+ * @denominator: (out): return location for the denominator of the rate.
+ *
+ * Gets the rate at which the MSC of @glwindow is incremented, in Hz, as
+ * @numerator / @denominator. Without GLX_OML_sync_control this is the
+ * refresh rate reported for the monitor of the window, or 60 Hz, read
+ * when @glwindow was created or the screen's monitors last changed.
+ *
+ * Return value: TRUE if the rate has been read.
+ **/
+gboolean
+gdk_gl_window_get_msc_rate (GdkGLWindow *glwindow,
+                            gint32      *numerator,
+                            gint32      *denominator)
+{
+  GdkGLWindowImplClass *impl_class;
+
+  g_return_val_if_fail (GDK_IS_GL_WINDOW (glwindow), FALSE);
+  g_return_val_if_fail (numerator != NULL && denominator != NULL, FALSE);
+
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->get_msc_rate != NULL &&
+      impl_class->get_msc_rate (glwindow, numerator, denominator))
+    return TRUE;
+
+  _gdk_gl_window_get_fallback_msc_rate (glwindow, numerator, denominator);
+
+  return TRUE;
+}
+
+/**
+ * gdk_gl_window_swap_buffers_msc:
+ * @glwindow: a #GdkGLWindow.
+ * @target_msc: the MSC at which to swap.
+ * @divisor: divisor used once @target_msc has passed, or 0.
+ * @remainder: remainder used with @divisor.
+ *
+ * Schedules a buffer swap for the vertical retrace at which the MSC
+ * reaches @target_msc. If the MSC is already past @target_msc, the swap
+ * happens at the next retrace where MSC % @divisor == @remainder, or
+ * as soon as possible if @divisor is 0. This follows
+ * glXSwapBuffersMscOML(): the call returns without waiting, and
+ * gdk_gl_window_wait_for_sbc() with the returned SBC gives the time at
+ * which the frame was actually presented.
+ *
+ * An animation can compare the MSC it is about to present with the one
+ * it expected and skip frames on purpose rather than queueing them.
+ *
+ * Without GLX_OML_sync_control the call sleeps until the clock-based
+ * MSC reaches the target and then swaps.
+ *
+ * Return value: the SBC the swap will complete with, or -1 on error.
+ **/
+gint64
+gdk_gl_window_swap_buffers_msc (GdkGLWindow *glwindow,
+                                gint64       target_msc,
+                                gint64       divisor,
+                                gint64       remainder)
+{
+  GdkGLWindowImplClass *impl_class;
+  gint64 msc, swap_msc, delay;
+
+  g_return_val_if_fail (GDK_IS_GL_WINDOW (glwindow), -1);
+  g_return_val_if_fail (target_msc >= 0, -1);
+  g_return_val_if_fail (divisor >= 0, -1);
+  g_return_val_if_fail (remainder >= 0 && (divisor == 0 || remainder < divisor), -1);
+
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->swap_buffers_msc != NULL)
+    {
+      gint64 sbc = impl_class->swap_buffers_msc (glwindow, target_msc, divisor, remainder);
+      if (sbc >= 0)
+        return sbc;
+    }
+
+  msc = _gdk_gl_window_ust_to_msc (glwindow, g_get_monotonic_time ());
+
+  if (msc < target_msc)
+    swap_msc = target_msc;
+  else if (divisor > 0)
+    swap_msc = msc + (remainder - msc % divisor + divisor) % divisor;
+  else
+    swap_msc = msc;
+
+  if (swap_msc > msc)
+    {
+      delay = _gdk_gl_window_msc_to_ust (glwindow, swap_msc) - g_get_monotonic_time ();
+      if (delay > 0)
+        g_usleep (delay);
+    }
+
+  impl_class->swap_buffers (glwindow);
+
+  return _gdk_gl_window_count_swap (glwindow);
+}
+
+/**
+ * gdk_gl_window_wait_for_sbc:
+ * @glwindow: a #GdkGLWindow.
+ * @target_sbc: the SBC to wait for, or 0 for the last swap.
+ * @ust: (out): return location for the UST of the swap.
+ * @msc: (out): return location for the MSC of the swap.
+ * @sbc: (out): return location for the SBC.
+ *
+ * Waits until the SBC of @glwindow reaches @target_sbc, then returns the
+ * UST and MSC at which that swap was presented, as
+ * glXWaitForSbcOML() does.
+ *
+ * Without GLX_OML_sync_control this waits for the OpenGL commands to
+ * complete and returns the time of the last swap made through GdkGLExt;
+ * it fails if @target_sbc is beyond that swap, since nothing would
+ * complete it.
+ *
+ * Return value: TRUE if the swap has completed.
+ **/
+gboolean
+gdk_gl_window_wait_for_sbc (GdkGLWindow *glwindow,
+                            gint64       target_sbc,
+                            gint64      *ust,
+                            gint64      *msc,
+                            gint64      *sbc)
+{
+  GdkGLWindowImplClass *impl_class;
+
+  g_return_val_if_fail (GDK_IS_GL_WINDOW (glwindow), FALSE);
+  g_return_val_if_fail (target_sbc >= 0, FALSE);
+  g_return_val_if_fail (ust != NULL && msc != NULL && sbc != NULL, FALSE);
+
+  impl_class = GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl);
+
+  if (impl_class->wait_for_sbc != NULL &&
+      impl_class->wait_for_sbc (glwindow, target_sbc, ust, msc, sbc))
+    return TRUE;
+
+  G_LOCK (swap_counters);
+  *sbc = glwindow->sbc;
+  G_UNLOCK (swap_counters);
+
+  if (target_sbc > *sbc)
+    return FALSE;
+
+  impl_class->wait_gl (glwindow);
+
+  G_LOCK (swap_counters);
+  *ust = glwindow->swap_ust;
+  *msc = glwindow->swap_msc;
+  *sbc = glwindow->sbc;
+  G_UNLOCK (swap_counters);
+
+  return TRUE;
+}
+
+/**
+ * gdk_gl_window_queue_wait_gdk:
+ * @glwindow: a #GdkGLWindow.
+ *
+ * Requests a gdk_gl_drawable_wait_gdk() on @glwindow, made by the next
+ * gdk_gl_context_make_current() that binds @glwindow as the draw
+ * drawable, in whichever thread that happens. Any number of requests
+ * made before then result in a single wait.
+ *
+ * Call this when the window is resized, instead of waiting right away:
+ * the window may be resized many times before it is drawn again, and on
+ * X11 each wait is a round trip to the server.
+ *
+ * This function may be called from any thread.
+ **/
+void
+gdk_gl_window_queue_wait_gdk (GdkGLWindow *glwindow)
+{
+  g_return_if_fail (GDK_IS_GL_WINDOW (glwindow));
+
+  g_atomic_int_set (&glwindow->wait_gdk_pending, 1);
+}
+
+/*
+ * Makes the wait requested by gdk_gl_window_queue_wait_gdk(), if any.
+ * A context must be current on @glwindow.
+ */
+void
+_gdk_gl_window_flush_wait_gdk (GdkGLWindow *glwindow)
+{
+  if (!g_atomic_int_compare_and_exchange (&glwindow->wait_gdk_pending, 1, 0))
+    return;
+
+  GDK_GL_NOTE (MISC, g_message (" - wait for GDK after resize"));
+
+  GDK_GL_WINDOW_IMPL_GET_CLASS (glwindow->impl)->wait_gdk (glwindow);
+}
+
 /*
  * OpenGL extension to GdkWindow
  */
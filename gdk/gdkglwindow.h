@@ -47,6 +47,23 @@ struct _GdkGLWindow
   struct _GdkGLWindowImpl *impl;
 
   GdkWindow *window;        /* Associated GdkWindow */
+
+  /* Timing of the last swap, counted here for backends without
+     GLX_OML_sync_control; protected by a lock, as swaps may be made
+     from a render thread. */
+  gint64 sbc;
+  gint64 swap_ust;
+  gint64 swap_msc;
+
+  /* Clock-based fallback: whether swaps are counted here, and the
+     refresh rate of the window's monitor in mHz, read on the main
+     thread. */
+  gboolean counts_swaps;
+  volatile gint fallback_rate;
+
+  /* Set by gdk_gl_window_queue_wait_gdk(), cleared by the next
+     gdk_gl_context_make_current() onto this window. */
+  volatile gint wait_gdk_pending;
 };
 
 struct _GdkGLWindowClass
@@ -66,6 +83,36 @@ GdkGLWindow *gdk_gl_window_new              (GdkGLConfig *glconfig,
 
 GdkWindow   *gdk_gl_window_get_window       (GdkGLWindow *glwindow);
 
+/*
+ * Presentation timing
+ */
+
+gboolean     gdk_gl_window_get_sync_values  (GdkGLWindow *glwindow,
+                                             gint64      *ust,
+                                             gint64      *msc,
+                                             gint64      *sbc);
+
+gboolean     gdk_gl_window_get_msc_rate     (GdkGLWindow *glwindow,
+                                             gint32      *numerator,
+                                             gint32      *denominator);
+
+gint64       gdk_gl_window_swap_buffers_msc (GdkGLWindow *glwindow,
+                                             gint64       target_msc,
+                                             gint64       divisor,
+                                             gint64       remainder);
+
+gboolean     gdk_gl_window_wait_for_sbc     (GdkGLWindow *glwindow,
+                                             gint64       target_sbc,
+                                             gint64      *ust,
+                                             gint64      *msc,
+                                             gint64      *sbc);
+
+/*
+ * Resize synchronization
+ */
+
+void         gdk_gl_window_queue_wait_gdk   (GdkGLWindow *glwindow);
+
 /*
  * OpenGL extension to GdkWindow
  */
@@ -49,12 +49,21 @@ gdk_gl_window_impl_class_init (GdkGLWindowImplClass *klass)
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
   klass->create_gl_context      = NULL;
+  klass->create_gl_context_full = NULL;
   klass->is_double_buffered     = NULL;
   klass->swap_buffers           = NULL;
   klass->wait_gl                = NULL;
   klass->wait_gdk               = NULL;
   klass->get_gl_config          = NULL;
   klass->destroy_gl_window_impl = NULL;
+  klass->set_swap_interval      = NULL;
+  klass->get_swap_interval      = NULL;
+  klass->get_buffer_age         = NULL;
+  klass->swap_buffers_with_damage = NULL;
+  klass->get_sync_values        = NULL;
+  klass->get_msc_rate           = NULL;
+  klass->swap_buffers_msc       = NULL;
+  klass->wait_for_sbc           = NULL;
 
   object_class->finalize = gdk_gl_window_impl_finalize;
 }
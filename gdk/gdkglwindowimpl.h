@@ -43,12 +43,44 @@ typedef struct _GdkGLWindowImplClass
                                            GdkGLContext *share_list,
                                            gboolean      direct,
                                            int           render_type);
+  GdkGLContext* (*create_gl_context_full) (GdkGLWindow         *glwindow,
+                                           GdkGLContext        *share_list,
+                                           gboolean             direct,
+                                           int                  render_type,
+                                           int                  major_version,
+                                           int                  minor_version,
+                                           GdkGLContextProfile  profile,
+                                           GdkGLContextFlags    flags);
   gboolean      (*is_double_buffered)     (GdkGLWindow *glwindow);
   void          (*swap_buffers)           (GdkGLWindow *glwindow);
   void          (*wait_gl)                (GdkGLWindow *glwindow);
   void          (*wait_gdk)               (GdkGLWindow *glwindow);
   GdkGLConfig*  (*get_gl_config)          (GdkGLWindow *glwindow);
   void          (*destroy_gl_window_impl) (GdkGLWindow *glwindow);
+  gboolean      (*set_swap_interval)      (GdkGLWindow *glwindow,
+                                           int          interval);
+  int           (*get_swap_interval)      (GdkGLWindow *glwindow);
+  int           (*get_buffer_age)         (GdkGLWindow *glwindow);
+  void          (*swap_buffers_with_damage) (GdkGLWindow          *glwindow,
+                                             const cairo_region_t *damage);
+
+  /* presentation timing; FALSE or -1 selects the clock-based fallback */
+  gboolean      (*get_sync_values)        (GdkGLWindow *glwindow,
+                                           gint64      *ust,
+                                           gint64      *msc,
+                                           gint64      *sbc);
+  gboolean      (*get_msc_rate)           (GdkGLWindow *glwindow,
+                                           gint32      *numerator,
+                                           gint32      *denominator);
+  gint64        (*swap_buffers_msc)       (GdkGLWindow *glwindow,
+                                           gint64       target_msc,
+                                           gint64       divisor,
+                                           gint64       remainder);
+  gboolean      (*wait_for_sbc)           (GdkGLWindow *glwindow,
+                                           gint64       target_sbc,
+                                           gint64      *ust,
+                                           gint64      *msc,
+                                           gint64      *sbc);
 } GdkGLWindowImplClass;
 
 GType gdk_gl_window_impl_get_type (void);
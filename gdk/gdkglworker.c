@@ -0,0 +1,354 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include "gdkglprivate.h"
+#include "gdkglcontext.h"
+#include "gdkglfence.h"
+#include "gdkglworker.h"
+
+/*
+ * Each worker thread owns one worker context for its whole life, so a
+ * context is never current in two threads. Jobs are taken from a shared
+ * queue; a job with a NULL func tells one worker to exit.
+ *
+ * A worker does not wait for the GPU after each job. It puts a fence
+ * behind the job's commands and goes on with the next job; a job is
+ * reported done once its fence is signaled, and the worker only blocks
+ * on the oldest fence when it has nothing else to do.
+ */
+
+struct _GdkGLWorkerPool
+{
+  GAsyncQueue *jobs;
+  GPtrArray *threads;
+
+  /* startup handshake: each worker reports whether its context could
+     be made current before the pool is handed out */
+  GMutex lock;
+  GCond cond;
+  guint n_started;
+  guint n_failed;
+};
+
+typedef struct
+{
+  GdkGLWorkerFunc func;
+  GdkGLWorkerDoneFunc done_func;
+  gpointer user_data;
+  GMainContext *main_context;
+  GdkGLFence *glfence;
+} GdkGLWorkerJob;
+
+typedef struct
+{
+  GdkGLWorkerPool *pool;
+  GdkGLContext *glcontext;
+} GdkGLWorker;
+
+static gboolean
+gdk_gl_worker_job_done (gpointer data)
+{
+  GdkGLWorkerJob *job = data;
+
+  job->done_func (job->user_data);
+
+  return FALSE;
+}
+
+static void
+gdk_gl_worker_job_free (gpointer data)
+{
+  GdkGLWorkerJob *job = data;
+
+  if (job->main_context != NULL)
+    g_main_context_unref (job->main_context);
+
+  g_slice_free (GdkGLWorkerJob, job);
+}
+
+static void
+gdk_gl_worker_job_retire (GdkGLWorkerJob *job)
+{
+  if (job->glfence != NULL)
+    {
+      g_object_unref (job->glfence);
+      job->glfence = NULL;
+    }
+
+  if (job->done_func != NULL)
+    g_main_context_invoke_full (job->main_context,
+                                G_PRIORITY_DEFAULT,
+                                gdk_gl_worker_job_done,
+                                job,
+                                gdk_gl_worker_job_free);
+  else
+    gdk_gl_worker_job_free (job);
+}
+
+/*
+ * Retires the jobs at the head of the in-flight queue whose fences are
+ * signaled. If wait is TRUE, blocks until at least the oldest one is.
+ */
+static void
+gdk_gl_worker_retire_jobs (GQueue   *in_flight,
+                           gboolean  wait)
+{
+  GdkGLWorkerJob *job;
+
+  while ((job = g_queue_peek_head (in_flight)) != NULL)
+    {
+      if (wait)
+        {
+          gdk_gl_fence_client_wait (job->glfence, -1);
+          wait = FALSE;
+        }
+      else if (!gdk_gl_fence_is_signaled (job->glfence))
+        {
+          break;
+        }
+
+      gdk_gl_worker_job_retire (g_queue_pop_head (in_flight));
+    }
+}
+
+static gpointer
+gdk_gl_worker_main (gpointer data)
+{
+  GdkGLWorker *worker = data;
+  GdkGLWorkerJob *job;
+  GQueue in_flight = G_QUEUE_INIT;
+  gboolean is_current;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  is_current = gdk_gl_context_make_current (worker->glcontext, NULL, NULL);
+
+  g_mutex_lock (&worker->pool->lock);
+  worker->pool->n_started++;
+  if (!is_current)
+    worker->pool->n_failed++;
+  g_cond_signal (&worker->pool->cond);
+  g_mutex_unlock (&worker->pool->lock);
+
+  if (!is_current)
+    {
+      g_object_unref (worker->glcontext);
+      g_free (worker);
+      return NULL;
+    }
+
+  for (;;)
+    {
+      gdk_gl_worker_retire_jobs (&in_flight, FALSE);
+
+      if (g_queue_is_empty (&in_flight))
+        {
+          job = g_async_queue_pop (worker->pool->jobs);
+        }
+      else
+        {
+          job = g_async_queue_try_pop (worker->pool->jobs);
+          if (job == NULL)
+            {
+              gdk_gl_worker_retire_jobs (&in_flight, TRUE);
+              continue;
+            }
+        }
+
+      if (job->func == NULL)
+        {
+          while (!g_queue_is_empty (&in_flight))
+            gdk_gl_worker_retire_jobs (&in_flight, TRUE);
+
+          gdk_gl_worker_job_free (job);
+          break;
+        }
+
+      job->func (worker->glcontext, job->user_data);
+
+      /* Other contexts may only use the results once the commands
+         that produced them have completed. */
+      job->glfence = gdk_gl_fence_new ();
+      g_queue_push_tail (&in_flight, job);
+    }
+
+  /* The in-flight fences are gone, so nothing else refers to this
+     worker's context; destroy it before the pool joins the thread. */
+  g_object_unref (worker->glcontext);
+  g_free (worker);
+
+  return NULL;
+}
+
+/*
+ * Asks n_running workers to exit once the queued jobs are done, joins
+ * every thread and frees the pool.
+ */
+static void
+gdk_gl_worker_pool_stop (GdkGLWorkerPool *pool,
+                         guint            n_running)
+{
+  guint i;
+
+  for (i = 0; i < n_running; i++)
+    g_async_queue_push (pool->jobs, g_slice_new0 (GdkGLWorkerJob));
+
+  for (i = 0; i < pool->threads->len; i++)
+    g_thread_join (g_ptr_array_index (pool->threads, i));
+
+  g_ptr_array_free (pool->threads, TRUE);
+  g_async_queue_unref (pool->jobs);
+  g_mutex_clear (&pool->lock);
+  g_cond_clear (&pool->cond);
+  g_free (pool);
+}
+
+/**
+ * gdk_gl_worker_pool_new:
+ * @share_list: the #GdkGLContext whose objects the workers share.
+ * @n_workers: the number of worker threads.
+ *
+ * Creates a pool of @n_workers threads, each with its own worker context
+ * (see gdk_gl_context_new_worker()) in the share group of @share_list.
+ * Textures and buffer objects created by jobs can be used from
+ * @share_list once the job's done function has been called.
+ *
+ * On X11, Xlib must be thread-safe: call XInitThreads() before gtk_init()
+ * unless libX11 is 1.8 or newer.
+ *
+ * Return value: the new #GdkGLWorkerPool, or NULL if the worker contexts
+ *               cannot be created or made current in their threads.
+ **/
+GdkGLWorkerPool *
+gdk_gl_worker_pool_new (GdkGLContext *share_list,
+                        guint         n_workers)
+{
+  GdkGLWorkerPool *pool;
+  GdkGLContext **glcontexts;
+  GdkGLWorker *worker;
+  guint i;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_GL_CONTEXT (share_list), NULL);
+  g_return_val_if_fail (n_workers > 0, NULL);
+
+  /* Create all contexts first so that failure leaves nothing running. */
+  glcontexts = g_new0 (GdkGLContext *, n_workers);
+
+  for (i = 0; i < n_workers; i++)
+    {
+      glcontexts[i] = gdk_gl_context_new_worker (share_list);
+      if (glcontexts[i] == NULL)
+        {
+          while (i-- > 0)
+            g_object_unref (glcontexts[i]);
+          g_free (glcontexts);
+          return NULL;
+        }
+    }
+
+  pool = g_new0 (GdkGLWorkerPool, 1);
+  pool->jobs = g_async_queue_new ();
+  pool->threads = g_ptr_array_sized_new (n_workers);
+  g_mutex_init (&pool->lock);
+  g_cond_init (&pool->cond);
+
+  for (i = 0; i < n_workers; i++)
+    {
+      worker = g_new (GdkGLWorker, 1);
+      worker->pool = pool;
+      worker->glcontext = glcontexts[i];
+
+      g_ptr_array_add (pool->threads,
+                       g_thread_new ("gdkglext-worker", gdk_gl_worker_main, worker));
+    }
+
+  g_free (glcontexts);
+
+  /* Jobs must not be accepted by a pool whose workers cannot run them. */
+  g_mutex_lock (&pool->lock);
+  while (pool->n_started < n_workers)
+    g_cond_wait (&pool->cond, &pool->lock);
+  g_mutex_unlock (&pool->lock);
+
+  if (pool->n_failed > 0)
+    {
+      g_warning ("cannot make the worker contexts current");
+      gdk_gl_worker_pool_stop (pool, n_workers - pool->n_failed);
+      return NULL;
+    }
+
+  return pool;
+}
+
+/**
+ * gdk_gl_worker_pool_push:
+ * @pool: a #GdkGLWorkerPool.
+ * @func: the job to run in a worker thread.
+ * @done_func: (allow-none): function to call when the job has completed,
+ *             or NULL.
+ * @user_data: data passed to @func and @done_func.
+ *
+ * Queues a job, typically a texture or buffer upload. @func runs in a
+ * worker thread with a worker context current. @done_func is then called
+ * from the thread-default main context of the caller, after the job's
+ * OpenGL commands have completed, so the uploaded objects can be used
+ * from any context in the share group.
+ **/
+void
+gdk_gl_worker_pool_push (GdkGLWorkerPool     *pool,
+                         GdkGLWorkerFunc      func,
+                         GdkGLWorkerDoneFunc  done_func,
+                         gpointer             user_data)
+{
+  GdkGLWorkerJob *job;
+
+  g_return_if_fail (pool != NULL);
+  g_return_if_fail (func != NULL);
+
+  job = g_slice_new (GdkGLWorkerJob);
+  job->func = func;
+  job->done_func = done_func;
+  job->user_data = user_data;
+  job->main_context = (done_func != NULL) ? g_main_context_ref_thread_default () : NULL;
+  job->glfence = NULL;
+
+  g_async_queue_push (pool->jobs, job);
+}
+
+/**
+ * gdk_gl_worker_pool_free:
+ * @pool: a #GdkGLWorkerPool.
+ *
+ * Runs the jobs that are still queued, then stops the worker threads
+ * and destroys their contexts.
+ **/
+void
+gdk_gl_worker_pool_free (GdkGLWorkerPool *pool)
+{
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_if_fail (pool != NULL);
+
+  gdk_gl_worker_pool_stop (pool, pool->threads->len);
+}
@@ -0,0 +1,64 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#if !defined (__GDKGL_H_INSIDE__) && !defined (GDK_GL_COMPILATION)
+#error "Only <gdk/gdkgl.h> can be included directly."
+#endif
+
+#ifndef __GDK_GL_WORKER_H__
+#define __GDK_GL_WORKER_H__
+
+#include <gdk/gdkgldefs.h>
+#include <gdk/gdkgltypes.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkGLWorkerPool GdkGLWorkerPool;
+
+/**
+ * GdkGLWorkerFunc:
+ * @glcontext: the worker's #GdkGLContext, which is current.
+ * @user_data: the data passed to gdk_gl_worker_pool_push().
+ *
+ * Runs a job in a worker thread.
+ */
+typedef void (*GdkGLWorkerFunc) (GdkGLContext *glcontext,
+                                 gpointer      user_data);
+
+/**
+ * GdkGLWorkerDoneFunc:
+ * @user_data: the data passed to gdk_gl_worker_pool_push().
+ *
+ * Called in the main context of the pushing thread once a job's OpenGL
+ * commands have completed.
+ */
+typedef void (*GdkGLWorkerDoneFunc) (gpointer user_data);
+
+GdkGLWorkerPool *gdk_gl_worker_pool_new  (GdkGLContext        *share_list,
+                                          guint                n_workers);
+
+void             gdk_gl_worker_pool_push (GdkGLWorkerPool     *pool,
+                                          GdkGLWorkerFunc      func,
+                                          GdkGLWorkerDoneFunc  done_func,
+                                          gpointer             user_data);
+
+void             gdk_gl_worker_pool_free (GdkGLWorkerPool     *pool);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_WORKER_H__ */
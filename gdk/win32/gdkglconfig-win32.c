@@ -230,6 +230,13 @@ gdk_gl_config_parse_attrib_list (const int             *attrib_list,
         	  pfd->cAccumAlphaBits = *(++p);
             ++i;
             break;
+          case GDK_GL_SAMPLE_BUFFERS:
+          case GDK_GL_SAMPLES:
+        	  /* Multisampling requires WGL_ARB_pixel_format and cannot be
+        	     requested with ChoosePixelFormat; skip the value. */
+            ++p;
+            ++i;
+            break;
         }
       ++p;
     }
@@ -604,6 +611,60 @@ _gdk_win32_gl_config_impl_new_from_pixel_format (GdkGLConfig *glconfig,
   return glconfig;
 }
 
+/*
+ * Returns a new GdkGLConfig for every window-capable RGBA pixel format.
+ */
+GList *
+_gdk_win32_gl_config_impl_list_for_screen (GdkScreen *screen)
+{
+  GdkGLConfig *glconfig;
+  GList *list = NULL;
+
+  HDC hdc;
+  PIXELFORMATDESCRIPTOR pfd;
+  int n_formats;
+  int i;
+
+  GDK_GL_NOTE_FUNC ();
+
+  /* Get DC. */
+  hdc = GetDC (NULL);
+  if (hdc == NULL)
+    {
+      g_warning ("cannot get DC");
+      return NULL;
+    }
+
+  /* Returns the maximum pixel format index. */
+  n_formats = DescribePixelFormat (hdc, 1, sizeof (pfd), &pfd);
+
+  for (i = 1; i <= n_formats; ++i)
+    {
+      if (DescribePixelFormat (hdc, i, sizeof (pfd), &pfd) == 0)
+        continue;
+
+      if (!(pfd.dwFlags & PFD_SUPPORT_OPENGL) ||
+          !(pfd.dwFlags & PFD_DRAW_TO_WINDOW) ||
+          pfd.iPixelType != PFD_TYPE_RGBA)
+        continue;
+
+      glconfig = g_object_new (GDK_TYPE_WIN32_GL_CONFIG, NULL);
+
+      if (_gdk_win32_gl_config_impl_new_from_pixel_format (glconfig, i) == NULL)
+        {
+          g_object_unref (glconfig);
+          continue;
+        }
+
+      list = g_list_prepend (list, glconfig);
+    }
+
+  /* Release DC. */
+  ReleaseDC (NULL, hdc);
+
+  return g_list_reverse (list);
+}
+
 static GdkGLWindow *
 _gdk_win32_gl_config_impl_create_gl_window (GdkGLConfig *glconfig,
                                             GdkWindow   *window,
@@ -66,6 +66,7 @@ GdkGLConfig *_gdk_win32_gl_config_impl_new_for_screen         (GdkGLConfig *glco
                                                                gsize      n_attribs);
 GdkGLConfig *_gdk_win32_gl_config_impl_new_from_pixel_format  (GdkGLConfig *glconfig,
                                                                int          pixel_format);
+GList       *_gdk_win32_gl_config_impl_list_for_screen        (GdkScreen   *screen);
 
 G_END_DECLS
 
@@ -48,6 +48,36 @@ G_DEFINE_TYPE (GdkGLContextImplWin32,              \
                gdk_gl_context_impl_win32,          \
                GDK_TYPE_GL_CONTEXT_IMPL)
 
+/*
+ * Per-thread record of the last binding made through make_current.
+ * The HGLRC is kept next to the GdkGLContext so that it can be compared
+ * with wglGetCurrentContext() without dereferencing the object.
+ */
+typedef struct
+{
+  HGLRC          hglrc;
+  GdkGLContext  *glcontext;
+} GdkGLContextBindingWin32;
+
+static GPrivate current_binding = G_PRIVATE_INIT (g_free);
+
+static void
+gdk_win32_gl_context_set_binding (HGLRC         hglrc,
+                                  GdkGLContext *glcontext)
+{
+  GdkGLContextBindingWin32 *binding;
+
+  binding = g_private_get (&current_binding);
+  if (binding == NULL)
+    {
+      binding = g_new0 (GdkGLContextBindingWin32, 1);
+      g_private_set (&current_binding, binding);
+    }
+
+  binding->hglrc = hglrc;
+  binding->glcontext = glcontext;
+}
+
 static void
 gdk_gl_context_impl_win32_init (GdkGLContextImplWin32 *self)
 {
@@ -67,6 +97,7 @@ static void
 _gdk_win32_gl_context_impl_destroy (GdkGLContext *glcontext)
 {
   GdkGLContextImplWin32 *impl = GDK_GL_CONTEXT_IMPL_WIN32 (glcontext->impl);
+  GdkGLContextBindingWin32 *binding;
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
@@ -83,6 +114,10 @@ _gdk_win32_gl_context_impl_destroy (GdkGLContext *glcontext)
       wglMakeCurrent (NULL, NULL);
     }
 
+  binding = g_private_get (&current_binding);
+  if (binding != NULL && binding->glcontext == glcontext)
+    gdk_win32_gl_context_set_binding (NULL, NULL);
+
   if (!impl->is_foreign)
     {
       GDK_GL_NOTE_FUNC_IMPL ("wglDeleteContext");
@@ -433,12 +468,14 @@ _gdk_win32_gl_context_impl_make_current (GdkGLContext *glcontext,
   if (!wglMakeCurrent (hdc, hglrc))
     {
       g_warning ("wglMakeCurrent() failed");
+      gdk_win32_gl_context_set_binding (NULL, NULL);
       _gdk_gl_context_set_gl_drawable (glcontext, NULL);
       /* currently unused. */
       /* _gdk_gl_context_set_gl_drawable_read (glcontext, NULL); */
       return FALSE;
     }
 
+  gdk_win32_gl_context_set_binding (hglrc, glcontext);
   _gdk_gl_context_set_gl_drawable (glcontext, draw);
   /* currently unused. */
   /* _gdk_gl_context_set_gl_drawable_read (glcontext, read); */
@@ -480,7 +517,8 @@ _gdk_win32_gl_context_impl_make_uncurrent (GdkGLContext *glcontext)
 GdkGLContext *
 _gdk_win32_gl_context_impl_get_current (void)
 {
-  static GdkGLContext *current = NULL;
+  GdkGLContextBindingWin32 *binding;
+  GdkGLContext *glcontext;
   HGLRC hglrc;
 
   GDK_GL_NOTE_FUNC ();
@@ -490,12 +528,16 @@ _gdk_win32_gl_context_impl_get_current (void)
   if (hglrc == NULL)
     return NULL;
 
-  if (current && GDK_GL_CONTEXT_HGLRC (current) == hglrc)
-    return current;
+  binding = g_private_get (&current_binding);
+  if (binding != NULL && binding->hglrc == hglrc)
+    return binding->glcontext;
 
-  current = gdk_gl_context_lookup (hglrc);
+  /* Made current behind our back, e.g. a foreign context. */
+  glcontext = gdk_gl_context_lookup (hglrc);
+  if (glcontext != NULL)
+    gdk_win32_gl_context_set_binding (hglrc, glcontext);
 
-  return current;
+  return glcontext;
 }
 
 static HGLRC
@@ -510,6 +552,8 @@ _gdk_win32_gl_context_impl_get_hglrc (GdkGLContext *glcontext)
  * GdkGLContext hash table.
  */
 
+G_LOCK_DEFINE_STATIC (gl_context_ht);
+
 static GHashTable *gl_context_ht = NULL;
 
 static void
@@ -521,6 +565,8 @@ gdk_gl_context_insert (GdkGLContext *glcontext)
 
   g_return_if_fail (GDK_IS_WIN32_GL_CONTEXT (glcontext));
 
+  G_LOCK (gl_context_ht);
+
   if (gl_context_ht == NULL)
     {
       GDK_GL_NOTE (MISC, g_message (" -- Create GL context hash table."));
@@ -534,6 +580,8 @@ gdk_gl_context_insert (GdkGLContext *glcontext)
   impl = GDK_GL_CONTEXT_IMPL_WIN32 (glcontext->impl);
 
   g_hash_table_insert (gl_context_ht, impl->hglrc, glcontext);
+
+  G_UNLOCK (gl_context_ht);
 }
 
 static void
@@ -545,8 +593,13 @@ gdk_gl_context_remove (GdkGLContext *glcontext)
 
   g_return_if_fail (GDK_IS_WIN32_GL_CONTEXT (glcontext));
 
+  G_LOCK (gl_context_ht);
+
   if (gl_context_ht == NULL)
-    return;
+    {
+      G_UNLOCK (gl_context_ht);
+      return;
+    }
 
   impl = GDK_GL_CONTEXT_IMPL_WIN32 (glcontext->impl);
 
@@ -558,15 +611,23 @@ gdk_gl_context_remove (GdkGLContext *glcontext)
       g_hash_table_destroy (gl_context_ht);
       gl_context_ht = NULL;
     }
+
+  G_UNLOCK (gl_context_ht);
 }
 
 static GdkGLContext *
 gdk_gl_context_lookup (HGLRC hglrc)
 {
+  GdkGLContext *glcontext = NULL;
+
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
-  if (gl_context_ht == NULL)
-    return NULL;
+  G_LOCK (gl_context_ht);
+
+  if (gl_context_ht != NULL)
+    glcontext = g_hash_table_lookup (gl_context_ht, hglrc);
+
+  G_UNLOCK (gl_context_ht);
 
-  return g_hash_table_lookup (gl_context_ht, hglrc);
+  return glcontext;
 }
@@ -20,12 +20,15 @@
 #include "config.h"
 #endif /* HAVE_CONFIG_H */
 
+#include <stdio.h>
 #include <string.h>
 
 #include "gdkglx.h"
 #include "gdkglprivate-x11.h"
 #include "gdkglconfig-x11.h"
+#include "gdkglconfigcache-x11.h"
 #include "gdkglwindow-x11.h"
+#include "gdkglpbuffer-x11.h"
 
 #include <gdk/gdk.h>
 
@@ -44,9 +47,14 @@
 static Display      *_gdk_x11_gl_config_impl_get_xdisplay       (GdkGLConfig *glconfig);
 static int           _gdk_x11_gl_config_impl_get_screen_number  (GdkGLConfig *glconfig);
 static XVisualInfo  *_gdk_x11_gl_config_impl_get_xvinfo         (GdkGLConfig *glconfig);
+static GLXFBConfig   _gdk_x11_gl_config_impl_get_fbconfig       (GdkGLConfig *glconfig);
 static GdkGLWindow  *_gdk_x11_gl_config_impl_create_gl_window   (GdkGLConfig *glconfig,
                                                                  GdkWindow   *window,
                                                                  const int   *attrib_list);
+static GdkGLPbuffer *_gdk_x11_gl_config_impl_create_gl_pbuffer  (GdkGLConfig *glconfig,
+                                                                 int          width,
+                                                                 int          height,
+                                                                 const int   *attrib_list);
 static GdkScreen    *_gdk_x11_gl_config_impl_get_screen         (GdkGLConfig *glconfig);
 static gboolean      _gdk_x11_gl_config_impl_get_attrib         (GdkGLConfig *glconfig,
                                                                  int          attribute,
@@ -66,6 +74,8 @@ gdk_gl_config_impl_x11_init (GdkGLConfigImplX11 *self)
   self->xdisplay = NULL;
   self->screen_num = 0;
   self->xvinfo = NULL;
+  self->fbconfig = NULL;
+  self->attrib_mask = 0;
   self->screen = 0;
 }
 
@@ -91,8 +101,10 @@ gdk_gl_config_impl_x11_class_init (GdkGLConfigImplX11Class *klass)
   klass->get_xdisplay      = _gdk_x11_gl_config_impl_get_xdisplay;
   klass->get_screen_number = _gdk_x11_gl_config_impl_get_screen_number;
   klass->get_xvinfo        = _gdk_x11_gl_config_impl_get_xvinfo;
+  klass->get_fbconfig      = _gdk_x11_gl_config_impl_get_fbconfig;
 
   klass->parent_class.create_gl_window = _gdk_x11_gl_config_impl_create_gl_window;
+  klass->parent_class.create_gl_pbuffer = _gdk_x11_gl_config_impl_create_gl_pbuffer;
   klass->parent_class.get_screen       = _gdk_x11_gl_config_impl_get_screen;
   klass->parent_class.get_attrib       = _gdk_x11_gl_config_impl_get_attrib;
   klass->parent_class.get_visual       = _gdk_x11_gl_config_impl_get_visual;
@@ -101,6 +113,183 @@ gdk_gl_config_impl_x11_class_init (GdkGLConfigImplX11Class *klass)
   object_class->finalize = gdk_gl_config_impl_x11_finalize;
 }
 
+/*
+ * Returns TRUE if both the server and the client library implement
+ * GLX 1.3, which is required for GLXFBConfigs.
+ */
+static gboolean
+gdk_x11_gl_query_fbconfig_support (Display *xdisplay)
+{
+  int major, minor;
+  const char *version;
+
+  if (!glXQueryVersion (xdisplay, &major, &minor))
+    return FALSE;
+
+  if (major < 1 || (major == 1 && minor < 3))
+    return FALSE;
+
+  version = glXGetClientString (xdisplay, GLX_VERSION);
+  if (version == NULL || sscanf (version, "%d.%d", &major, &minor) != 2)
+    return FALSE;
+
+  return (major > 1 || (major == 1 && minor >= 3));
+}
+
+/*
+ * Gets a configuration attribute from the GLXFBConfig if there is one,
+ * or from the X visual otherwise. Returns Success or a GLX error code.
+ */
+static int
+gdk_x11_gl_config_impl_get_config (GdkGLConfigImplX11 *x11_impl,
+                                   int                 attribute,
+                                   int                *value)
+{
+  int render_type;
+  int ret;
+
+  if (x11_impl->fbconfig == NULL)
+    return glXGetConfig (x11_impl->xdisplay, x11_impl->xvinfo, attribute, value);
+
+  switch (attribute)
+    {
+      case GLX_USE_GL:
+        /* FBConfigs are GLX configurations by definition */
+        *value = True;
+        return Success;
+
+      case GLX_RGBA:
+        /* not an FBConfig attribute; derive it from the render type */
+        ret = glXGetFBConfigAttrib (x11_impl->xdisplay, x11_impl->fbconfig,
+                                    GLX_RENDER_TYPE, &render_type);
+        if (ret == Success)
+          *value = (render_type & GLX_RGBA_BIT) ? True : False;
+        return ret;
+
+      default:
+        return glXGetFBConfigAttrib (x11_impl->xdisplay, x11_impl->fbconfig,
+                                     attribute, value);
+    }
+}
+
+/*
+ * Attributes stored in GdkGLConfigImplX11::attrib_values, in this order.
+ * Reading them all up front saves a GLX round-trip per attribute query,
+ * which is expensive with indirect rendering.
+ */
+static const int gdk_x11_gl_config_attribs[] =
+  {
+    GLX_USE_GL,
+    GLX_BUFFER_SIZE,
+    GLX_LEVEL,
+    GLX_RGBA,
+    GLX_DOUBLEBUFFER,
+    GLX_STEREO,
+    GLX_AUX_BUFFERS,
+    GLX_RED_SIZE,
+    GLX_GREEN_SIZE,
+    GLX_BLUE_SIZE,
+    GLX_ALPHA_SIZE,
+    GLX_DEPTH_SIZE,
+    GLX_STENCIL_SIZE,
+    GLX_ACCUM_RED_SIZE,
+    GLX_ACCUM_GREEN_SIZE,
+    GLX_ACCUM_BLUE_SIZE,
+    GLX_ACCUM_ALPHA_SIZE,
+    GLX_SAMPLE_BUFFERS,
+    GLX_SAMPLES,
+    GLX_CONFIG_CAVEAT,
+    GLX_X_VISUAL_TYPE,
+    GLX_TRANSPARENT_TYPE,
+    GLX_TRANSPARENT_INDEX_VALUE,
+    GLX_TRANSPARENT_RED_VALUE,
+    GLX_TRANSPARENT_GREEN_VALUE,
+    GLX_TRANSPARENT_BLUE_VALUE,
+    GLX_TRANSPARENT_ALPHA_VALUE,
+    GLX_DRAWABLE_TYPE,
+    GLX_RENDER_TYPE,
+    GLX_X_RENDERABLE,
+    GLX_FBCONFIG_ID,
+    GLX_VISUAL_ID,
+    GLX_SCREEN
+  };
+
+G_STATIC_ASSERT (G_N_ELEMENTS (gdk_x11_gl_config_attribs) == GDK_GL_CONFIG_IMPL_X11_N_ATTRIBS);
+
+static int
+gdk_x11_gl_config_attrib_index (int attribute)
+{
+  gsize i;
+
+  for (i = 0; i < G_N_ELEMENTS (gdk_x11_gl_config_attribs); ++i)
+    {
+      if (gdk_x11_gl_config_attribs[i] == attribute)
+        return i;
+    }
+
+  return -1;
+}
+
+static void
+gdk_x11_gl_config_impl_snapshot_attribs (GdkGLConfigImplX11 *x11_impl)
+{
+  gsize i;
+  int value;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  x11_impl->attrib_mask = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (gdk_x11_gl_config_attribs); ++i)
+    {
+      value = 0;
+
+      if (gdk_x11_gl_config_impl_get_config (x11_impl,
+                                             gdk_x11_gl_config_attribs[i],
+                                             &value) != Success)
+        continue;
+
+      x11_impl->attrib_values[i] = value;
+      x11_impl->attrib_mask |= G_GUINT64_CONSTANT (1) << i;
+    }
+
+  if (x11_impl->fbconfig == NULL)
+    {
+      /* Visuals don't report these, but we know them anyway. */
+      i = gdk_x11_gl_config_attrib_index (GLX_VISUAL_ID);
+      x11_impl->attrib_values[i] = x11_impl->xvinfo->visualid;
+      x11_impl->attrib_mask |= G_GUINT64_CONSTANT (1) << i;
+
+      i = gdk_x11_gl_config_attrib_index (GLX_SCREEN);
+      x11_impl->attrib_values[i] = x11_impl->screen_num;
+      x11_impl->attrib_mask |= G_GUINT64_CONSTANT (1) << i;
+    }
+}
+
+/*
+ * Looks up an attribute in the snapshot. Attributes which are not part
+ * of the snapshot are queried from the server.
+ */
+static gboolean
+gdk_x11_gl_config_impl_lookup_attrib (GdkGLConfigImplX11 *x11_impl,
+                                      int                 attribute,
+                                      int                *value)
+{
+  int i;
+
+  i = gdk_x11_gl_config_attrib_index (attribute);
+
+  if (i < 0)
+    return (gdk_x11_gl_config_impl_get_config (x11_impl, attribute, value) == Success);
+
+  if (!(x11_impl->attrib_mask & (G_GUINT64_CONSTANT (1) << i)))
+    return FALSE;
+
+  *value = x11_impl->attrib_values[i];
+
+  return TRUE;
+}
+
 static void
 gdk_x11_gl_config_impl_init_attrib (GdkGLConfig *glconfig)
 {
@@ -109,8 +298,10 @@ gdk_x11_gl_config_impl_init_attrib (GdkGLConfig *glconfig)
 
   x11_impl = GDK_GL_CONFIG_IMPL_X11 (glconfig->impl);
 
+  gdk_x11_gl_config_impl_snapshot_attribs (x11_impl);
+
 #define _GET_CONFIG(__attrib) \
-  glXGetConfig (x11_impl->xdisplay, x11_impl->xvinfo, __attrib, &value)
+  (value = 0, gdk_x11_gl_config_impl_lookup_attrib (x11_impl, __attrib, &value))
 
   /* RGBA mode? */
   _GET_CONFIG (GLX_RGBA);
@@ -148,67 +339,46 @@ gdk_x11_gl_config_impl_init_attrib (GdkGLConfig *glconfig)
   _GET_CONFIG (GLX_ACCUM_RED_SIZE);
   glconfig->impl->has_accum_buffer = value ? TRUE : FALSE;
 
-  /* Number of multisample buffers (not supported yet) */
-  glconfig->impl->n_sample_buffers = 0;
+  /* Number of multisample buffers */
+  _GET_CONFIG (GLX_SAMPLE_BUFFERS);
+  glconfig->impl->n_sample_buffers = value;
 
 #undef _GET_CONFIG
 }
 
+/*
+ * Converts a GdkGLExt attribute list into a GLX attribute list for either
+ * glXChooseVisual() or glXChooseFBConfig(). Boolean attributes are given
+ * without a value in GdkGLExt attribute lists; glXChooseFBConfig() expects
+ * explicit values and has different defaults, so these are filled in to
+ * select the same kind of configurations as glXChooseVisual().
+ */
 static int *
-glx_attrib_list_from_attrib_list (const gint *attrib_list, gsize n_attribs)
+glx_attrib_list_from_attrib_list (const gint *attrib_list,
+                                  gsize       n_attribs,
+                                  gboolean    for_fbconfig)
 {
-  static const guchar has_param[] =
-    {
-      [GDK_GL_BUFFER_SIZE]      = 1,
-      [GDK_GL_LEVEL]            = 1,
-      [GDK_GL_AUX_BUFFERS]      = 1,
-      [GDK_GL_RED_SIZE]         = 1,
-      [GDK_GL_GREEN_SIZE]       = 1,
-      [GDK_GL_BLUE_SIZE]        = 1,
-      [GDK_GL_ALPHA_SIZE]       = 1,
-      [GDK_GL_DEPTH_SIZE]       = 1,
-      [GDK_GL_STENCIL_SIZE]     = 1,
-      [GDK_GL_ACCUM_RED_SIZE]   = 1,
-      [GDK_GL_ACCUM_GREEN_SIZE] = 1,
-      [GDK_GL_ACCUM_BLUE_SIZE]  = 1,
-      [GDK_GL_ACCUM_ALPHA_SIZE] = 1
-    };
-
-  static const int glx_attrib_of_attrib[] =
-    {
-      [GDK_GL_USE_GL]           = GLX_USE_GL,
-      [GDK_GL_BUFFER_SIZE]      = GLX_BUFFER_SIZE,
-      [GDK_GL_LEVEL]            = GLX_LEVEL,
-      [GDK_GL_RGBA]             = GLX_RGBA,
-      [GDK_GL_DOUBLEBUFFER]     = GLX_DOUBLEBUFFER,
-      [GDK_GL_STEREO]           = GLX_STEREO,
-      [GDK_GL_AUX_BUFFERS]      = GLX_AUX_BUFFERS,
-      [GDK_GL_RED_SIZE]         = GLX_RED_SIZE,
-      [GDK_GL_GREEN_SIZE]       = GLX_GREEN_SIZE,
-      [GDK_GL_BLUE_SIZE]        = GLX_BLUE_SIZE,
-      [GDK_GL_ALPHA_SIZE]       = GLX_ALPHA_SIZE,
-      [GDK_GL_DEPTH_SIZE]       = GLX_DEPTH_SIZE,
-      [GDK_GL_STENCIL_SIZE]     = GLX_STENCIL_SIZE,
-      [GDK_GL_ACCUM_RED_SIZE]   = GLX_ACCUM_RED_SIZE,
-      [GDK_GL_ACCUM_GREEN_SIZE] = GLX_ACCUM_GREEN_SIZE,
-      [GDK_GL_ACCUM_BLUE_SIZE]  = GLX_ACCUM_BLUE_SIZE,
-      [GDK_GL_ACCUM_ALPHA_SIZE] = GLX_ACCUM_ALPHA_SIZE
-    };
-
   int *glx_attrib_list;
   gsize attrib_index;
   gsize glx_attrib_index;
+  gboolean has_doublebuffer = FALSE;
+  gboolean has_x_renderable = FALSE;
+  gboolean has_drawable_type = FALSE;
+  gboolean has_render_type = FALSE;
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
-  glx_attrib_list = g_malloc( sizeof(*glx_attrib_list)*(n_attribs+3) );
+  /* boolean attributes may expand to two entries, plus appended defaults */
+  glx_attrib_list = g_malloc( sizeof(*glx_attrib_list)*(2*n_attribs+9) );
 
   if (!glx_attrib_list)
     goto err_g_malloc;
 
   for (attrib_index = 0, glx_attrib_index = 0; (attrib_index < n_attribs) && attrib_list[attrib_index]; ++attrib_index)
     {
-      switch (attrib_list[attrib_index])
+      int attrib = attrib_list[attrib_index];
+
+      switch (attrib)
         {
           case GDK_GL_USE_GL:
             /* legacy from GLX 1.2 and always true; will be removed */
@@ -216,44 +386,273 @@ glx_attrib_list_from_attrib_list (const gint *attrib_list, gsize n_attribs)
             /* not supported anymore */
             break;
 
-          default:
-            glx_attrib_list[glx_attrib_index++] = glx_attrib_of_attrib[attrib_list[attrib_index]];
-            if ( has_param[attrib_list[attrib_index]] )
-              {
-                ++attrib_index;
-                if (attrib_index == n_attribs)
-                  goto err_n_attribs;
-                glx_attrib_list[glx_attrib_index++] = attrib_list[attrib_index];
-              }
+          case GDK_GL_DOUBLEBUFFER:
+            has_doublebuffer = TRUE;
+            /* fall through */
+          case GDK_GL_STEREO:
+            glx_attrib_list[glx_attrib_index++] = attrib;
+            if (for_fbconfig)
+              glx_attrib_list[glx_attrib_index++] = True;
+            break;
+
+          case GDK_GL_BUFFER_SIZE:
+          case GDK_GL_LEVEL:
+          case GDK_GL_AUX_BUFFERS:
+          case GDK_GL_RED_SIZE:
+          case GDK_GL_GREEN_SIZE:
+          case GDK_GL_BLUE_SIZE:
+          case GDK_GL_ALPHA_SIZE:
+          case GDK_GL_DEPTH_SIZE:
+          case GDK_GL_STENCIL_SIZE:
+          case GDK_GL_ACCUM_RED_SIZE:
+          case GDK_GL_ACCUM_GREEN_SIZE:
+          case GDK_GL_ACCUM_BLUE_SIZE:
+          case GDK_GL_ACCUM_ALPHA_SIZE:
+          case GDK_GL_SAMPLE_BUFFERS:
+          case GDK_GL_SAMPLES:
+            /* GDK_GL_* tokens have the same values as GLX_* tokens */
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            glx_attrib_list[glx_attrib_index++] = attrib;
+            glx_attrib_list[glx_attrib_index++] = attrib_list[attrib_index];
+            break;
+
+          case GDK_GL_CONFIG_CAVEAT:
+          case GDK_GL_X_VISUAL_TYPE:
+          case GDK_GL_TRANSPARENT_TYPE:
+          case GDK_GL_TRANSPARENT_INDEX_VALUE:
+          case GDK_GL_TRANSPARENT_RED_VALUE:
+          case GDK_GL_TRANSPARENT_GREEN_VALUE:
+          case GDK_GL_TRANSPARENT_BLUE_VALUE:
+          case GDK_GL_TRANSPARENT_ALPHA_VALUE:
+          case GDK_GL_DRAWABLE_TYPE:
+          case GDK_GL_RENDER_TYPE:
+          case GDK_GL_X_RENDERABLE:
+          case GDK_GL_FBCONFIG_ID:
+            /* FBConfig-specific; not understood by glXChooseVisual */
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
+            if (!for_fbconfig)
+              break;
+            if (attrib == GDK_GL_X_RENDERABLE)
+              has_x_renderable = TRUE;
+            else if (attrib == GDK_GL_DRAWABLE_TYPE)
+              has_drawable_type = TRUE;
+            else if (attrib == GDK_GL_RENDER_TYPE)
+              has_render_type = TRUE;
+            glx_attrib_list[glx_attrib_index++] = attrib;
+            glx_attrib_list[glx_attrib_index++] = attrib_list[attrib_index];
+            break;
+
+          case GDK_GL_VISUAL_ID:
+          case GDK_GL_SCREEN:
+            /* can be queried, but are ignored for selection */
+            if (++attrib_index == n_attribs)
+              goto err_attrib_list;
             break;
+
+          default:
+            g_warning ("unknown configuration attribute 0x%x", attrib);
+            goto err_attrib_list;
+        }
+    }
+
+  if (for_fbconfig)
+    {
+      /* glXChooseVisual only considers single-buffered visuals
+         if GLX_DOUBLEBUFFER is not specified */
+      if (!has_doublebuffer)
+        {
+          glx_attrib_list[glx_attrib_index++] = GLX_DOUBLEBUFFER;
+          glx_attrib_list[glx_attrib_index++] = False;
+        }
+      if (!has_x_renderable)
+        {
+          glx_attrib_list[glx_attrib_index++] = GLX_X_RENDERABLE;
+          glx_attrib_list[glx_attrib_index++] = True;
+        }
+      if (!has_drawable_type)
+        {
+          glx_attrib_list[glx_attrib_index++] = GLX_DRAWABLE_TYPE;
+          glx_attrib_list[glx_attrib_index++] = GLX_WINDOW_BIT;
         }
+      if (!has_render_type)
+        {
+          glx_attrib_list[glx_attrib_index++] = GLX_RENDER_TYPE;
+          glx_attrib_list[glx_attrib_index++] = GLX_RGBA_BIT;
+        }
+    }
+  else
+    {
+      glx_attrib_list[glx_attrib_index++] = GLX_RGBA;
+      glx_attrib_list[glx_attrib_index++] = GLX_USE_GL;
     }
 
-  glx_attrib_list[glx_attrib_index++] = GLX_RGBA;
-  glx_attrib_list[glx_attrib_index++] = GLX_USE_GL;
   glx_attrib_list[glx_attrib_index++] = None;
 
   return glx_attrib_list;
 
-err_n_attribs:
+err_attrib_list:
   g_free(glx_attrib_list);
 err_g_malloc:
   return NULL;
 }
 
+#ifdef G_ENABLE_DEBUG
+
+static void
+gdk_x11_gl_print_fbconfigs (Display     *xdisplay,
+                            GLXFBConfig *fbconfigs,
+                            int          nelements)
+{
+  static const struct {
+    int attrib;
+    const char *name;
+  } attribs[] = {
+    { GLX_VISUAL_ID,       "visual"  },
+    { GLX_CONFIG_CAVEAT,   "caveat"  },
+    { GLX_BUFFER_SIZE,     "color"   },
+    { GLX_ALPHA_SIZE,      "alpha"   },
+    { GLX_DEPTH_SIZE,      "depth"   },
+    { GLX_STENCIL_SIZE,    "stencil" },
+    { GLX_ACCUM_RED_SIZE,  "accum"   },
+    { GLX_AUX_BUFFERS,     "aux"     },
+    { GLX_DOUBLEBUFFER,    "double"  },
+    { GLX_SAMPLE_BUFFERS,  "msbuf"   },
+    { GLX_SAMPLES,         "samples" },
+    { GLX_DRAWABLE_TYPE,   "drawable"}
+  };
+  GString *str;
+  int i;
+  gsize j;
+  int value;
+
+  str = g_string_new (NULL);
+
+  for (i = 0; i < nelements; ++i)
+    {
+      value = 0;
+      glXGetFBConfigAttrib (xdisplay, fbconfigs[i], GLX_FBCONFIG_ID, &value);
+      g_string_printf (str, "0x%03x:", value);
+
+      for (j = 0; j < G_N_ELEMENTS (attribs); ++j)
+        {
+          value = 0;
+          glXGetFBConfigAttrib (xdisplay, fbconfigs[i], attribs[j].attrib, &value);
+          g_string_append_printf (str, " %s=0x%x", attribs[j].name, value);
+        }
+
+      g_message (" -- glXChooseFBConfig: %s", str->str);
+    }
+
+  g_string_free (str, TRUE);
+}
+
+#endif /* G_ENABLE_DEBUG */
+
+/*
+ * Picks a GLXFBConfig from the sorted list returned by glXChooseFBConfig.
+ * GLX sorts by caveat first, but drivers are not always strict about it,
+ * so skip configurations marked as GLX_SLOW_CONFIG unless nothing else
+ * matches. XVisualInfo returned in xvinfo_return should be freed by XFree ().
+ */
+static GLXFBConfig
+gdk_x11_gl_choose_fbconfig (Display      *xdisplay,
+                            int           screen_num,
+                            const int    *glx_attrib_list,
+                            XVisualInfo **xvinfo_return)
+{
+  GLXFBConfig *fbconfigs;
+  GLXFBConfig fbconfig = NULL;
+  XVisualInfo *xvinfo = NULL;
+  int nelements = 0;
+  int caveat;
+  int pass, i;
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXChooseFBConfig");
+
+  fbconfigs = glXChooseFBConfig (xdisplay, screen_num, glx_attrib_list, &nelements);
+  if (fbconfigs == NULL)
+    return NULL;
+
+  GDK_GL_NOTE (MISC, gdk_x11_gl_print_fbconfigs (xdisplay, fbconfigs, nelements));
+
+  for (pass = 0; pass < 2 && fbconfig == NULL; ++pass)
+    {
+      for (i = 0; i < nelements; ++i)
+        {
+          caveat = GLX_NONE;
+          glXGetFBConfigAttrib (xdisplay, fbconfigs[i], GLX_CONFIG_CAVEAT, &caveat);
+
+          if (pass == 0 && caveat == GLX_SLOW_CONFIG)
+            continue;
+
+          xvinfo = glXGetVisualFromFBConfig (xdisplay, fbconfigs[i]);
+          if (xvinfo != NULL)
+            {
+              fbconfig = fbconfigs[i];
+              break;
+            }
+        }
+    }
+
+  if (fbconfig != NULL && pass > 1)
+    GDK_GL_NOTE (MISC, g_message (" -- glXChooseFBConfig: only slow configs available"));
+
+  XFree (fbconfigs);
+
+  *xvinfo_return = xvinfo;
+
+  return fbconfig;
+}
+
+/*
+ * Instantiates the GdkGLConfigImplX11 object for a chosen visual and
+ * optional FBConfig. Takes ownership of xvinfo.
+ */
+static GdkGLConfig *
+gdk_x11_gl_config_impl_init_common (GdkGLConfig *glconfig,
+                                    GdkScreen   *screen,
+                                    XVisualInfo *xvinfo,
+                                    GLXFBConfig  fbconfig)
+{
+  GdkGLConfigImplX11 *x11_impl;
+
+  x11_impl = g_object_new (GDK_TYPE_GL_CONFIG_IMPL_X11, NULL);
+
+  x11_impl->xdisplay = GDK_SCREEN_XDISPLAY (screen);
+  x11_impl->screen_num = GDK_SCREEN_XNUMBER (screen);
+  x11_impl->xvinfo = xvinfo;
+  x11_impl->fbconfig = fbconfig;
+
+  x11_impl->screen = screen;
+
+  /*
+   * Init GdkGLConfig
+   */
+  glconfig->impl = GDK_GL_CONFIG_IMPL (x11_impl);
+
+  /*
+   * Init configuration attributes.
+   */
+
+  gdk_x11_gl_config_impl_init_attrib (glconfig);
+
+  return glconfig;
+}
+
 static GdkGLConfig *
 gdk_x11_gl_config_impl_new_common (GdkGLConfig *glconfig,
                                    GdkScreen *screen,
                                    const int *attrib_list,
                                    gsize n_attribs)
 {
-  GdkGLConfigImplX11 *x11_impl;
-
   Display *xdisplay;
   int screen_num;
   int *glx_attrib_list;
   XVisualInfo *xvinfo;
-  int is_rgba;
+  GLXFBConfig fbconfig = NULL;
+  gboolean use_fbconfig;
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
@@ -262,58 +661,60 @@ gdk_x11_gl_config_impl_new_common (GdkGLConfig *glconfig,
 
   GDK_GL_NOTE (MISC, _gdk_x11_gl_print_glx_info (xdisplay, screen_num));
 
+  use_fbconfig = gdk_x11_gl_query_fbconfig_support (xdisplay);
+
   /*
-   * Find an OpenGL-capable visual.
+   * Find an OpenGL-capable frame buffer configuration.
    */
 
-  glx_attrib_list = glx_attrib_list_from_attrib_list(attrib_list, n_attribs);
+  glx_attrib_list = glx_attrib_list_from_attrib_list(attrib_list, n_attribs, use_fbconfig);
 
   if (glx_attrib_list == NULL)
     goto err_glx_attrib_list_from_attrib_list;
 
-  GDK_GL_NOTE_FUNC_IMPL ("glXChooseVisual");
-
-  xvinfo = glXChooseVisual (xdisplay, screen_num, glx_attrib_list);
-
-  if (xvinfo == NULL)
-    goto err_glXChooseVisual;
-
-  GDK_GL_NOTE (MISC,
-    g_message (" -- glXChooseVisual: screen number = %d", xvinfo->screen));
-  GDK_GL_NOTE (MISC,
-    g_message (" -- glXChooseVisual: visual id = 0x%lx", xvinfo->visualid));
+  if (_gdk_x11_gl_config_cache_lookup (xdisplay, screen_num,
+                                       attrib_list, n_attribs, use_fbconfig,
+                                       &xvinfo, &fbconfig))
+    {
+      /* chosen on an earlier run against the same GLX implementation */
+    }
+  else if (use_fbconfig)
+    {
+      fbconfig = gdk_x11_gl_choose_fbconfig (xdisplay, screen_num, glx_attrib_list, &xvinfo);
 
-  /*
-   * Instantiate the GdkGLConfigImplX11 object.
-   */
+      if (fbconfig == NULL)
+        goto err_choose_config;
 
-  x11_impl = g_object_new (GDK_TYPE_GL_CONFIG_IMPL_X11, NULL);
+      _gdk_x11_gl_config_cache_store (xdisplay, screen_num,
+                                      attrib_list, n_attribs, xvinfo, fbconfig);
+    }
+  else
+    {
+      GDK_GL_NOTE_FUNC_IMPL ("glXChooseVisual");
 
-  x11_impl->xdisplay = xdisplay;
-  x11_impl->screen_num = screen_num;
-  x11_impl->xvinfo = xvinfo;
+      xvinfo = glXChooseVisual (xdisplay, screen_num, glx_attrib_list);
 
-  x11_impl->screen = screen;
+      if (xvinfo == NULL)
+        goto err_choose_config;
 
-  /* RGBA mode? */
-  glXGetConfig (xdisplay, xvinfo, GLX_RGBA, &is_rgba);
+      _gdk_x11_gl_config_cache_store (xdisplay, screen_num,
+                                      attrib_list, n_attribs, xvinfo, NULL);
+    }
 
-  /*
-   * Init GdkGLConfig
-   */
-  glconfig->impl = GDK_GL_CONFIG_IMPL (x11_impl);
+  GDK_GL_NOTE (MISC,
+    g_message (" -- Config: screen number = %d", xvinfo->screen));
+  GDK_GL_NOTE (MISC,
+    g_message (" -- Config: visual id = 0x%lx", xvinfo->visualid));
 
   /*
-   * Init configuration attributes.
+   * Instantiate the GdkGLConfigImplX11 object.
    */
 
-  gdk_x11_gl_config_impl_init_attrib (glconfig);
-
   g_free(glx_attrib_list);
 
-  return glconfig;
+  return gdk_x11_gl_config_impl_init_common (glconfig, screen, xvinfo, fbconfig);
 
-err_glXChooseVisual:
+err_choose_config:
   g_free(glx_attrib_list);
 err_glx_attrib_list_from_attrib_list:
   return NULL;
@@ -379,17 +780,58 @@ gdk_x11_gl_get_xvinfo (Display  *xdisplay,
   return xvinfo_list;
 }
 
+/*
+ * Looks up the GLXFBConfig associated with the given visual. Several
+ * configurations can share a visual; prefer one without a caveat.
+ */
+static GLXFBConfig
+gdk_x11_gl_get_fbconfig (Display  *xdisplay,
+                         int       screen_num,
+                         VisualID  xvisualid)
+{
+  GLXFBConfig *fbconfigs;
+  GLXFBConfig fbconfig = NULL;
+  int nelements = 0;
+  int value, caveat;
+  int i;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXGetFBConfigs");
+
+  fbconfigs = glXGetFBConfigs (xdisplay, screen_num, &nelements);
+  if (fbconfigs == NULL)
+    return NULL;
+
+  for (i = 0; i < nelements; ++i)
+    {
+      if (glXGetFBConfigAttrib (xdisplay, fbconfigs[i], GLX_VISUAL_ID, &value) != Success ||
+          (VisualID) value != xvisualid)
+        continue;
+
+      caveat = GLX_NONE;
+      glXGetFBConfigAttrib (xdisplay, fbconfigs[i], GLX_CONFIG_CAVEAT, &caveat);
+
+      if (fbconfig == NULL || caveat == GLX_NONE)
+        fbconfig = fbconfigs[i];
+      if (caveat == GLX_NONE)
+        break;
+    }
+
+  XFree (fbconfigs);
+
+  return fbconfig;
+}
+
 static GdkGLConfig *
 gdk_x11_gl_config_impl_new_from_visualid_common (GdkGLConfig *glconfig,
                                                  GdkScreen   *screen,
                                                  VisualID     xvisualid)
 {
-  GdkGLConfigImplX11 *x11_impl;
-
   Display *xdisplay;
   int screen_num;
   XVisualInfo *xvinfo;
-  int is_rgba;
+  GLXFBConfig fbconfig = NULL;
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
@@ -419,35 +861,14 @@ gdk_x11_gl_config_impl_new_from_visualid_common (GdkGLConfig *glconfig,
   GDK_GL_NOTE (MISC,
     g_message (" -- gdk_x11_gl_get_xvinfo: visual id = 0x%lx", xvinfo->visualid));
 
-  /*
-   * Instantiate the GdkGLConfigImplX11 object.
-   */
-
-  x11_impl = g_object_new (GDK_TYPE_GL_CONFIG_IMPL_X11, NULL);
-
-  g_return_val_if_fail(x11_impl != NULL, NULL);
-
-  x11_impl->xdisplay = xdisplay;
-  x11_impl->screen_num = screen_num;
-  x11_impl->xvinfo = xvinfo;
-  x11_impl->screen = screen;
-
-  /* RGBA mode? */
-  glXGetConfig (xdisplay, xvinfo, GLX_RGBA, &is_rgba);
+  if (gdk_x11_gl_query_fbconfig_support (xdisplay))
+    fbconfig = gdk_x11_gl_get_fbconfig (xdisplay, screen_num, xvinfo->visualid);
 
   /*
-   * Init GdkGLConfig
-   */
-
-  glconfig->impl = GDK_GL_CONFIG_IMPL (x11_impl);
-
-  /*
-   * Init configuration attributes.
+   * Instantiate the GdkGLConfigImplX11 object.
    */
 
-  gdk_x11_gl_config_impl_init_attrib (glconfig);
-
-  return glconfig;
+  return gdk_x11_gl_config_impl_init_common (glconfig, screen, xvinfo, fbconfig);
 }
 
 GdkGLConfig *
@@ -463,6 +884,102 @@ _gdk_x11_gl_config_impl_new_from_visualid_for_screen (GdkGLConfig *glconfig,
   return gdk_x11_gl_config_impl_new_from_visualid_common (glconfig, screen, xvisualid);
 }
 
+/*
+ * Returns a new GdkGLConfig for every window-capable RGBA configuration
+ * on the screen, in the order reported by GLX.
+ */
+GList *
+_gdk_x11_gl_config_impl_list_for_screen (GdkScreen *screen)
+{
+  Display *xdisplay;
+  int screen_num;
+  GList *list = NULL;
+  GdkGLConfig *glconfig;
+  XVisualInfo *xvinfo;
+  int nelements = 0;
+  int i;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_SCREEN (screen), NULL);
+
+  xdisplay = GDK_SCREEN_XDISPLAY (screen);
+  screen_num = GDK_SCREEN_XNUMBER (screen);
+
+  if (gdk_x11_gl_query_fbconfig_support (xdisplay))
+    {
+      GLXFBConfig *fbconfigs;
+      int x_renderable, drawable_type, render_type;
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXGetFBConfigs");
+
+      fbconfigs = glXGetFBConfigs (xdisplay, screen_num, &nelements);
+
+      for (i = 0; i < nelements; ++i)
+        {
+          x_renderable = drawable_type = render_type = 0;
+
+          glXGetFBConfigAttrib (xdisplay, fbconfigs[i], GLX_X_RENDERABLE, &x_renderable);
+          glXGetFBConfigAttrib (xdisplay, fbconfigs[i], GLX_DRAWABLE_TYPE, &drawable_type);
+          glXGetFBConfigAttrib (xdisplay, fbconfigs[i], GLX_RENDER_TYPE, &render_type);
+
+          if (!x_renderable ||
+              !(drawable_type & GLX_WINDOW_BIT) ||
+              !(render_type & GLX_RGBA_BIT))
+            continue;
+
+          xvinfo = glXGetVisualFromFBConfig (xdisplay, fbconfigs[i]);
+          if (xvinfo == NULL)
+            continue;
+
+          glconfig = g_object_new (GDK_TYPE_X11_GL_CONFIG, NULL);
+          list = g_list_prepend (list,
+                                 gdk_x11_gl_config_impl_init_common (glconfig, screen,
+                                                                     xvinfo, fbconfigs[i]));
+        }
+
+      if (fbconfigs != NULL)
+        XFree (fbconfigs);
+    }
+  else
+    {
+      XVisualInfo xvinfo_template;
+      XVisualInfo *xvinfo_list;
+      int use_gl, is_rgba;
+
+      xvinfo_template.screen = screen_num;
+
+      xvinfo_list = XGetVisualInfo (xdisplay,
+                                    VisualScreenMask,
+                                    &xvinfo_template,
+                                    &nelements);
+
+      for (i = 0; i < nelements; ++i)
+        {
+          use_gl = is_rgba = 0;
+
+          glXGetConfig (xdisplay, &xvinfo_list[i], GLX_USE_GL, &use_gl);
+          glXGetConfig (xdisplay, &xvinfo_list[i], GLX_RGBA, &is_rgba);
+
+          if (!use_gl || !is_rgba)
+            continue;
+
+          /* each config owns (and frees) its own XVisualInfo */
+          xvinfo = gdk_x11_gl_get_xvinfo (xdisplay, screen_num, xvinfo_list[i].visualid);
+
+          glconfig = g_object_new (GDK_TYPE_X11_GL_CONFIG, NULL);
+          list = g_list_prepend (list,
+                                 gdk_x11_gl_config_impl_init_common (glconfig, screen,
+                                                                     xvinfo, NULL));
+        }
+
+      if (xvinfo_list != NULL)
+        XFree (xvinfo_list);
+    }
+
+  return g_list_reverse (list);
+}
+
 static Display *
 _gdk_x11_gl_config_impl_get_xdisplay (GdkGLConfig *glconfig)
 {
@@ -487,6 +1004,14 @@ _gdk_x11_gl_config_impl_get_xvinfo (GdkGLConfig *glconfig)
   return GDK_GL_CONFIG_IMPL_X11 (glconfig->impl)->xvinfo;
 }
 
+static GLXFBConfig
+_gdk_x11_gl_config_impl_get_fbconfig (GdkGLConfig *glconfig)
+{
+  g_return_val_if_fail (GDK_IS_X11_GL_CONFIG (glconfig), NULL);
+
+  return GDK_GL_CONFIG_IMPL_X11 (glconfig->impl)->fbconfig;
+}
+
 static GdkGLWindow *
 _gdk_x11_gl_config_impl_create_gl_window (GdkGLConfig *glconfig,
                                           GdkWindow   *window,
@@ -513,6 +1038,36 @@ _gdk_x11_gl_config_impl_create_gl_window (GdkGLConfig *glconfig,
   return glwindow;
 }
 
+static GdkGLPbuffer *
+_gdk_x11_gl_config_impl_create_gl_pbuffer (GdkGLConfig *glconfig,
+                                           int          width,
+                                           int          height,
+                                           const int   *attrib_list)
+{
+  GdkGLPbuffer *glpbuffer;
+  GdkGLPbuffer *impl;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_CONFIG (glconfig), NULL);
+
+  glpbuffer = g_object_new (GDK_TYPE_X11_GL_PBUFFER, NULL);
+
+  g_return_val_if_fail(glpbuffer != NULL, NULL);
+
+  impl = _gdk_x11_gl_pbuffer_impl_new(glpbuffer,
+                                      glconfig,
+                                      width,
+                                      height,
+                                      attrib_list);
+  if (impl == NULL)
+    {
+      /* the config or the server may lack pbuffers; not a bug */
+      g_object_unref(glpbuffer);
+      return NULL;
+    }
+
+  return glpbuffer;
+}
+
 static GdkScreen *
 _gdk_x11_gl_config_impl_get_screen (GdkGLConfig *glconfig)
 {
@@ -527,15 +1082,12 @@ _gdk_x11_gl_config_impl_get_attrib (GdkGLConfig *glconfig,
                                     int         *value)
 {
   GdkGLConfigImplX11 *x11_impl;
-  int ret;
 
   g_return_val_if_fail (GDK_IS_X11_GL_CONFIG (glconfig), FALSE);
 
   x11_impl = GDK_GL_CONFIG_IMPL_X11 (glconfig->impl);
 
-  ret = glXGetConfig (x11_impl->xdisplay, x11_impl->xvinfo, attribute, value);
-
-  return (ret == Success);
+  return gdk_x11_gl_config_impl_lookup_attrib (x11_impl, attribute, value);
 }
 
 static GdkVisual *
@@ -21,6 +21,8 @@
 
 #include <gdk/gdkx.h>
 
+#include <GL/glx.h>
+
 #include <gdk/gdkglconfig.h>
 #include <gdk/gdkglconfigimpl.h>
 
@@ -36,6 +38,9 @@ typedef struct _GdkGLConfigImplX11Class GdkGLConfigImplX11Class;
 #define GDK_IS_GL_CONFIG_IMPL_X11_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_CONFIG_IMPL_X11))
 #define GDK_GL_CONFIG_IMPL_X11_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_CONFIG_IMPL_X11, GdkGLConfigImplX11Class))
 
+/* Number of attributes stored in GdkGLConfigImplX11::attrib_values */
+#define GDK_GL_CONFIG_IMPL_X11_N_ATTRIBS 33
+
 struct _GdkGLConfigImplX11
 {
   GdkGLConfigImpl parent_instance;
@@ -43,6 +48,11 @@ struct _GdkGLConfigImplX11
   Display *xdisplay;
   int screen_num;
   XVisualInfo *xvinfo;
+  GLXFBConfig fbconfig;         /* NULL if GLX 1.3 is not available */
+
+  /* attribute values read once when the config is created */
+  int attrib_values[GDK_GL_CONFIG_IMPL_X11_N_ATTRIBS];
+  guint64 attrib_mask;          /* bit i set if attrib_values[i] is valid */
 
   GdkScreen *screen;
 };
@@ -54,6 +64,7 @@ struct _GdkGLConfigImplX11Class
   Display*      (*get_xdisplay)      (GdkGLConfig  *glconfig);
   int           (*get_screen_number) (GdkGLConfig  *glconfig);
   XVisualInfo*  (*get_xvinfo)        (GdkGLConfig  *glconfig);
+  GLXFBConfig   (*get_fbconfig)      (GdkGLConfig  *glconfig);
 };
 
 GType gdk_gl_config_impl_x11_get_type (void);
@@ -68,6 +79,7 @@ GdkGLConfig *_gdk_x11_gl_config_impl_new_for_screen               (GdkGLConfig *
 GdkGLConfig *_gdk_x11_gl_config_impl_new_from_visualid_for_screen (GdkGLConfig *glconfig,
                                                                    GdkScreen   *screen,
                                                                    VisualID     xvisualid);
+GList       *_gdk_x11_gl_config_impl_list_for_screen              (GdkScreen   *screen);
 
 G_END_DECLS
 
@@ -0,0 +1,382 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gdkglx.h"
+#include "gdkglprivate-x11.h"
+#include "gdkglconfigcache-x11.h"
+
+/*
+ * Persistent config selection cache.
+ *
+ * The FBConfig ID (or visual ID without GLX 1.3) chosen for an attribute
+ * list is stored in $XDG_CACHE_HOME/gtkglext/glx-configs, one group per
+ * X display name. Each group records the server and client GLX vendor
+ * and version strings it was built with; if any of them changes, the
+ * whole group is dropped. A cached ID is checked with a single query
+ * before it is used, so a stale entry costs one round trip and falls
+ * back to a full choose.
+ *
+ * Changes only mark the cache dirty. It is written once from a low
+ * priority idle, so that choosing many configs at startup rewrites the
+ * file once, and again at exit if anything is still unsaved.
+ */
+
+G_LOCK_DEFINE_STATIC (config_cache);
+
+static GKeyFile *config_cache = NULL;
+static GHashTable *config_cache_checked_groups = NULL;
+static gboolean config_cache_dirty = FALSE;
+static guint config_cache_save_id = 0;
+static gboolean config_cache_save_at_exit = FALSE;
+
+static gchar *
+gdk_x11_gl_config_cache_get_path (void)
+{
+  return g_build_filename (g_get_user_cache_dir (), "gtkglext", "glx-configs", NULL);
+}
+
+static void
+gdk_x11_gl_config_cache_load (void)
+{
+  gchar *path;
+
+  if (config_cache != NULL)
+    return;
+
+  config_cache = g_key_file_new ();
+  config_cache_checked_groups = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                       g_free, NULL);
+
+  path = gdk_x11_gl_config_cache_get_path ();
+
+  /* A missing or corrupt file just means an empty cache. */
+  if (!g_key_file_load_from_file (config_cache, path, G_KEY_FILE_NONE, NULL))
+    GDK_GL_NOTE (MISC, g_message (" -- config disk cache: no usable %s", path));
+
+  g_free (path);
+}
+
+/*
+ * Writes the cache if it is dirty. The file is written without the lock
+ * held.
+ */
+static void
+gdk_x11_gl_config_cache_save (void)
+{
+  gchar *path, *dir;
+  gchar *data = NULL;
+  gsize length = 0;
+  GError *error = NULL;
+
+  G_LOCK (config_cache);
+
+  if (config_cache_dirty)
+    {
+      data = g_key_file_to_data (config_cache, &length, NULL);
+      config_cache_dirty = FALSE;
+    }
+
+  G_UNLOCK (config_cache);
+
+  if (data == NULL)
+    return;
+
+  path = gdk_x11_gl_config_cache_get_path ();
+  dir = g_path_get_dirname (path);
+
+  if (g_mkdir_with_parents (dir, 0700) != 0 ||
+      !g_file_set_contents (path, data, length, &error))
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- config disk cache: cannot write %s: %s",
+                   path, error ? error->message : "cannot create directory"));
+      g_clear_error (&error);
+    }
+
+  g_free (data);
+  g_free (dir);
+  g_free (path);
+}
+
+static gboolean
+gdk_x11_gl_config_cache_save_idle (gpointer data)
+{
+  G_LOCK (config_cache);
+  config_cache_save_id = 0;
+  G_UNLOCK (config_cache);
+
+  gdk_x11_gl_config_cache_save ();
+
+  return FALSE;
+}
+
+static void
+gdk_x11_gl_config_cache_save_atexit (void)
+{
+  gdk_x11_gl_config_cache_save ();
+}
+
+/*
+ * Marks the cache dirty and schedules a save. Must be called with the
+ * lock held.
+ */
+static void
+gdk_x11_gl_config_cache_queue_save (void)
+{
+  config_cache_dirty = TRUE;
+
+  if (config_cache_save_id == 0)
+    config_cache_save_id = g_idle_add_full (G_PRIORITY_LOW,
+                                            gdk_x11_gl_config_cache_save_idle,
+                                            NULL, NULL);
+
+  if (!config_cache_save_at_exit)
+    {
+      atexit (gdk_x11_gl_config_cache_save_atexit);
+      config_cache_save_at_exit = TRUE;
+    }
+}
+
+static gchar *
+gdk_x11_gl_config_cache_identity (Display *xdisplay,
+                                  int      screen_num)
+{
+  const char *server_vendor, *server_version;
+  const char *client_vendor, *client_version;
+
+  server_vendor = glXQueryServerString (xdisplay, screen_num, GLX_VENDOR);
+  server_version = glXQueryServerString (xdisplay, screen_num, GLX_VERSION);
+  client_vendor = glXGetClientString (xdisplay, GLX_VENDOR);
+  client_version = glXGetClientString (xdisplay, GLX_VERSION);
+
+  return g_strdup_printf ("%s|%s|%s|%s",
+                          server_vendor ? server_vendor : "",
+                          server_version ? server_version : "",
+                          client_vendor ? client_vendor : "",
+                          client_version ? client_version : "");
+}
+
+/*
+ * Returns the group for xdisplay, dropping its entries first if they were
+ * written for a different GLX implementation. The identity is compared
+ * once per process and display. Must be called with the lock held.
+ */
+static gchar *
+gdk_x11_gl_config_cache_get_group (Display *xdisplay,
+                                   int      screen_num)
+{
+  gchar *group;
+  gchar *identity, *stored;
+
+  gdk_x11_gl_config_cache_load ();
+
+  group = g_strdup (DisplayString (xdisplay));
+
+  if (g_hash_table_lookup (config_cache_checked_groups, group) != NULL)
+    return group;
+
+  identity = gdk_x11_gl_config_cache_identity (xdisplay, screen_num);
+  stored = g_key_file_get_string (config_cache, group, "identity", NULL);
+
+  if (stored == NULL || strcmp (stored, identity) != 0)
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- config disk cache: GLX changed, invalidating %s", group));
+
+      g_key_file_remove_group (config_cache, group, NULL);
+      g_key_file_set_string (config_cache, group, "identity", identity);
+    }
+
+  g_hash_table_insert (config_cache_checked_groups, g_strdup (group), GINT_TO_POINTER (TRUE));
+
+  g_free (stored);
+  g_free (identity);
+
+  return group;
+}
+
+static gchar *
+gdk_x11_gl_config_cache_key (int        screen_num,
+                             const int *attrib_list,
+                             gsize      n_attribs,
+                             gboolean   use_fbconfig)
+{
+  GString *key;
+  gsize i;
+
+  key = g_string_new (NULL);
+  g_string_printf (key, "s%d-%s", screen_num, use_fbconfig ? "fb" : "vis");
+
+  for (i = 0; i < n_attribs; ++i)
+    g_string_append_printf (key, "-%x", (unsigned int) attrib_list[i]);
+
+  return g_string_free (key, FALSE);
+}
+
+/*
+ * Looks up the config stored for attrib_list and checks that it still
+ * exists. On success, returns TRUE and an XVisualInfo that should be
+ * freed by XFree (), plus the GLXFBConfig if use_fbconfig is TRUE.
+ */
+gboolean
+_gdk_x11_gl_config_cache_lookup (Display      *xdisplay,
+                                 int           screen_num,
+                                 const int    *attrib_list,
+                                 gsize         n_attribs,
+                                 gboolean      use_fbconfig,
+                                 XVisualInfo **xvinfo_return,
+                                 GLXFBConfig  *fbconfig_return)
+{
+  XVisualInfo *xvinfo = NULL;
+  GLXFBConfig fbconfig = NULL;
+  gchar *group, *key;
+  gboolean found;
+  int id = 0;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (_gdk_gl_config_no_disk_cache)
+    return FALSE;
+
+  key = gdk_x11_gl_config_cache_key (screen_num, attrib_list, n_attribs, use_fbconfig);
+
+  G_LOCK (config_cache);
+
+  group = gdk_x11_gl_config_cache_get_group (xdisplay, screen_num);
+
+  found = g_key_file_has_key (config_cache, group, key, NULL);
+  if (found)
+    id = g_key_file_get_integer (config_cache, group, key, NULL);
+
+  G_UNLOCK (config_cache);
+
+  if (!found)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- config disk cache miss: %s", key));
+      goto out;
+    }
+
+  if (use_fbconfig)
+    {
+      const int glx_attrib_list[] = { GLX_FBCONFIG_ID, id, None };
+      GLXFBConfig *fbconfigs;
+      int nelements = 0;
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXChooseFBConfig");
+
+      fbconfigs = glXChooseFBConfig (xdisplay, screen_num, glx_attrib_list, &nelements);
+      if (fbconfigs != NULL)
+        {
+          if (nelements > 0)
+            {
+              fbconfig = fbconfigs[0];
+              xvinfo = glXGetVisualFromFBConfig (xdisplay, fbconfig);
+            }
+          XFree (fbconfigs);
+        }
+    }
+  else
+    {
+      XVisualInfo xvinfo_template;
+      int nitems_return = 0;
+
+      xvinfo_template.visualid = id;
+      xvinfo_template.screen = screen_num;
+
+      xvinfo = XGetVisualInfo (xdisplay,
+                               VisualIDMask | VisualScreenMask,
+                               &xvinfo_template,
+                               &nitems_return);
+    }
+
+  if (xvinfo == NULL)
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- config disk cache stale: %s", key));
+
+      G_LOCK (config_cache);
+      g_key_file_remove_key (config_cache, group, key, NULL);
+      gdk_x11_gl_config_cache_queue_save ();
+      G_UNLOCK (config_cache);
+
+      found = FALSE;
+      goto out;
+    }
+
+  GDK_GL_NOTE (MISC, g_message (" -- config disk cache hit: %s = 0x%x", key, id));
+
+  *xvinfo_return = xvinfo;
+  *fbconfig_return = fbconfig;
+
+ out:
+  g_free (group);
+  g_free (key);
+
+  return found;
+}
+
+/*
+ * Remembers the config chosen for attrib_list. fbconfig is NULL if the
+ * config was chosen without GLX 1.3.
+ */
+void
+_gdk_x11_gl_config_cache_store (Display     *xdisplay,
+                                int          screen_num,
+                                const int   *attrib_list,
+                                gsize        n_attribs,
+                                XVisualInfo *xvinfo,
+                                GLXFBConfig  fbconfig)
+{
+  gchar *group, *key;
+  int id;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (_gdk_gl_config_no_disk_cache)
+    return;
+
+  if (fbconfig != NULL)
+    {
+      if (glXGetFBConfigAttrib (xdisplay, fbconfig, GLX_FBCONFIG_ID, &id) != Success)
+        return;
+    }
+  else
+    {
+      id = (int) xvinfo->visualid;
+    }
+
+  key = gdk_x11_gl_config_cache_key (screen_num, attrib_list, n_attribs, fbconfig != NULL);
+
+  G_LOCK (config_cache);
+
+  group = gdk_x11_gl_config_cache_get_group (xdisplay, screen_num);
+
+  g_key_file_set_integer (config_cache, group, key, id);
+  gdk_x11_gl_config_cache_queue_save ();
+
+  G_UNLOCK (config_cache);
+
+  g_free (group);
+  g_free (key);
+}
@@ -0,0 +1,45 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifndef __GDK_GL_CONFIG_CACHE_X11_H__
+#define __GDK_GL_CONFIG_CACHE_X11_H__
+
+#include <gdk/gdkx.h>
+
+#include <GL/glx.h>
+
+G_BEGIN_DECLS
+
+gboolean _gdk_x11_gl_config_cache_lookup (Display      *xdisplay,
+                                          int           screen_num,
+                                          const int    *attrib_list,
+                                          gsize         n_attribs,
+                                          gboolean      use_fbconfig,
+                                          XVisualInfo **xvinfo_return,
+                                          GLXFBConfig  *fbconfig_return);
+
+void     _gdk_x11_gl_config_cache_store  (Display      *xdisplay,
+                                          int           screen_num,
+                                          const int    *attrib_list,
+                                          gsize         n_attribs,
+                                          XVisualInfo  *xvinfo,
+                                          GLXFBConfig   fbconfig);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_CONFIG_CACHE_X11_H__ */
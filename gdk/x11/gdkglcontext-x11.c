@@ -26,6 +26,7 @@
 #include "gdkglprivate-x11.h"
 #include "gdkglconfig-x11.h"
 #include "gdkglwindow-x11.h"
+#include "gdkglpbuffer-x11.h"
 #include "gdkglcontext-x11.h"
 
 static void          gdk_gl_context_insert (GdkGLContext *glcontext);
@@ -49,6 +50,51 @@ G_DEFINE_TYPE (GdkGLContextImplX11,             \
                gdk_gl_context_impl_x11,         \
                GDK_TYPE_GL_CONTEXT_IMPL)
 
+/*
+ * Per-thread record of the last binding made through make_current.
+ * The GLX context handle is kept next to the GdkGLContext so that it can
+ * be compared with glXGetCurrentContext() without dereferencing the
+ * object.
+ */
+typedef struct
+{
+  GLXContext     glxcontext;
+  GdkGLContext  *glcontext;
+  GdkGLDrawable *draw;
+  GdkGLDrawable *read;
+} GdkGLContextBindingX11;
+
+static GPrivate current_binding = G_PRIVATE_INIT (g_free);
+
+static GdkGLContextBindingX11 *
+gdk_x11_gl_context_get_binding (void)
+{
+  GdkGLContextBindingX11 *binding;
+
+  binding = g_private_get (&current_binding);
+  if (binding == NULL)
+    {
+      binding = g_new0 (GdkGLContextBindingX11, 1);
+      g_private_set (&current_binding, binding);
+    }
+
+  return binding;
+}
+
+static void
+gdk_x11_gl_context_set_binding (GLXContext     glxcontext,
+                                GdkGLContext  *glcontext,
+                                GdkGLDrawable *draw,
+                                GdkGLDrawable *read)
+{
+  GdkGLContextBindingX11 *binding = gdk_x11_gl_context_get_binding ();
+
+  binding->glxcontext = glxcontext;
+  binding->glcontext = glcontext;
+  binding->draw = draw;
+  binding->read = read;
+}
+
 static void
 gdk_gl_context_impl_x11_init (GdkGLContextImplX11 *self)
 {
@@ -63,12 +109,21 @@ gdk_gl_context_impl_x11_init (GdkGLContextImplX11 *self)
   self->gldrawable_read = NULL;
   self->is_destroyed = 0;
   self->is_foreign = 0;
+  self->is_no_error = 0;
+  self->major_version = 0;
+  self->minor_version = 0;
+  self->profile = GDK_GL_CONTEXT_PROFILE_DEFAULT;
+  self->flags = 0;
+  self->glxpbuffer = None;
+  self->is_surfaceless = 0;
+  self->is_share_list_weak = 0;
 }
 
 void
 _gdk_gl_context_destroy (GdkGLContext *glcontext)
 {
   GdkGLContextImplX11 *impl = GDK_GL_CONTEXT_IMPL_X11 (glcontext->impl);
+  GdkGLContextBindingX11 *binding;
   Display *xdisplay;
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
@@ -88,6 +143,10 @@ _gdk_gl_context_destroy (GdkGLContext *glcontext)
       glXMakeCurrent (xdisplay, None, NULL);
     }
 
+  binding = g_private_get (&current_binding);
+  if (binding != NULL && binding->glcontext == glcontext)
+    gdk_x11_gl_context_set_binding (NULL, NULL, NULL, NULL);
+
   if (!impl->is_foreign)
     {
       GDK_GL_NOTE_FUNC_IMPL ("glXDestroyContext");
@@ -95,6 +154,13 @@ _gdk_gl_context_destroy (GdkGLContext *glcontext)
       impl->glxcontext = NULL;
     }
 
+  if (impl->glxpbuffer != None)
+    {
+      GDK_GL_NOTE_FUNC_IMPL ("glXDestroyPbuffer");
+      glXDestroyPbuffer (xdisplay, impl->glxpbuffer);
+      impl->glxpbuffer = None;
+    }
+
   if (impl->gldrawable != NULL)
     {
       g_object_remove_weak_pointer (G_OBJECT (impl->gldrawable),
@@ -102,15 +168,12 @@ _gdk_gl_context_destroy (GdkGLContext *glcontext)
       impl->gldrawable = NULL;
     }
 
-  /* currently unused. */
-  /*
   if (impl->gldrawable_read != NULL)
     {
       g_object_remove_weak_pointer (G_OBJECT (impl->gldrawable_read),
                                     (gpointer *) &(impl->gldrawable_read));
       impl->gldrawable_read = NULL;
     }
-  */
 
   impl->is_destroyed = TRUE;
 }
@@ -127,7 +190,13 @@ gdk_gl_context_impl_x11_finalize (GObject *object)
   g_object_unref (G_OBJECT (impl->glconfig));
 
   if (impl->share_list != NULL)
-    g_object_unref (G_OBJECT (impl->share_list));
+    {
+      if (impl->is_share_list_weak)
+        g_object_remove_weak_pointer (G_OBJECT (impl->share_list),
+                                      (gpointer *) &(impl->share_list));
+      else
+        g_object_unref (G_OBJECT (impl->share_list));
+    }
 
   G_OBJECT_CLASS (gdk_gl_context_impl_x11_parent_class)->finalize (object);
 }
@@ -213,6 +282,108 @@ gdk_x11_gl_context_impl_new_common (GdkGLContext  *glcontext,
   return impl;
 }
 
+#ifndef GLX_ARB_create_context
+#define GLX_CONTEXT_MAJOR_VERSION_ARB             0x2091
+#define GLX_CONTEXT_MINOR_VERSION_ARB             0x2092
+#define GLX_CONTEXT_FLAGS_ARB                     0x2094
+#endif
+#ifndef GLX_ARB_create_context_profile
+#define GLX_CONTEXT_PROFILE_MASK_ARB              0x9126
+#endif
+#ifndef GLX_ARB_create_context_no_error
+#define GLX_CONTEXT_OPENGL_NO_ERROR_ARB           0x31B3
+#endif
+
+typedef GLXContext (*GdkGLXCreateContextAttribsARBProc) (Display     *dpy,
+                                                         GLXFBConfig  config,
+                                                         GLXContext   share_context,
+                                                         Bool         direct,
+                                                         const int   *attrib_list);
+
+/*
+ * Creates a context through GLX_ARB_create_context. Returns NULL if the
+ * implementation rejects the requested version, profile or flags.
+ */
+static GLXContext
+gdk_x11_gl_create_context_attribs (GdkGLConfig         *glconfig,
+                                   int                  render_type,
+                                   GLXContext           share_glxcontext,
+                                   Bool                 is_direct,
+                                   int                  major_version,
+                                   int                  minor_version,
+                                   GdkGLContextProfile  profile,
+                                   GdkGLContextFlags    flags)
+{
+  GdkGLXCreateContextAttribsARBProc create_context_attribs;
+  GLXContext glxcontext;
+  int attrib_list[13];
+  int n = 0;
+
+  create_context_attribs =
+    (GdkGLXCreateContextAttribsARBProc) gdk_gl_get_proc_address ("glXCreateContextAttribsARB");
+  if (create_context_attribs == NULL)
+    return NULL;
+
+  attrib_list[n++] = GLX_RENDER_TYPE;
+  attrib_list[n++] = render_type;
+  if (major_version > 0)
+    {
+      attrib_list[n++] = GLX_CONTEXT_MAJOR_VERSION_ARB;
+      attrib_list[n++] = major_version;
+      attrib_list[n++] = GLX_CONTEXT_MINOR_VERSION_ARB;
+      attrib_list[n++] = minor_version;
+    }
+  if (profile != GDK_GL_CONTEXT_PROFILE_DEFAULT)
+    {
+      if (gdk_x11_gl_query_glx_extension (glconfig, "GLX_ARB_create_context_profile"))
+        {
+          attrib_list[n++] = GLX_CONTEXT_PROFILE_MASK_ARB;
+          attrib_list[n++] = profile;
+        }
+      else
+        {
+          /* without the profile extension, 3.2+ contexts are core anyway */
+          GDK_GL_NOTE (MISC, g_message (" -- GLX_ARB_create_context_profile not supported"));
+        }
+    }
+  if (flags & GDK_GL_CONTEXT_NO_ERROR_BIT)
+    {
+      attrib_list[n++] = GLX_CONTEXT_OPENGL_NO_ERROR_ARB;
+      attrib_list[n++] = True;
+      flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+    }
+  if (flags != 0)
+    {
+      attrib_list[n++] = GLX_CONTEXT_FLAGS_ARB;
+      attrib_list[n++] = flags;
+    }
+  attrib_list[n] = None;
+
+  GDK_GL_NOTE (MISC,
+    g_message (" -- Context: version %d.%d, profile 0x%x, flags 0x%x",
+               major_version, minor_version, profile, flags));
+
+  /* An unsupported request is reported as an X error (GLXBadFBConfig,
+     BadMatch or BadValue); don't let it kill the application. */
+  gdk_error_trap_push ();
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXCreateContextAttribsARB");
+
+  glxcontext = create_context_attribs (GDK_GL_CONFIG_XDISPLAY (glconfig),
+                                       GDK_GL_CONFIG_FBCONFIG (glconfig),
+                                       share_glxcontext,
+                                       is_direct,
+                                       attrib_list);
+
+  if (gdk_error_trap_pop () != Success && glxcontext != NULL)
+    {
+      glXDestroyContext (GDK_GL_CONFIG_XDISPLAY (glconfig), glxcontext);
+      glxcontext = NULL;
+    }
+
+  return glxcontext;
+}
+
 /*< private >*/
 GdkGLContextImpl *
 _gdk_x11_gl_context_impl_new (GdkGLContext  *glcontext,
@@ -221,13 +392,37 @@ _gdk_x11_gl_context_impl_new (GdkGLContext  *glcontext,
                               gboolean       direct,
                               int            render_type)
 {
-  GdkGLConfig *glconfig;
+  return _gdk_x11_gl_context_impl_new_full (glcontext,
+                                            gldrawable,
+                                            share_list,
+                                            direct,
+                                            render_type,
+                                            0, 0,
+                                            GDK_GL_CONTEXT_PROFILE_DEFAULT,
+                                            0);
+}
+
+static GdkGLContextImpl *
+gdk_x11_gl_context_impl_create (GdkGLContext        *glcontext,
+                                GdkGLConfig         *glconfig,
+                                GdkGLContext        *share_list,
+                                gboolean             direct,
+                                int                  render_type,
+                                int                  major_version,
+                                int                  minor_version,
+                                GdkGLContextProfile  profile,
+                                GdkGLContextFlags    flags)
+{
   GdkGLContextImplX11 *share_impl = NULL;
   GLXContext share_glxcontext = NULL;
 
   Display *xdisplay;
   XVisualInfo *xvinfo;
+  GLXFBConfig fbconfig;
   GLXContext glxcontext;
+  Bool is_direct;
+  gboolean want_attribs, use_attribs;
+  GdkGLContextImpl *impl;
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
@@ -235,10 +430,9 @@ _gdk_x11_gl_context_impl_new (GdkGLContext  *glcontext,
    * Create an OpenGL rendering context.
    */
 
-  glconfig = gdk_gl_drawable_get_gl_config (gldrawable);
-
   xdisplay = GDK_GL_CONFIG_XDISPLAY (glconfig);
   xvinfo = GDK_GL_CONFIG_XVINFO (glconfig);
+  fbconfig = GDK_GL_CONFIG_FBCONFIG (glconfig);
 
   if (share_list != NULL && GDK_IS_GL_CONTEXT (share_list))
     {
@@ -246,23 +440,96 @@ _gdk_x11_gl_context_impl_new (GdkGLContext  *glcontext,
       share_glxcontext = share_impl->glxcontext;
     }
 
-  GDK_GL_NOTE_FUNC_IMPL ("glXCreateContext");
-
   if (_gdk_gl_context_force_indirect)
     {
       GDK_GL_NOTE (MISC, g_message (" -- Force indirect"));
 
-      glxcontext = glXCreateContext (xdisplay,
-                                     xvinfo,
-                                     share_glxcontext,
-                                     False);
+      is_direct = False;
+    }
+  else
+    {
+      is_direct = (direct == TRUE) ? True : False;
+    }
+
+  if (_gdk_gl_context_no_error)
+    flags |= GDK_GL_CONTEXT_NO_ERROR_BIT;
+
+  /* Contexts sharing objects must agree on the no-error mode. */
+  if (share_impl != NULL)
+    {
+      if (share_impl->is_no_error)
+        flags |= GDK_GL_CONTEXT_NO_ERROR_BIT;
+      else
+        flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+    }
+
+  if ((flags & GDK_GL_CONTEXT_NO_ERROR_BIT) &&
+      ((flags & GDK_GL_CONTEXT_DEBUG_BIT) ||
+       !gdk_x11_gl_query_glx_extension (glconfig, "GLX_ARB_create_context_no_error")))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- No-error context not available"));
+
+      flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+    }
+
+  want_attribs = (major_version > 0 ||
+                  profile != GDK_GL_CONTEXT_PROFILE_DEFAULT ||
+                  flags != 0);
+
+  use_attribs = (want_attribs &&
+                 fbconfig != NULL &&
+                 gdk_x11_gl_query_glx_extension (glconfig, "GLX_ARB_create_context"));
+
+  if (use_attribs)
+    {
+      glxcontext = gdk_x11_gl_create_context_attribs (glconfig,
+                                                      render_type,
+                                                      share_glxcontext,
+                                                      is_direct,
+                                                      major_version,
+                                                      minor_version,
+                                                      profile,
+                                                      flags);
+      if (glxcontext == NULL && (flags & GDK_GL_CONTEXT_NO_ERROR_BIT))
+        {
+          /* no-error is only a hint; retry with validation on */
+          GDK_GL_NOTE (MISC, g_message (" -- No-error context rejected"));
+
+          flags &= ~GDK_GL_CONTEXT_NO_ERROR_BIT;
+          glxcontext = gdk_x11_gl_create_context_attribs (glconfig,
+                                                          render_type,
+                                                          share_glxcontext,
+                                                          is_direct,
+                                                          major_version,
+                                                          minor_version,
+                                                          profile,
+                                                          flags);
+        }
+    }
+  else if (fbconfig != NULL)
+    {
+      if (want_attribs)
+        GDK_GL_NOTE (MISC, g_message (" -- GLX_ARB_create_context not supported"));
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXCreateNewContext");
+
+      glxcontext = glXCreateNewContext (xdisplay,
+                                        fbconfig,
+                                        render_type,
+                                        share_glxcontext,
+                                        is_direct);
     }
   else
     {
+      if (want_attribs)
+        GDK_GL_NOTE (MISC, g_message (" -- GLX_ARB_create_context not supported"));
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXCreateContext");
+
       glxcontext = glXCreateContext (xdisplay,
                                      xvinfo,
                                      share_glxcontext,
-                                     (direct == TRUE) ? True : False);
+                                     is_direct);
     }
   if (glxcontext == NULL)
     return NULL;
@@ -276,12 +543,241 @@ _gdk_x11_gl_context_impl_new (GdkGLContext  *glcontext,
    * Instantiate the GdkGLContextImplX11 object.
    */
 
-  return gdk_x11_gl_context_impl_new_common (glcontext,
+  impl = gdk_x11_gl_context_impl_new_common (glcontext,
                                              glconfig,
                                              share_list,
                                              render_type,
                                              glxcontext,
                                              FALSE);
+
+  /* only the attribs path can have honoured the flag */
+  GDK_GL_CONTEXT_IMPL_X11 (impl)->is_no_error =
+    (use_attribs && (flags & GDK_GL_CONTEXT_NO_ERROR_BIT)) ? TRUE : FALSE;
+
+  /* remembered so that worker contexts can match the request */
+  GDK_GL_CONTEXT_IMPL_X11 (impl)->major_version = major_version;
+  GDK_GL_CONTEXT_IMPL_X11 (impl)->minor_version = minor_version;
+  GDK_GL_CONTEXT_IMPL_X11 (impl)->profile = profile;
+  GDK_GL_CONTEXT_IMPL_X11 (impl)->flags = flags;
+
+  return impl;
+}
+
+/*< private >*/
+GdkGLContextImpl *
+_gdk_x11_gl_context_impl_new_full (GdkGLContext        *glcontext,
+                                   GdkGLDrawable       *gldrawable,
+                                   GdkGLContext        *share_list,
+                                   gboolean             direct,
+                                   int                  render_type,
+                                   int                  major_version,
+                                   int                  minor_version,
+                                   GdkGLContextProfile  profile,
+                                   GdkGLContextFlags    flags)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  return gdk_x11_gl_context_impl_create (glcontext,
+                                         gdk_gl_drawable_get_gl_config (gldrawable),
+                                         share_list,
+                                         direct,
+                                         render_type,
+                                         major_version,
+                                         minor_version,
+                                         profile,
+                                         flags);
+}
+
+/*
+ * Creates the 1x1 pbuffer that an offscreen context is bound to. Returns
+ * None if @glconfig is not a GLX 1.3 config that supports pbuffers.
+ */
+static GLXPbuffer
+gdk_x11_gl_create_hidden_pbuffer (GdkGLConfig *glconfig)
+{
+  Display *xdisplay;
+  GLXFBConfig fbconfig;
+  GLXPbuffer glxpbuffer;
+  int drawable_type;
+  static const int pbuffer_attribs[] = {
+    GLX_PBUFFER_WIDTH,  1,
+    GLX_PBUFFER_HEIGHT, 1,
+    None
+  };
+
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (glconfig);
+  fbconfig = GDK_GL_CONFIG_FBCONFIG (glconfig);
+
+  if (fbconfig == NULL ||
+      glXGetFBConfigAttrib (xdisplay, fbconfig, GLX_DRAWABLE_TYPE, &drawable_type) != Success ||
+      !(drawable_type & GLX_PBUFFER_BIT))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Config has no pbuffer support"));
+      return None;
+    }
+
+  gdk_error_trap_push ();
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXCreatePbuffer");
+
+  glxpbuffer = glXCreatePbuffer (xdisplay, fbconfig, pbuffer_attribs);
+
+  if (gdk_error_trap_pop () != Success)
+    return None;
+
+  return glxpbuffer;
+}
+
+/*
+ * Checks whether the server lets glxcontext be made current with no
+ * drawable; servers that do not allow it refuse with BadMatch. This
+ * uses a GDK error trap, so it is done once, by the thread creating the
+ * context, rather than on every bind from a worker thread. The calling
+ * thread's binding is restored afterwards.
+ */
+static gboolean
+gdk_x11_gl_context_probe_surfaceless (Display    *xdisplay,
+                                      GLXContext  glxcontext)
+{
+  Display *old_xdisplay;
+  GLXContext old_glxcontext;
+  GLXDrawable old_draw, old_read;
+  Bool ret;
+
+  old_xdisplay = glXGetCurrentDisplay ();
+  old_glxcontext = glXGetCurrentContext ();
+  old_draw = glXGetCurrentDrawable ();
+  old_read = glXGetCurrentReadDrawable ();
+
+  gdk_error_trap_push ();
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXMakeContextCurrent");
+
+  ret = glXMakeContextCurrent (xdisplay, None, None, glxcontext);
+
+  if (gdk_error_trap_pop () != Success)
+    ret = False;
+
+  if (old_glxcontext != NULL)
+    glXMakeContextCurrent (old_xdisplay, old_draw, old_read, old_glxcontext);
+  else
+    glXMakeContextCurrent (xdisplay, None, None, NULL);
+
+  return ret ? TRUE : FALSE;
+}
+
+/*< private >*/
+GdkGLContextImpl *
+_gdk_x11_gl_context_impl_new_offscreen (GdkGLContext        *glcontext,
+                                        GdkGLConfig         *glconfig,
+                                        GdkGLContext        *share_list,
+                                        gboolean             direct,
+                                        int                  render_type,
+                                        int                  major_version,
+                                        int                  minor_version,
+                                        GdkGLContextProfile  profile,
+                                        GdkGLContextFlags    flags)
+{
+  GdkGLContextImpl *impl;
+  GLXPbuffer glxpbuffer;
+  gboolean is_surfaceless = FALSE;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  g_return_val_if_fail (GDK_IS_X11_GL_CONFIG (glconfig), NULL);
+
+  /*
+   * An offscreen context is bound to a 1x1 pbuffer of its own. Without
+   * pbuffer support, GLX_ARB_create_context still lets OpenGL 3.0 and
+   * later contexts be made current with no drawable at all; they then
+   * have to render into framebuffer objects.
+   */
+
+  glxpbuffer = gdk_x11_gl_create_hidden_pbuffer (glconfig);
+  if (glxpbuffer == None)
+    {
+      if (major_version < 3 ||
+          GDK_GL_CONFIG_FBCONFIG (glconfig) == NULL ||
+          !gdk_x11_gl_query_glx_extension (glconfig, "GLX_ARB_create_context"))
+        return NULL;
+
+      GDK_GL_NOTE (MISC, g_message (" -- Surfaceless context"));
+
+      is_surfaceless = TRUE;
+    }
+
+  impl = gdk_x11_gl_context_impl_create (glcontext,
+                                         glconfig,
+                                         share_list,
+                                         direct,
+                                         render_type,
+                                         major_version,
+                                         minor_version,
+                                         profile,
+                                         flags);
+  if (impl == NULL)
+    {
+      if (glxpbuffer != None)
+        glXDestroyPbuffer (GDK_GL_CONFIG_XDISPLAY (glconfig), glxpbuffer);
+      return NULL;
+    }
+
+  if (is_surfaceless &&
+      !gdk_x11_gl_context_probe_surfaceless (GDK_GL_CONFIG_XDISPLAY (glconfig),
+                                             GDK_GL_CONTEXT_IMPL_X11 (impl)->glxcontext))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Surfaceless binding refused"));
+
+      _gdk_gl_context_destroy (glcontext);
+      return NULL;
+    }
+
+  GDK_GL_CONTEXT_IMPL_X11 (impl)->glxpbuffer = glxpbuffer;
+  GDK_GL_CONTEXT_IMPL_X11 (impl)->is_surfaceless = is_surfaceless;
+
+  return impl;
+}
+
+/*< private >*/
+GdkGLContextImpl *
+_gdk_x11_gl_context_impl_new_worker (GdkGLContext *glcontext,
+                                     GdkGLContext *share_list)
+{
+  GdkGLContextImplX11 *share_impl;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  g_return_val_if_fail (GDK_IS_X11_GL_CONTEXT (share_list), NULL);
+
+  share_impl = GDK_GL_CONTEXT_IMPL_X11 (share_list->impl);
+
+  return _gdk_x11_gl_context_impl_new_offscreen (glcontext,
+                                                 share_impl->glconfig,
+                                                 share_list,
+                                                 share_impl->is_direct,
+                                                 share_impl->render_type,
+                                                 share_impl->major_version,
+                                                 share_impl->minor_version,
+                                                 share_impl->profile,
+                                                 share_impl->flags);
+}
+
+/*< private >*/
+void
+_gdk_x11_gl_context_impl_weaken_share_list (GdkGLContext *glcontext)
+{
+  GdkGLContextImplX11 *impl = GDK_GL_CONTEXT_IMPL_X11 (glcontext->impl);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (impl->share_list == NULL || impl->is_share_list_weak)
+    return;
+
+  g_object_add_weak_pointer (G_OBJECT (impl->share_list),
+                             (gpointer *) &(impl->share_list));
+  g_object_unref (G_OBJECT (impl->share_list));
+
+  impl->is_share_list_weak = TRUE;
 }
 
 GdkGLContextImpl *
@@ -367,13 +863,11 @@ _gdk_x11_gl_context_impl_set_gl_drawable (GdkGLContext  *glcontext,
 }
 
 /*< private >*/
-/* currently unused. */
-/*
 void
-_gdk_gl_context_set_gl_drawable_read (GdkGLContext  *glcontext,
-                                      GdkGLDrawable *gldrawable_read)
+_gdk_x11_gl_context_impl_set_gl_drawable_read (GdkGLContext  *glcontext,
+                                               GdkGLDrawable *gldrawable_read)
 {
-  GdkGLContextImplX11 *impl = GDK_GL_CONTEXT_IMPL_X11 (glcontext);
+  GdkGLContextImplX11 *impl = GDK_GL_CONTEXT_IMPL_X11 (glcontext->impl);
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
@@ -394,7 +888,6 @@ _gdk_gl_context_set_gl_drawable_read (GdkGLContext  *glcontext,
                                  (gpointer *) &(impl->gldrawable_read));
     }
 }
-*/
 
 static GdkGLDrawable *
 _gdk_x11_gl_context_impl_get_gl_drawable (GdkGLContext *glcontext)
@@ -436,62 +929,160 @@ _gdk_x11_gl_context_impl_get_render_type (GdkGLContext *glcontext)
   return GDK_GL_CONTEXT_IMPL_X11 (glcontext->impl)->render_type;
 }
 
+/*
+ * Returns the GLX drawable behind @gldrawable, which is either a
+ * #GdkGLWindow or a #GdkGLPbuffer, and the config it was created with.
+ */
+static GLXDrawable
+gdk_x11_gl_drawable_get_glxdrawable (GdkGLDrawable  *gldrawable,
+                                     GdkGLConfig   **glconfig)
+{
+  GdkGLWindowImplX11 *window_impl;
+  GdkGLPbufferImplX11 *pbuffer_impl;
+
+  if (GDK_IS_X11_GL_PBUFFER (gldrawable))
+    {
+      pbuffer_impl = GDK_GL_PBUFFER_IMPL_X11 (GDK_GL_PBUFFER (gldrawable)->impl);
+      *glconfig = pbuffer_impl->glconfig;
+      return pbuffer_impl->glxpbuffer;
+    }
+
+  window_impl = GDK_GL_WINDOW_IMPL_X11 (GDK_GL_WINDOW (gldrawable)->impl);
+  *glconfig = window_impl->glconfig;
+  return window_impl->glxwindow;
+}
+
 static gboolean
 _gdk_x11_gl_context_impl_make_current (GdkGLContext  *glcontext,
                                        GdkGLDrawable *draw,
                                        GdkGLDrawable *read)
 {
-  GdkGLWindow *glwindow;
-  GdkGLWindowImplX11 *x11_impl;
+  GdkGLContextImplX11 *impl;
   GdkGLConfig *glconfig;
-  GdkWindow *window;
-  Window glxwindow;
+  GdkGLConfig *read_glconfig;
+  GdkGLContextBindingX11 *binding;
+  GdkWindow *window = NULL;
+  Display *xdisplay;
+  GLXDrawable glxwindow;
+  GLXDrawable glxwindow_read;
   GLXContext glxcontext;
+  Bool ret;
 
   g_return_val_if_fail (GDK_IS_X11_GL_CONTEXT (glcontext), FALSE);
-  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (draw), FALSE);
+  g_return_val_if_fail (draw == NULL ||
+                        GDK_IS_X11_GL_WINDOW (draw) ||
+                        GDK_IS_X11_GL_PBUFFER (draw), FALSE);
+  g_return_val_if_fail (read == NULL ||
+                        GDK_IS_X11_GL_WINDOW (read) ||
+                        GDK_IS_X11_GL_PBUFFER (read), FALSE);
+
+  impl = GDK_GL_CONTEXT_IMPL_X11 (glcontext->impl);
+  glxcontext = impl->glxcontext;
 
-  glwindow = GDK_GL_WINDOW(draw);
-  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
-  glconfig = x11_impl->glconfig;
-  window = gdk_gl_window_get_window(glwindow);
-  glxwindow = x11_impl->glxwindow;
-  glxcontext = GDK_GL_CONTEXT_GLXCONTEXT (glcontext);
+  if (read == NULL)
+    read = draw;
 
-  if (glxwindow == None || glxcontext == NULL)
+  if (draw == NULL)
+    {
+      /* offscreen contexts render to their own hidden pbuffer, or
+         to no drawable at all */
+      if (impl->glxpbuffer == None && !impl->is_surfaceless)
+        {
+          g_warning ("a draw drawable is required");
+          return FALSE;
+        }
+
+      glconfig = read_glconfig = impl->glconfig;
+      glxwindow = glxwindow_read = impl->glxpbuffer;
+    }
+  else
+    {
+      glxwindow = gdk_x11_gl_drawable_get_glxdrawable (draw, &glconfig);
+      glxwindow_read = gdk_x11_gl_drawable_get_glxdrawable (read, &read_glconfig);
+
+      if (GDK_IS_GL_WINDOW (draw))
+        window = gdk_gl_window_get_window (GDK_GL_WINDOW (draw));
+    }
+
+  if (glxcontext == NULL)
+    return FALSE;
+  if ((glxwindow == None || glxwindow_read == None) && !impl->is_surfaceless)
     return FALSE;
 
-  GDK_GL_NOTE (MISC,
-    g_message (" -- Window: screen number = %d",
-      GDK_SCREEN_XNUMBER (gdk_window_get_screen (window))));
-  GDK_GL_NOTE (MISC,
-    g_message (" -- Window: visual id = 0x%lx",
-      GDK_VISUAL_XVISUAL (gdk_window_get_visual (window))->visualid));
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (glconfig);
+
+  /* Rebinding the current pair makes some drivers flush and revalidate
+     the framebuffer. The GLX queries catch bindings changed behind our
+     back, e.g. by destroying the window. */
+  binding = g_private_get (&current_binding);
+  if (binding != NULL &&
+      binding->glcontext == glcontext &&
+      binding->draw == draw &&
+      binding->read == read &&
+      glXGetCurrentContext () == glxcontext &&
+      glXGetCurrentDrawable () == glxwindow &&
+      (glxwindow_read == glxwindow ||
+       glXGetCurrentReadDrawable () == glxwindow_read))
+    {
+      g_atomic_int_inc (&_gdk_gl_context_n_make_current_skipped);
+      return TRUE;
+    }
 
-  GDK_GL_NOTE_FUNC_IMPL ("glXMakeCurrent");
+  if (window != NULL)
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- Window: screen number = %d",
+          GDK_SCREEN_XNUMBER (gdk_window_get_screen (window))));
+      GDK_GL_NOTE (MISC,
+        g_message (" -- Window: visual id = 0x%lx",
+          GDK_VISUAL_XVISUAL (gdk_window_get_visual (window))->visualid));
+    }
 
-  if (!glXMakeCurrent (GDK_GL_CONFIG_XDISPLAY (glconfig), glxwindow, glxcontext))
+  if (glxwindow_read != glxwindow || draw == NULL)
+    {
+      /* Separate read drawables and pbuffers need GLX 1.3, which is
+         what an FBConfig tells us. */
+      if (GDK_GL_CONFIG_FBCONFIG (impl->glconfig) == NULL)
+        {
+          g_warning ("separate read drawable requires GLX 1.3");
+          return FALSE;
+        }
+
+      /* No GDK error trap: worker and fence watcher threads bind
+         offscreen contexts, and surfaceless support was checked when
+         the context was created. */
+      GDK_GL_NOTE_FUNC_IMPL ("glXMakeContextCurrent");
+
+      ret = glXMakeContextCurrent (xdisplay, glxwindow, glxwindow_read, glxcontext);
+    }
+  else
+    {
+      GDK_GL_NOTE_FUNC_IMPL ("glXMakeCurrent");
+
+      ret = glXMakeCurrent (xdisplay, glxwindow, glxcontext);
+    }
+
+  if (!ret)
     {
       g_warning ("glXMakeCurrent() failed");
+      gdk_x11_gl_context_set_binding (NULL, NULL, NULL, NULL);
       _gdk_x11_gl_context_impl_set_gl_drawable (glcontext, NULL);
-      /* currently unused. */
-      /* _gdk_gl_context_set_gl_drawable_read (glcontext, NULL); */
+      _gdk_x11_gl_context_impl_set_gl_drawable_read (glcontext, NULL);
       return FALSE;
     }
 
+  gdk_x11_gl_context_set_binding (glxcontext, glcontext, draw, read);
   _gdk_x11_gl_context_impl_set_gl_drawable (glcontext, draw);
-  /* currently unused. */
-  /* _gdk_gl_context_set_gl_drawable_read (glcontext, read); */
+  _gdk_x11_gl_context_impl_set_gl_drawable_read (glcontext, read);
 
-  if (_GDK_GL_CONFIG_AS_SINGLE_MODE (glconfig))
-    {
-      /* We do this because we are treating a double-buffered frame
-         buffer as a single-buffered frame buffer because the system
-         does not appear to export any suitable single-buffered
-         visuals (in which the following are necessary). */
-      glDrawBuffer (GL_FRONT);
-      glReadBuffer (GL_FRONT);
-    }
+  /* We do this because we are treating a double-buffered frame
+     buffer as a single-buffered frame buffer because the system
+     does not appear to export any suitable single-buffered
+     visuals (in which the following are necessary). */
+  if (glxwindow != None && _GDK_GL_CONFIG_AS_SINGLE_MODE (glconfig))
+    glDrawBuffer (GL_FRONT);
+  if (glxwindow_read != None && _GDK_GL_CONFIG_AS_SINGLE_MODE (read_glconfig))
+    glReadBuffer (GL_FRONT);
 
   GDK_GL_NOTE (MISC, _gdk_gl_print_gl_info ());
 
@@ -501,7 +1092,8 @@ _gdk_x11_gl_context_impl_make_current (GdkGLContext  *glcontext,
 GdkGLContext *
 _gdk_x11_gl_context_impl_get_current (void)
 {
-  static GdkGLContext *current = NULL;
+  GdkGLContextBindingX11 *binding;
+  GdkGLContext *glcontext;
   GLXContext glxcontext;
 
   GDK_GL_NOTE_FUNC ();
@@ -511,12 +1103,18 @@ _gdk_x11_gl_context_impl_get_current (void)
   if (glxcontext == NULL)
     return NULL;
 
-  if (current && GDK_GL_CONTEXT_GLXCONTEXT (current) == glxcontext)
-    return current;
+  binding = g_private_get (&current_binding);
+  if (binding != NULL && binding->glxcontext == glxcontext)
+    return binding->glcontext;
 
-  current = gdk_gl_context_lookup (glxcontext);
+  /* The context was made current behind our back (e.g. a foreign
+     context bound with glXMakeCurrent), so look it up once and
+     remember it for this thread. */
+  glcontext = gdk_gl_context_lookup (glxcontext);
+  if (glcontext != NULL)
+    gdk_x11_gl_context_set_binding (glxcontext, glcontext, NULL, NULL);
 
-  return current;
+  return glcontext;
 }
 
 GLXContext
@@ -531,6 +1129,8 @@ _gdk_x11_gl_context_impl_get_glxcontext (GdkGLContext *glcontext)
  * GdkGLContext hash table.
  */
 
+G_LOCK_DEFINE_STATIC (gl_context_ht);
+
 static GHashTable *gl_context_ht = NULL;
 
 static void
@@ -540,6 +1140,8 @@ gdk_gl_context_insert (GdkGLContext *glcontext)
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
+  G_LOCK (gl_context_ht);
+
   if (gl_context_ht == NULL)
     {
       GDK_GL_NOTE (MISC, g_message (" -- Create GL context hash table."));
@@ -555,6 +1157,8 @@ gdk_gl_context_insert (GdkGLContext *glcontext)
   impl = GDK_GL_CONTEXT_IMPL_X11 (glcontext->impl);
 
   g_hash_table_insert (gl_context_ht, impl->glxcontext, glcontext);
+
+  G_UNLOCK (gl_context_ht);
 }
 
 static void
@@ -564,8 +1168,13 @@ gdk_gl_context_remove (GdkGLContext *glcontext)
 
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
+  G_LOCK (gl_context_ht);
+
   if (gl_context_ht == NULL)
-    return;
+    {
+      G_UNLOCK (gl_context_ht);
+      return;
+    }
 
   impl = GDK_GL_CONTEXT_IMPL_X11 (glcontext->impl);
 
@@ -577,15 +1186,23 @@ gdk_gl_context_remove (GdkGLContext *glcontext)
       g_hash_table_destroy (gl_context_ht);
       gl_context_ht = NULL;
     }
+
+  G_UNLOCK (gl_context_ht);
 }
 
 static GdkGLContext *
 gdk_gl_context_lookup (GLXContext glxcontext)
 {
+  GdkGLContext *glcontext = NULL;
+
   GDK_GL_NOTE_FUNC_PRIVATE ();
 
-  if (gl_context_ht == NULL)
-    return NULL;
+  G_LOCK (gl_context_ht);
+
+  if (gl_context_ht != NULL)
+    glcontext = g_hash_table_lookup (gl_context_ht, glxcontext);
+
+  G_UNLOCK (gl_context_ht);
 
-  return g_hash_table_lookup (gl_context_ht, glxcontext);
+  return glcontext;
 }
@@ -48,10 +48,21 @@ struct _GdkGLContextImplX11
   GdkGLConfig *glconfig;
 
   GdkGLDrawable *gldrawable;
-  GdkGLDrawable *gldrawable_read; /* currently unused. */
+  GdkGLDrawable *gldrawable_read;
+
+  /* creation parameters, reused for worker contexts */
+  int major_version;
+  int minor_version;
+  GdkGLContextProfile profile;
+  GdkGLContextFlags flags;
+
+  GLXPbuffer glxpbuffer;          /* hidden drawable of offscreen contexts */
 
   guint is_destroyed : 1;
   guint is_foreign   : 1;
+  guint is_no_error  : 1;
+  guint is_surfaceless : 1;       /* offscreen context bound to no drawable */
+  guint is_share_list_weak : 1;   /* share_list is a weak pointer */
 };
 
 struct _GdkGLContextImplX11Class
@@ -69,6 +80,31 @@ GdkGLContextImpl *_gdk_x11_gl_context_impl_new (GdkGLContext  *glcontext,
                                                 gboolean       direct,
                                                 int            render_type);
 
+GdkGLContextImpl *_gdk_x11_gl_context_impl_new_full (GdkGLContext        *glcontext,
+                                                     GdkGLDrawable       *gldrawable,
+                                                     GdkGLContext        *share_list,
+                                                     gboolean             direct,
+                                                     int                  render_type,
+                                                     int                  major_version,
+                                                     int                  minor_version,
+                                                     GdkGLContextProfile  profile,
+                                                     GdkGLContextFlags    flags);
+
+GdkGLContextImpl *_gdk_x11_gl_context_impl_new_offscreen (GdkGLContext        *glcontext,
+                                                          GdkGLConfig         *glconfig,
+                                                          GdkGLContext        *share_list,
+                                                          gboolean             direct,
+                                                          int                  render_type,
+                                                          int                  major_version,
+                                                          int                  minor_version,
+                                                          GdkGLContextProfile  profile,
+                                                          GdkGLContextFlags    flags);
+
+GdkGLContextImpl *_gdk_x11_gl_context_impl_new_worker (GdkGLContext *glcontext,
+                                                       GdkGLContext *share_list);
+
+void _gdk_x11_gl_context_impl_weaken_share_list (GdkGLContext *glcontext);
+
 GdkGLContextImpl *_gdk_x11_gl_context_impl_new_from_glxcontext (GdkGLContext *glcontext,
                                                                 GdkGLConfig  *glconfig,
                                                                 GdkGLContext *share_list,
@@ -77,6 +113,9 @@ GdkGLContextImpl *_gdk_x11_gl_context_impl_new_from_glxcontext (GdkGLContext *gl
 void _gdk_x11_gl_context_impl_set_gl_drawable (GdkGLContext  *glcontext,
                                                GdkGLDrawable *gldrawable);
 
+void _gdk_x11_gl_context_impl_set_gl_drawable_read (GdkGLContext  *glcontext,
+                                                    GdkGLDrawable *gldrawable_read);
+
 GdkGLContext *
 _gdk_x11_gl_context_impl_get_current (void);
 
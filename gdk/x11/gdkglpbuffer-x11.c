@@ -0,0 +1,483 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <gdk/gdk.h>            /* for gdk_error_trap_(push|pop) () */
+
+#include "gdkglx.h"
+#include "gdkglprivate-x11.h"
+#include "gdkglconfig-x11.h"
+#include "gdkglcontext-x11.h"
+#include "gdkglpbuffer-x11.h"
+
+#include <gdk/gdkglquery.h>
+
+/* GLX_SGIX_fbconfig and GLX_SGIX_pbuffer, for GLX 1.2 servers */
+typedef GLXFBConfig (*GdkGLXGetFBConfigFromVisualSGIXProc) (Display     *dpy,
+                                                            XVisualInfo *vis);
+typedef GLXDrawable (*GdkGLXCreateGLXPbufferSGIXProc)      (Display      *dpy,
+                                                            GLXFBConfig   config,
+                                                            unsigned int  width,
+                                                            unsigned int  height,
+                                                            int          *attrib_list);
+typedef void        (*GdkGLXDestroyGLXPbufferSGIXProc)     (Display     *dpy,
+                                                            GLXDrawable  pbuf);
+typedef int         (*GdkGLXQueryGLXPbufferSGIXProc)       (Display      *dpy,
+                                                            GLXDrawable   pbuf,
+                                                            int           attribute,
+                                                            unsigned int *value);
+
+static GdkGLContext *_gdk_x11_gl_pbuffer_impl_create_gl_context  (GdkGLPbuffer *glpbuffer,
+                                                                  GdkGLContext *share_list,
+                                                                  gboolean      direct,
+                                                                  int           render_type);
+static GdkGLContext *_gdk_x11_gl_pbuffer_impl_create_gl_context_full (GdkGLPbuffer        *glpbuffer,
+                                                                      GdkGLContext        *share_list,
+                                                                      gboolean             direct,
+                                                                      int                  render_type,
+                                                                      int                  major_version,
+                                                                      int                  minor_version,
+                                                                      GdkGLContextProfile  profile,
+                                                                      GdkGLContextFlags    flags);
+static gboolean     _gdk_x11_gl_pbuffer_impl_is_double_buffered  (GdkGLPbuffer *glpbuffer);
+static void         _gdk_x11_gl_pbuffer_impl_swap_buffers        (GdkGLPbuffer *glpbuffer);
+static void         _gdk_x11_gl_pbuffer_impl_wait_gl             (GdkGLPbuffer *glpbuffer);
+static void         _gdk_x11_gl_pbuffer_impl_wait_gdk            (GdkGLPbuffer *glpbuffer);
+static GdkGLConfig *_gdk_x11_gl_pbuffer_impl_get_gl_config       (GdkGLPbuffer *glpbuffer);
+static GLXDrawable  _gdk_x11_gl_pbuffer_impl_get_glxpbuffer      (GdkGLPbuffer *glpbuffer);
+
+G_DEFINE_TYPE (GdkGLPbufferImplX11,
+               gdk_gl_pbuffer_impl_x11,
+               GDK_TYPE_GL_PBUFFER_IMPL);
+
+static void
+gdk_gl_pbuffer_impl_x11_init (GdkGLPbufferImplX11 *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  self->glxpbuffer = None;
+  self->glconfig = NULL;
+  self->is_sgix = 0;
+  self->is_destroyed = 0;
+}
+
+static void
+_gdk_x11_gl_pbuffer_impl_destroy (GdkGLPbuffer *glpbuffer)
+{
+  GdkGLPbufferImplX11 *x11_impl = GDK_GL_PBUFFER_IMPL_X11 (glpbuffer->impl);
+  Display *xdisplay;
+  GdkGLXDestroyGLXPbufferSGIXProc DestroyGLXPbufferSGIX;
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  if (x11_impl->is_destroyed)
+    return;
+
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig);
+
+  if (x11_impl->glxpbuffer == glXGetCurrentDrawable () ||
+      x11_impl->glxpbuffer == glXGetCurrentReadDrawable ())
+    {
+      glXWaitGL ();
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXMakeCurrent");
+      glXMakeCurrent (xdisplay, None, NULL);
+    }
+
+  if (x11_impl->is_sgix)
+    {
+      DestroyGLXPbufferSGIX = (GdkGLXDestroyGLXPbufferSGIXProc)
+        gdk_gl_get_proc_address ("glXDestroyGLXPbufferSGIX");
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXDestroyGLXPbufferSGIX");
+      if (DestroyGLXPbufferSGIX)
+        DestroyGLXPbufferSGIX (xdisplay, x11_impl->glxpbuffer);
+    }
+  else
+    {
+      GDK_GL_NOTE_FUNC_IMPL ("glXDestroyPbuffer");
+      glXDestroyPbuffer (xdisplay, x11_impl->glxpbuffer);
+    }
+
+  x11_impl->glxpbuffer = None;
+
+  x11_impl->is_destroyed = TRUE;
+}
+
+static void
+gdk_gl_pbuffer_impl_x11_finalize (GObject *object)
+{
+  GdkGLPbufferImplX11 *impl = GDK_GL_PBUFFER_IMPL_X11 (object);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  /* The pbuffer itself has been destroyed through
+     destroy_gl_pbuffer_impl by the owning GdkGLPbuffer. */
+  g_object_unref (G_OBJECT (impl->glconfig));
+
+  G_OBJECT_CLASS (gdk_gl_pbuffer_impl_x11_parent_class)->finalize (object);
+}
+
+static void
+gdk_gl_pbuffer_impl_x11_class_init (GdkGLPbufferImplX11Class *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  klass->get_glxpbuffer = _gdk_x11_gl_pbuffer_impl_get_glxpbuffer;
+
+  klass->parent_class.create_gl_context       = _gdk_x11_gl_pbuffer_impl_create_gl_context;
+  klass->parent_class.create_gl_context_full  = _gdk_x11_gl_pbuffer_impl_create_gl_context_full;
+  klass->parent_class.is_double_buffered      = _gdk_x11_gl_pbuffer_impl_is_double_buffered;
+  klass->parent_class.swap_buffers            = _gdk_x11_gl_pbuffer_impl_swap_buffers;
+  klass->parent_class.wait_gl                 = _gdk_x11_gl_pbuffer_impl_wait_gl;
+  klass->parent_class.wait_gdk                = _gdk_x11_gl_pbuffer_impl_wait_gdk;
+  klass->parent_class.get_gl_config           = _gdk_x11_gl_pbuffer_impl_get_gl_config;
+  klass->parent_class.destroy_gl_pbuffer_impl = _gdk_x11_gl_pbuffer_impl_destroy;
+
+  object_class->finalize = gdk_gl_pbuffer_impl_x11_finalize;
+}
+
+/*
+ * GLX 1.3 pbuffer.
+ */
+static GLXDrawable
+gdk_x11_gl_create_pbuffer (GdkGLConfig *glconfig,
+                           int          width,
+                           int          height,
+                           const int   *attrib_list,
+                           int         *actual_width,
+                           int         *actual_height)
+{
+  Display *xdisplay;
+  GLXFBConfig fbconfig;
+  GLXPbuffer glxpbuffer;
+  int drawable_type;
+  int glx_attrib_list[16];
+  unsigned int value;
+  int i, n = 0;
+
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (glconfig);
+  fbconfig = GDK_GL_CONFIG_FBCONFIG (glconfig);
+
+  if (glXGetFBConfigAttrib (xdisplay, fbconfig, GLX_DRAWABLE_TYPE, &drawable_type) != Success ||
+      !(drawable_type & GLX_PBUFFER_BIT))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- Config has no pbuffer support"));
+      return None;
+    }
+
+  glx_attrib_list[n++] = GLX_PBUFFER_WIDTH;
+  glx_attrib_list[n++] = width;
+  glx_attrib_list[n++] = GLX_PBUFFER_HEIGHT;
+  glx_attrib_list[n++] = height;
+
+  for (i = 0; attrib_list != NULL && attrib_list[i] != None; i += 2)
+    {
+      if (n + 3 > (int) G_N_ELEMENTS (glx_attrib_list))
+        break;
+
+      glx_attrib_list[n++] = attrib_list[i];
+      glx_attrib_list[n++] = attrib_list[i + 1];
+    }
+
+  glx_attrib_list[n] = None;
+
+  gdk_error_trap_push ();
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXCreatePbuffer");
+
+  glxpbuffer = glXCreatePbuffer (xdisplay, fbconfig, glx_attrib_list);
+
+  if (gdk_error_trap_pop () != Success || glxpbuffer == None)
+    return None;
+
+  /* GLX_LARGEST_PBUFFER may have given us less than we asked for. */
+  glXQueryDrawable (xdisplay, glxpbuffer, GLX_WIDTH, &value);
+  *actual_width = value;
+  glXQueryDrawable (xdisplay, glxpbuffer, GLX_HEIGHT, &value);
+  *actual_height = value;
+
+  return glxpbuffer;
+}
+
+/*
+ * GLX_SGIX_pbuffer, which takes the same attribute tokens.
+ */
+static GLXDrawable
+gdk_x11_gl_create_pbuffer_sgix (GdkGLConfig *glconfig,
+                                int          width,
+                                int          height,
+                                const int   *attrib_list,
+                                int         *actual_width,
+                                int         *actual_height)
+{
+  Display *xdisplay;
+  GLXFBConfig fbconfig;
+  GLXDrawable glxpbuffer;
+  GdkGLXGetFBConfigFromVisualSGIXProc GetFBConfigFromVisualSGIX;
+  GdkGLXCreateGLXPbufferSGIXProc CreateGLXPbufferSGIX;
+  GdkGLXQueryGLXPbufferSGIXProc QueryGLXPbufferSGIX;
+  int sgix_attrib_list[16];
+  unsigned int value;
+  int i, n = 0;
+
+  if (!gdk_x11_gl_query_glx_extension (glconfig, "GLX_SGIX_fbconfig") ||
+      !gdk_x11_gl_query_glx_extension (glconfig, "GLX_SGIX_pbuffer"))
+    {
+      GDK_GL_NOTE (MISC, g_message (" -- GLX_SGIX_pbuffer not supported"));
+      return None;
+    }
+
+  GetFBConfigFromVisualSGIX = (GdkGLXGetFBConfigFromVisualSGIXProc)
+    gdk_gl_get_proc_address ("glXGetFBConfigFromVisualSGIX");
+  CreateGLXPbufferSGIX = (GdkGLXCreateGLXPbufferSGIXProc)
+    gdk_gl_get_proc_address ("glXCreateGLXPbufferSGIX");
+  QueryGLXPbufferSGIX = (GdkGLXQueryGLXPbufferSGIXProc)
+    gdk_gl_get_proc_address ("glXQueryGLXPbufferSGIX");
+
+  if (GetFBConfigFromVisualSGIX == NULL ||
+      CreateGLXPbufferSGIX == NULL ||
+      QueryGLXPbufferSGIX == NULL)
+    return None;
+
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (glconfig);
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXGetFBConfigFromVisualSGIX");
+
+  fbconfig = GetFBConfigFromVisualSGIX (xdisplay, GDK_GL_CONFIG_XVINFO (glconfig));
+  if (fbconfig == NULL)
+    return None;
+
+  /* the SGIX entry point does not take a const list */
+  for (i = 0; attrib_list != NULL && attrib_list[i] != None; i += 2)
+    {
+      if (n + 3 > (int) G_N_ELEMENTS (sgix_attrib_list))
+        break;
+
+      sgix_attrib_list[n++] = attrib_list[i];
+      sgix_attrib_list[n++] = attrib_list[i + 1];
+    }
+
+  sgix_attrib_list[n] = None;
+
+  gdk_error_trap_push ();
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXCreateGLXPbufferSGIX");
+
+  glxpbuffer = CreateGLXPbufferSGIX (xdisplay, fbconfig,
+                                     width, height,
+                                     sgix_attrib_list);
+
+  if (gdk_error_trap_pop () != Success || glxpbuffer == None)
+    return None;
+
+  QueryGLXPbufferSGIX (xdisplay, glxpbuffer, GDK_GL_WIDTH, &value);
+  *actual_width = value;
+  QueryGLXPbufferSGIX (xdisplay, glxpbuffer, GDK_GL_HEIGHT, &value);
+  *actual_height = value;
+
+  return glxpbuffer;
+}
+
+/*
+ * attrib_list may hold GLX_PRESERVED_CONTENTS and GLX_LARGEST_PBUFFER.
+ * See GLX 1.3 spec.
+ */
+GdkGLPbuffer *
+_gdk_x11_gl_pbuffer_impl_new (GdkGLPbuffer *glpbuffer,
+                              GdkGLConfig  *glconfig,
+                              int           width,
+                              int           height,
+                              const int    *attrib_list)
+{
+  GdkGLPbufferImplX11 *x11_impl;
+  GLXDrawable glxpbuffer;
+  gboolean is_sgix;
+  int actual_width = width;
+  int actual_height = height;
+
+  GDK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer), NULL);
+  g_return_val_if_fail (GDK_IS_X11_GL_CONFIG (glconfig), NULL);
+
+  /*
+   * Create the GLX pbuffer. An FBConfig means GLX 1.3; older servers
+   * may still offer the SGIX extensions it grew out of.
+   */
+
+  is_sgix = (GDK_GL_CONFIG_FBCONFIG (glconfig) == NULL);
+
+  if (!is_sgix)
+    glxpbuffer = gdk_x11_gl_create_pbuffer (glconfig, width, height, attrib_list,
+                                            &actual_width, &actual_height);
+  else
+    glxpbuffer = gdk_x11_gl_create_pbuffer_sgix (glconfig, width, height, attrib_list,
+                                                 &actual_width, &actual_height);
+
+  if (glxpbuffer == None)
+    return NULL;
+
+  GDK_GL_NOTE (MISC,
+    g_message (" -- Pbuffer: %dx%d", actual_width, actual_height));
+
+  /*
+   * Instantiate the GdkGLPbufferImplX11 object.
+   */
+
+  x11_impl = g_object_new (GDK_TYPE_GL_PBUFFER_IMPL_X11, NULL);
+
+  x11_impl->glxpbuffer = glxpbuffer;
+  x11_impl->glconfig = glconfig;
+  g_object_ref (G_OBJECT (x11_impl->glconfig));
+
+  x11_impl->is_sgix = is_sgix;
+  x11_impl->is_destroyed = FALSE;
+
+  glpbuffer->impl = GDK_GL_PBUFFER_IMPL (x11_impl);
+  glpbuffer->width = actual_width;
+  glpbuffer->height = actual_height;
+
+  return glpbuffer;
+}
+
+static GdkGLContext *
+_gdk_x11_gl_pbuffer_impl_create_gl_context (GdkGLPbuffer *glpbuffer,
+                                            GdkGLContext *share_list,
+                                            gboolean      direct,
+                                            int           render_type)
+{
+  GdkGLContext *glcontext;
+  GdkGLContextImpl *impl;
+
+  glcontext = g_object_new (GDK_TYPE_X11_GL_CONTEXT, NULL);
+
+  g_return_val_if_fail (glcontext != NULL, NULL);
+
+  impl = _gdk_x11_gl_context_impl_new (glcontext,
+                                       GDK_GL_DRAWABLE (glpbuffer),
+                                       share_list,
+                                       direct,
+                                       render_type);
+  if (impl == NULL)
+    g_object_unref (glcontext);
+
+  g_return_val_if_fail (impl != NULL, NULL);
+
+  return glcontext;
+}
+
+static GdkGLContext *
+_gdk_x11_gl_pbuffer_impl_create_gl_context_full (GdkGLPbuffer        *glpbuffer,
+                                                 GdkGLContext        *share_list,
+                                                 gboolean             direct,
+                                                 int                  render_type,
+                                                 int                  major_version,
+                                                 int                  minor_version,
+                                                 GdkGLContextProfile  profile,
+                                                 GdkGLContextFlags    flags)
+{
+  GdkGLContext *glcontext;
+  GdkGLContextImpl *impl;
+
+  glcontext = g_object_new (GDK_TYPE_X11_GL_CONTEXT, NULL);
+
+  g_return_val_if_fail (glcontext != NULL, NULL);
+
+  impl = _gdk_x11_gl_context_impl_new_full (glcontext,
+                                            GDK_GL_DRAWABLE (glpbuffer),
+                                            share_list,
+                                            direct,
+                                            render_type,
+                                            major_version,
+                                            minor_version,
+                                            profile,
+                                            flags);
+  if (impl == NULL)
+    {
+      /* the requested version may simply be unsupported; not a bug */
+      g_object_unref (glcontext);
+      return NULL;
+    }
+
+  return glcontext;
+}
+
+static gboolean
+_gdk_x11_gl_pbuffer_impl_is_double_buffered (GdkGLPbuffer *glpbuffer)
+{
+  g_return_val_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer), FALSE);
+
+  return gdk_gl_config_is_double_buffered (GDK_GL_PBUFFER_IMPL_X11 (glpbuffer->impl)->glconfig);
+}
+
+static void
+_gdk_x11_gl_pbuffer_impl_swap_buffers (GdkGLPbuffer *glpbuffer)
+{
+  Display *xdisplay;
+  GLXDrawable glxpbuffer;
+
+  g_return_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer));
+
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (GDK_GL_PBUFFER_IMPL_X11 (glpbuffer->impl)->glconfig);
+  glxpbuffer = GDK_GL_PBUFFER_IMPL_X11 (glpbuffer->impl)->glxpbuffer;
+
+  if (glxpbuffer == None)
+    return;
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXSwapBuffers");
+
+  glXSwapBuffers (xdisplay, glxpbuffer);
+}
+
+static void
+_gdk_x11_gl_pbuffer_impl_wait_gl (GdkGLPbuffer *glpbuffer)
+{
+  g_return_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer));
+
+  glXWaitGL ();
+}
+
+static void
+_gdk_x11_gl_pbuffer_impl_wait_gdk (GdkGLPbuffer *glpbuffer)
+{
+  g_return_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer));
+
+  glXWaitX ();
+}
+
+static GdkGLConfig *
+_gdk_x11_gl_pbuffer_impl_get_gl_config (GdkGLPbuffer *glpbuffer)
+{
+  g_return_val_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer), NULL);
+
+  return GDK_GL_PBUFFER_IMPL_X11 (glpbuffer->impl)->glconfig;
+}
+
+static GLXDrawable
+_gdk_x11_gl_pbuffer_impl_get_glxpbuffer (GdkGLPbuffer *glpbuffer)
+{
+  g_return_val_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer), None);
+
+  return GDK_GL_PBUFFER_IMPL_X11 (glpbuffer->impl)->glxpbuffer;
+}
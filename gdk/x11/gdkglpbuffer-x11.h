@@ -0,0 +1,70 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifndef __GDK_GL_PBUFFER_X11_H__
+#define __GDK_GL_PBUFFER_X11_H__
+
+#include <gdk/gdkx.h>
+
+#include <gdk/gdkglpbuffer.h>
+#include <gdk/gdkglpbufferimpl.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GdkGLPbufferImplX11      GdkGLPbufferImplX11;
+typedef struct _GdkGLPbufferImplX11Class GdkGLPbufferImplX11Class;
+
+#define GDK_TYPE_GL_PBUFFER_IMPL_X11              (gdk_gl_pbuffer_impl_x11_get_type ())
+#define GDK_GL_PBUFFER_IMPL_X11(object)           (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_GL_PBUFFER_IMPL_X11, GdkGLPbufferImplX11))
+#define GDK_GL_PBUFFER_IMPL_X11_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_GL_PBUFFER_IMPL_X11, GdkGLPbufferImplX11Class))
+#define GDK_IS_GL_PBUFFER_IMPL_X11(object)        (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_GL_PBUFFER_IMPL_X11))
+#define GDK_IS_GL_PBUFFER_IMPL_X11_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_GL_PBUFFER_IMPL_X11))
+#define GDK_GL_PBUFFER_IMPL_X11_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_GL_PBUFFER_IMPL_X11, GdkGLPbufferImplX11Class))
+
+struct _GdkGLPbufferImplX11
+{
+  GdkGLPbufferImpl parent_instance;
+
+  /* GLXPbuffer or GLXPbufferSGIX */
+  GLXDrawable glxpbuffer;
+
+  GdkGLConfig *glconfig;
+
+  guint is_sgix : 1;
+  guint is_destroyed : 1;
+};
+
+struct _GdkGLPbufferImplX11Class
+{
+  GdkGLPbufferImplClass parent_class;
+
+  GLXDrawable (*get_glxpbuffer) (GdkGLPbuffer *glpbuffer);
+};
+
+GType gdk_gl_pbuffer_impl_x11_get_type (void);
+
+GdkGLPbuffer *
+_gdk_x11_gl_pbuffer_impl_new (GdkGLPbuffer *glpbuffer,
+                              GdkGLConfig  *glconfig,
+                              int           width,
+                              int           height,
+                              const int    *attrib_list);
+
+G_END_DECLS
+
+#endif /* __GDK_GL_PBUFFER_X11_H__ */
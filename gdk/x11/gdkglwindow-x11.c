@@ -22,6 +22,8 @@
 
 #include <string.h>
 
+#include <gdk/gdk.h>            /* for gdk_error_trap_(push|pop) () */
+
 #include "gdkglx.h"
 #include "gdkglprivate-x11.h"
 #include "gdkglconfig-x11.h"
@@ -30,15 +32,92 @@
 
 #include <gdk/gdkglquery.h>
 
+#ifndef GLX_EXT_swap_control
+#define GLX_SWAP_INTERVAL_EXT                     0x20F1
+#define GLX_MAX_SWAP_INTERVAL_EXT                 0x20F2
+#endif
+#ifndef GLX_EXT_swap_control_tear
+#define GLX_LATE_SWAPS_TEAR_EXT                   0x20F3
+#endif
+#ifndef GLX_EXT_buffer_age
+#define GLX_BACK_BUFFER_AGE_EXT                   0x20F4
+#endif
+
+typedef void (*GdkGLXSwapIntervalEXTProc)     (Display     *dpy,
+                                               GLXDrawable  drawable,
+                                               int          interval);
+typedef int  (*GdkGLXSwapIntervalMESAProc)    (unsigned int interval);
+typedef int  (*GdkGLXGetSwapIntervalMESAProc) (void);
+typedef int  (*GdkGLXSwapIntervalSGIProc)     (int          interval);
+
+typedef void (*GdkGLXCopySubBufferMESAProc)   (Display     *dpy,
+                                               GLXDrawable  drawable,
+                                               int          x,
+                                               int          y,
+                                               int          width,
+                                               int          height);
+
+/* GLX_OML_sync_control */
+typedef Bool   (*GdkGLXGetSyncValuesOMLProc)  (Display     *dpy,
+                                               GLXDrawable  drawable,
+                                               gint64      *ust,
+                                               gint64      *msc,
+                                               gint64      *sbc);
+typedef Bool   (*GdkGLXGetMscRateOMLProc)     (Display     *dpy,
+                                               GLXDrawable  drawable,
+                                               gint32      *numerator,
+                                               gint32      *denominator);
+typedef gint64 (*GdkGLXSwapBuffersMscOMLProc) (Display     *dpy,
+                                               GLXDrawable  drawable,
+                                               gint64       target_msc,
+                                               gint64       divisor,
+                                               gint64       remainder);
+typedef Bool   (*GdkGLXWaitForSbcOMLProc)     (Display     *dpy,
+                                               GLXDrawable  drawable,
+                                               gint64       target_sbc,
+                                               gint64      *ust,
+                                               gint64      *msc,
+                                               gint64      *sbc);
+
 static GdkGLContext *_gdk_x11_gl_window_impl_create_gl_context  (GdkGLWindow  *glwindow,
                                                                  GdkGLContext *share_list,
                                                                  gboolean      direct,
                                                                  int           render_type);
+static GdkGLContext *_gdk_x11_gl_window_impl_create_gl_context_full (GdkGLWindow         *glwindow,
+                                                                     GdkGLContext        *share_list,
+                                                                     gboolean             direct,
+                                                                     int                  render_type,
+                                                                     int                  major_version,
+                                                                     int                  minor_version,
+                                                                     GdkGLContextProfile  profile,
+                                                                     GdkGLContextFlags    flags);
 static gboolean     _gdk_x11_gl_window_impl_is_double_buffered  (GdkGLWindow  *glwindow);
 static void         _gdk_x11_gl_window_impl_swap_buffers        (GdkGLWindow  *glwindow);
 static void         _gdk_x11_gl_window_impl_wait_gl             (GdkGLWindow  *glwindow);
 static void         _gdk_x11_gl_window_impl_wait_gdk            (GdkGLWindow  *glwindow);
 static GdkGLConfig *_gdk_x11_gl_window_impl_get_gl_config       (GdkGLWindow  *glwindow);
+static gboolean     _gdk_x11_gl_window_impl_set_swap_interval   (GdkGLWindow  *glwindow,
+                                                                 int           interval);
+static int          _gdk_x11_gl_window_impl_get_swap_interval   (GdkGLWindow  *glwindow);
+static int          _gdk_x11_gl_window_impl_get_buffer_age      (GdkGLWindow  *glwindow);
+static void         _gdk_x11_gl_window_impl_swap_buffers_with_damage (GdkGLWindow          *glwindow,
+                                                                      const cairo_region_t *damage);
+static gboolean     _gdk_x11_gl_window_impl_get_sync_values     (GdkGLWindow  *glwindow,
+                                                                 gint64       *ust,
+                                                                 gint64       *msc,
+                                                                 gint64       *sbc);
+static gboolean     _gdk_x11_gl_window_impl_get_msc_rate        (GdkGLWindow  *glwindow,
+                                                                 gint32       *numerator,
+                                                                 gint32       *denominator);
+static gint64       _gdk_x11_gl_window_impl_swap_buffers_msc    (GdkGLWindow  *glwindow,
+                                                                 gint64        target_msc,
+                                                                 gint64        divisor,
+                                                                 gint64        remainder);
+static gboolean     _gdk_x11_gl_window_impl_wait_for_sbc        (GdkGLWindow  *glwindow,
+                                                                 gint64        target_sbc,
+                                                                 gint64       *ust,
+                                                                 gint64       *msc,
+                                                                 gint64       *sbc);
 static Window       _gdk_x11_gl_window_impl_get_glxwindow       (GdkGLWindow  *glwindow);
 
 G_DEFINE_TYPE (GdkGLWindowImplX11,
@@ -52,7 +131,11 @@ gdk_gl_window_impl_x11_init (GdkGLWindowImplX11 *self)
 
   self->glxwindow = None;
   self->glconfig = NULL;
+  self->swap_interval = 1;
   self->is_destroyed = 0;
+  self->preserved_width = 0;
+  self->preserved_height = 0;
+  self->back_buffer_preserved = 0;
 }
 
 static void
@@ -69,7 +152,8 @@ _gdk_x11_gl_window_impl_destroy (GdkGLWindow *glwindow)
 
   xdisplay = GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig);
 
-  if (x11_impl->glxwindow == glXGetCurrentDrawable ())
+  if (x11_impl->glxwindow == glXGetCurrentDrawable () ||
+      x11_impl->glxwindow == glXGetCurrentReadDrawable ())
     {
       glXWaitGL ();
 
@@ -118,12 +202,21 @@ gdk_gl_window_impl_x11_class_init (GdkGLWindowImplX11Class *klass)
   klass->get_glxwindow = _gdk_x11_gl_window_impl_get_glxwindow;
 
   klass->parent_class.create_gl_context      = _gdk_x11_gl_window_impl_create_gl_context;
+  klass->parent_class.create_gl_context_full = _gdk_x11_gl_window_impl_create_gl_context_full;
   klass->parent_class.is_double_buffered     = _gdk_x11_gl_window_impl_is_double_buffered;
   klass->parent_class.swap_buffers           = _gdk_x11_gl_window_impl_swap_buffers;
   klass->parent_class.wait_gl                = _gdk_x11_gl_window_impl_wait_gl;
   klass->parent_class.wait_gdk               = _gdk_x11_gl_window_impl_wait_gdk;
   klass->parent_class.get_gl_config          = _gdk_x11_gl_window_impl_get_gl_config;
   klass->parent_class.destroy_gl_window_impl = _gdk_x11_gl_window_impl_destroy;
+  klass->parent_class.set_swap_interval      = _gdk_x11_gl_window_impl_set_swap_interval;
+  klass->parent_class.get_swap_interval      = _gdk_x11_gl_window_impl_get_swap_interval;
+  klass->parent_class.get_buffer_age         = _gdk_x11_gl_window_impl_get_buffer_age;
+  klass->parent_class.swap_buffers_with_damage = _gdk_x11_gl_window_impl_swap_buffers_with_damage;
+  klass->parent_class.get_sync_values        = _gdk_x11_gl_window_impl_get_sync_values;
+  klass->parent_class.get_msc_rate           = _gdk_x11_gl_window_impl_get_msc_rate;
+  klass->parent_class.swap_buffers_msc       = _gdk_x11_gl_window_impl_swap_buffers_msc;
+  klass->parent_class.wait_for_sbc           = _gdk_x11_gl_window_impl_wait_for_sbc;
 
   object_class->finalize = gdk_gl_window_impl_x11_finalize;
 }
@@ -202,6 +295,42 @@ _gdk_x11_gl_window_impl_create_gl_context (GdkGLWindow  *glwindow,
   return glcontext;
 }
 
+static GdkGLContext *
+_gdk_x11_gl_window_impl_create_gl_context_full (GdkGLWindow         *glwindow,
+                                                GdkGLContext        *share_list,
+                                                gboolean             direct,
+                                                int                  render_type,
+                                                int                  major_version,
+                                                int                  minor_version,
+                                                GdkGLContextProfile  profile,
+                                                GdkGLContextFlags    flags)
+{
+  GdkGLContext *glcontext;
+  GdkGLContextImpl *impl;
+
+  glcontext = g_object_new(GDK_TYPE_X11_GL_CONTEXT, NULL);
+
+  g_return_val_if_fail(glcontext != NULL, NULL);
+
+  impl = _gdk_x11_gl_context_impl_new_full(glcontext,
+                                           GDK_GL_DRAWABLE(glwindow),
+                                           share_list,
+                                           direct,
+                                           render_type,
+                                           major_version,
+                                           minor_version,
+                                           profile,
+                                           flags);
+  if (impl == NULL)
+    {
+      /* the requested version may simply be unsupported; not a bug */
+      g_object_unref(glcontext);
+      return NULL;
+    }
+
+  return glcontext;
+}
+
 static gboolean
 _gdk_x11_gl_window_impl_is_double_buffered (GdkGLWindow *glwindow)
 {
@@ -227,6 +356,99 @@ _gdk_x11_gl_window_impl_swap_buffers (GdkGLWindow *glwindow)
   GDK_GL_NOTE_FUNC_IMPL ("glXSwapBuffers");
 
   glXSwapBuffers (xdisplay, glxwindow);
+
+  GDK_GL_WINDOW_IMPL_X11 (glwindow->impl)->back_buffer_preserved = FALSE;
+}
+
+static int
+_gdk_x11_gl_window_impl_get_buffer_age (GdkGLWindow *glwindow)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  unsigned int age = 0;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (glwindow), 0);
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+
+  if (x11_impl->glxwindow == None)
+    return 0;
+
+  /* A resize reallocates the buffers. */
+  if (x11_impl->back_buffer_preserved && glwindow->window != NULL &&
+      gdk_window_get_width (glwindow->window) == x11_impl->preserved_width &&
+      gdk_window_get_height (glwindow->window) == x11_impl->preserved_height)
+    return 1;
+
+  /* The age can only be queried for the current drawable. */
+  if (x11_impl->glxwindow != glXGetCurrentDrawable () ||
+      !gdk_x11_gl_query_glx_extension (x11_impl->glconfig, "GLX_EXT_buffer_age"))
+    return 0;
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXQueryDrawable");
+
+  glXQueryDrawable (GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig),
+                    x11_impl->glxwindow,
+                    GLX_BACK_BUFFER_AGE_EXT, &age);
+
+  return (int) age;
+}
+
+/*
+ * GLX cannot pass damage to a swap. If the buffer age is known, apps
+ * already limit their drawing and a full swap is kept; otherwise the
+ * damaged rectangles are copied with GLX_MESA_copy_sub_buffer, which
+ * keeps the back buffer so that the next frame has an age of 1.
+ */
+static void
+_gdk_x11_gl_window_impl_swap_buffers_with_damage (GdkGLWindow          *glwindow,
+                                                  const cairo_region_t *damage)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  Display *xdisplay;
+  GdkGLXCopySubBufferMESAProc CopySubBufferMESA;
+  cairo_rectangle_int_t rect;
+  int height;
+  int i, n_rects;
+
+  g_return_if_fail (GDK_IS_X11_GL_WINDOW (glwindow));
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig);
+
+  if (x11_impl->glxwindow == None || glwindow->window == NULL ||
+      !gdk_gl_config_is_double_buffered (x11_impl->glconfig) ||
+      gdk_x11_gl_query_glx_extension (x11_impl->glconfig, "GLX_EXT_buffer_age") ||
+      !gdk_x11_gl_query_glx_extension (x11_impl->glconfig, "GLX_MESA_copy_sub_buffer"))
+    {
+      _gdk_x11_gl_window_impl_swap_buffers (glwindow);
+      return;
+    }
+
+  CopySubBufferMESA = (GdkGLXCopySubBufferMESAProc)
+    gdk_gl_get_proc_address ("glXCopySubBufferMESA");
+  if (CopySubBufferMESA == NULL)
+    {
+      _gdk_x11_gl_window_impl_swap_buffers (glwindow);
+      return;
+    }
+
+  /* GL window coordinates have their origin at the bottom left. */
+  height = gdk_window_get_height (glwindow->window);
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXCopySubBufferMESA");
+
+  n_rects = cairo_region_num_rectangles (damage);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_region_get_rectangle (damage, i, &rect);
+      CopySubBufferMESA (xdisplay, x11_impl->glxwindow,
+                         rect.x, height - rect.y - rect.height,
+                         rect.width, rect.height);
+    }
+
+  x11_impl->back_buffer_preserved = TRUE;
+  x11_impl->preserved_width = gdk_window_get_width (glwindow->window);
+  x11_impl->preserved_height = height;
 }
 
 static void
@@ -253,6 +475,292 @@ _gdk_x11_gl_window_impl_get_gl_config (GdkGLWindow *glwindow)
   return GDK_GL_WINDOW_IMPL_X11 (glwindow->impl)->glconfig;
 }
 
+static gboolean
+_gdk_x11_gl_window_impl_set_swap_interval (GdkGLWindow *glwindow,
+                                           int          interval)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  GdkGLConfig *glconfig;
+  Display *xdisplay;
+  gboolean is_current;
+  GdkGLXSwapIntervalEXTProc SwapIntervalEXT;
+  GdkGLXSwapIntervalMESAProc SwapIntervalMESA;
+  GdkGLXSwapIntervalSGIProc SwapIntervalSGI;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (glwindow), FALSE);
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+  glconfig = x11_impl->glconfig;
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (glconfig);
+
+  if (x11_impl->glxwindow == None)
+    return FALSE;
+
+  /* Late swaps may only tear with GLX_EXT_swap_control_tear. */
+  if (interval < 0 &&
+      !gdk_x11_gl_query_glx_extension (glconfig, "GLX_EXT_swap_control_tear"))
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- GLX_EXT_swap_control_tear is not supported, using %d", -interval));
+      interval = -interval;
+    }
+
+  /* GLX_EXT_swap_control names the drawable; the others act on the
+     current one. */
+
+  if (gdk_x11_gl_query_glx_extension (glconfig, "GLX_EXT_swap_control"))
+    {
+      SwapIntervalEXT = (GdkGLXSwapIntervalEXTProc)
+        gdk_gl_get_proc_address ("glXSwapIntervalEXT");
+
+      if (SwapIntervalEXT != NULL)
+        {
+          GDK_GL_NOTE_FUNC_IMPL ("glXSwapIntervalEXT");
+
+          gdk_error_trap_push ();
+
+          SwapIntervalEXT (xdisplay, x11_impl->glxwindow, interval);
+          XSync (xdisplay, False);
+
+          if (gdk_error_trap_pop () == Success)
+            {
+              x11_impl->swap_interval = interval;
+              return TRUE;
+            }
+        }
+    }
+
+  is_current = (glXGetCurrentDrawable () == x11_impl->glxwindow);
+
+  if (!is_current)
+    {
+      GDK_GL_NOTE (MISC,
+        g_message (" -- the window is not current, cannot set the swap interval"));
+      return FALSE;
+    }
+
+  interval = ABS (interval);
+
+  if (gdk_x11_gl_query_glx_extension (glconfig, "GLX_MESA_swap_control"))
+    {
+      SwapIntervalMESA = (GdkGLXSwapIntervalMESAProc)
+        gdk_gl_get_proc_address ("glXSwapIntervalMESA");
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXSwapIntervalMESA");
+
+      if (SwapIntervalMESA != NULL && SwapIntervalMESA (interval) == 0)
+        {
+          x11_impl->swap_interval = interval;
+          return TRUE;
+        }
+    }
+
+  /* GLX_SGI_swap_control cannot turn synchronization off. */
+  if (interval > 0 &&
+      gdk_x11_gl_query_glx_extension (glconfig, "GLX_SGI_swap_control"))
+    {
+      SwapIntervalSGI = (GdkGLXSwapIntervalSGIProc)
+        gdk_gl_get_proc_address ("glXSwapIntervalSGI");
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXSwapIntervalSGI");
+
+      if (SwapIntervalSGI != NULL && SwapIntervalSGI (interval) == 0)
+        {
+          x11_impl->swap_interval = interval;
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
+static int
+_gdk_x11_gl_window_impl_get_swap_interval (GdkGLWindow *glwindow)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  GdkGLConfig *glconfig;
+  Display *xdisplay;
+  unsigned int value;
+  GdkGLXGetSwapIntervalMESAProc GetSwapIntervalMESA;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (glwindow), 0);
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+  glconfig = x11_impl->glconfig;
+  xdisplay = GDK_GL_CONFIG_XDISPLAY (glconfig);
+
+  if (x11_impl->glxwindow == None)
+    return x11_impl->swap_interval;
+
+  if (gdk_x11_gl_query_glx_extension (glconfig, "GLX_EXT_swap_control"))
+    {
+      value = 0;
+
+      GDK_GL_NOTE_FUNC_IMPL ("glXQueryDrawable");
+
+      glXQueryDrawable (xdisplay, x11_impl->glxwindow,
+                        GLX_SWAP_INTERVAL_EXT, &value);
+
+      if (value > 0 &&
+          gdk_x11_gl_query_glx_extension (glconfig, "GLX_EXT_swap_control_tear"))
+        {
+          unsigned int late_swaps_tear = 0;
+
+          glXQueryDrawable (xdisplay, x11_impl->glxwindow,
+                            GLX_LATE_SWAPS_TEAR_EXT, &late_swaps_tear);
+
+          if (late_swaps_tear)
+            return -(int) value;
+        }
+
+      return (int) value;
+    }
+
+  if (glXGetCurrentDrawable () == x11_impl->glxwindow &&
+      gdk_x11_gl_query_glx_extension (glconfig, "GLX_MESA_swap_control"))
+    {
+      GetSwapIntervalMESA = (GdkGLXGetSwapIntervalMESAProc)
+        gdk_gl_get_proc_address ("glXGetSwapIntervalMESA");
+
+      if (GetSwapIntervalMESA != NULL)
+        {
+          GDK_GL_NOTE_FUNC_IMPL ("glXGetSwapIntervalMESA");
+
+          return GetSwapIntervalMESA ();
+        }
+    }
+
+  return x11_impl->swap_interval;
+}
+
+/*
+ * GLX_OML_sync_control. Each of these returns FALSE (or -1) when the
+ * extension is missing, and the caller then uses its clock-based
+ * fallback.
+ */
+
+static gboolean
+_gdk_x11_gl_window_impl_has_oml_sync_control (GdkGLWindow *glwindow)
+{
+  GdkGLWindowImplX11 *x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+
+  return x11_impl->glxwindow != None &&
+         gdk_x11_gl_query_glx_extension (x11_impl->glconfig, "GLX_OML_sync_control");
+}
+
+static gboolean
+_gdk_x11_gl_window_impl_get_sync_values (GdkGLWindow *glwindow,
+                                         gint64      *ust,
+                                         gint64      *msc,
+                                         gint64      *sbc)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  GdkGLXGetSyncValuesOMLProc GetSyncValuesOML;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (glwindow), FALSE);
+
+  if (!_gdk_x11_gl_window_impl_has_oml_sync_control (glwindow))
+    return FALSE;
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+
+  GetSyncValuesOML = (GdkGLXGetSyncValuesOMLProc)
+    gdk_gl_get_proc_address ("glXGetSyncValuesOML");
+  if (GetSyncValuesOML == NULL)
+    return FALSE;
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXGetSyncValuesOML");
+
+  return GetSyncValuesOML (GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig),
+                           x11_impl->glxwindow,
+                           ust, msc, sbc);
+}
+
+static gboolean
+_gdk_x11_gl_window_impl_get_msc_rate (GdkGLWindow *glwindow,
+                                      gint32      *numerator,
+                                      gint32      *denominator)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  GdkGLXGetMscRateOMLProc GetMscRateOML;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (glwindow), FALSE);
+
+  if (!_gdk_x11_gl_window_impl_has_oml_sync_control (glwindow))
+    return FALSE;
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+
+  GetMscRateOML = (GdkGLXGetMscRateOMLProc)
+    gdk_gl_get_proc_address ("glXGetMscRateOML");
+  if (GetMscRateOML == NULL)
+    return FALSE;
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXGetMscRateOML");
+
+  return GetMscRateOML (GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig),
+                        x11_impl->glxwindow,
+                        numerator, denominator) &&
+         *denominator > 0;
+}
+
+static gint64
+_gdk_x11_gl_window_impl_swap_buffers_msc (GdkGLWindow *glwindow,
+                                          gint64       target_msc,
+                                          gint64       divisor,
+                                          gint64       remainder)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  GdkGLXSwapBuffersMscOMLProc SwapBuffersMscOML;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (glwindow), -1);
+
+  if (!_gdk_x11_gl_window_impl_has_oml_sync_control (glwindow))
+    return -1;
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+
+  SwapBuffersMscOML = (GdkGLXSwapBuffersMscOMLProc)
+    gdk_gl_get_proc_address ("glXSwapBuffersMscOML");
+  if (SwapBuffersMscOML == NULL)
+    return -1;
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXSwapBuffersMscOML");
+
+  return SwapBuffersMscOML (GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig),
+                            x11_impl->glxwindow,
+                            target_msc, divisor, remainder);
+}
+
+static gboolean
+_gdk_x11_gl_window_impl_wait_for_sbc (GdkGLWindow *glwindow,
+                                      gint64       target_sbc,
+                                      gint64      *ust,
+                                      gint64      *msc,
+                                      gint64      *sbc)
+{
+  GdkGLWindowImplX11 *x11_impl;
+  GdkGLXWaitForSbcOMLProc WaitForSbcOML;
+
+  g_return_val_if_fail (GDK_IS_X11_GL_WINDOW (glwindow), FALSE);
+
+  if (!_gdk_x11_gl_window_impl_has_oml_sync_control (glwindow))
+    return FALSE;
+
+  x11_impl = GDK_GL_WINDOW_IMPL_X11 (glwindow->impl);
+
+  WaitForSbcOML = (GdkGLXWaitForSbcOMLProc)
+    gdk_gl_get_proc_address ("glXWaitForSbcOML");
+  if (WaitForSbcOML == NULL)
+    return FALSE;
+
+  GDK_GL_NOTE_FUNC_IMPL ("glXWaitForSbcOML");
+
+  return WaitForSbcOML (GDK_GL_CONFIG_XDISPLAY (x11_impl->glconfig),
+                        x11_impl->glxwindow,
+                        target_sbc, ust, msc, sbc);
+}
+
 static Window
 _gdk_x11_gl_window_impl_get_glxwindow (GdkGLWindow *glwindow)
 {
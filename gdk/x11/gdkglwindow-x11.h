@@ -45,7 +45,17 @@ struct _GdkGLWindowImplX11
 
   GdkGLConfig *glconfig;
 
+  /* last interval set, for when the server cannot be asked */
+  int swap_interval;
+
+  /* window size when the back buffer was last preserved */
+  int preserved_width;
+  int preserved_height;
+
   guint is_destroyed : 1;
+
+  /* set by glXCopySubBufferMESA, which leaves the back buffer intact */
+  guint back_buffer_preserved : 1;
 };
 
 struct _GdkGLWindowImplX11Class
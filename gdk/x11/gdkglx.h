@@ -33,6 +33,7 @@
 #include <gdk/x11/gdkx11glcontext.h>
 #include <gdk/x11/gdkx11glquery.h>
 #include <gdk/x11/gdkx11glwindow.h>
+#include <gdk/x11/gdkx11glpbuffer.h>
 
 #undef __GDKGLX_H_INSIDE__
 
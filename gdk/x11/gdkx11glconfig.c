@@ -85,10 +85,13 @@ gdk_x11_gl_config_new_for_display(GdkDisplay *display, const int *attrib_list, g
 
   impl = _gdk_x11_gl_config_impl_new(glconfig, attrib_list, n_attribs);
 
+  /* No matching configuration is not an error; callers may retry
+   * with fewer requirements. */
   if (impl == NULL)
-    g_object_unref(glconfig);
-
-  g_return_val_if_fail(impl != NULL, NULL);
+    {
+      g_object_unref(glconfig);
+      return NULL;
+    }
 
   return glconfig;
 }
@@ -115,12 +118,15 @@ gdk_x11_gl_config_new_for_screen(GdkScreen *screen, const int *attrib_list, gsiz
 
   g_return_val_if_fail(glconfig != NULL, NULL);
 
-  impl = _gdk_x11_gl_config_impl_new(glconfig, attrib_list, n_attribs);
+  impl = _gdk_x11_gl_config_impl_new_for_screen(glconfig, screen, attrib_list, n_attribs);
 
+  /* No matching configuration is not an error; callers may retry
+   * with fewer requirements. */
   if (impl == NULL)
-    g_object_unref(glconfig);
-
-  g_return_val_if_fail(impl != NULL, NULL);
+    {
+      g_object_unref(glconfig);
+      return NULL;
+    }
 
   return glconfig;
 }
@@ -243,3 +249,22 @@ gdk_x11_gl_config_get_xvinfo (GdkGLConfig *glconfig)
 
   return GDK_GL_CONFIG_IMPL_X11_CLASS (glconfig)->get_xvinfo(glconfig);
 }
+
+/**
+ * gdk_x11_gl_config_get_fbconfig:
+ * @glconfig: a #GdkGLConfig.
+ *
+ * Gets the GLXFBConfig of the frame buffer configuration. The FBConfig is
+ * only available if both the X server and the client library support
+ * GLX 1.3 or later.
+ *
+ * Return value: the GLXFBConfig, or NULL if @glconfig is not backed by a
+ *               GLXFBConfig.
+ **/
+GLXFBConfig
+gdk_x11_gl_config_get_fbconfig (GdkGLConfig *glconfig)
+{
+  g_return_val_if_fail (GDK_IS_X11_GL_CONFIG (glconfig), NULL);
+
+  return GDK_GL_CONFIG_IMPL_X11_GET_CLASS (glconfig->impl)->get_fbconfig(glconfig);
+}
@@ -24,6 +24,8 @@
 #define __GDK_X11_GL_CONFIG_H__
 
 #include <gdk/gdkx.h>
+
+#include <GL/glx.h>
 #include <gdk/gdkgl.h>
 
 G_BEGIN_DECLS
@@ -62,18 +64,21 @@ GdkGLConfig *gdk_x11_gl_config_new_from_visualid_for_screen (GdkScreen *screen,
 Display     *gdk_x11_gl_config_get_xdisplay      (GdkGLConfig  *glconfig);
 int          gdk_x11_gl_config_get_screen_number (GdkGLConfig  *glconfig);
 XVisualInfo *gdk_x11_gl_config_get_xvinfo        (GdkGLConfig  *glconfig);
+GLXFBConfig  gdk_x11_gl_config_get_fbconfig      (GdkGLConfig  *glconfig);
 
 #ifdef INSIDE_GDK_GL_X11
 
 #define GDK_GL_CONFIG_XDISPLAY(glconfig)       (GDK_GL_CONFIG_IMPL_X11 (glconfig->impl)->xdisplay)
 #define GDK_GL_CONFIG_SCREEN_XNUMBER(glconfig) (GDK_GL_CONFIG_IMPL_X11 (glconfig->impl)->screen_num)
 #define GDK_GL_CONFIG_XVINFO(glconfig)         (GDK_GL_CONFIG_IMPL_X11 (glconfig->impl)->xvinfo)
+#define GDK_GL_CONFIG_FBCONFIG(glconfig)       (GDK_GL_CONFIG_IMPL_X11 (glconfig->impl)->fbconfig)
 
 #else
 
 #define GDK_GL_CONFIG_XDISPLAY(glconfig)       (gdk_x11_gl_config_get_xdisplay (glconfig))
 #define GDK_GL_CONFIG_SCREEN_XNUMBER(glconfig) (gdk_x11_gl_config_get_screen_number (glconfig))
 #define GDK_GL_CONFIG_XVINFO(glconfig)         (gdk_x11_gl_config_get_xvinfo (glconfig))
+#define GDK_GL_CONFIG_FBCONFIG(glconfig)       (gdk_x11_gl_config_get_fbconfig (glconfig))
 
 #endif
 
@@ -0,0 +1,81 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <gdk/gdkgldebug.h>
+#include <gdk/x11/gdkglx.h>
+
+#include "gdkglpbuffer-x11.h"
+
+struct _GdkX11GLPbuffer
+{
+  GdkGLPbuffer parent;
+};
+
+struct _GdkX11GLPbufferClass
+{
+  GdkGLPbufferClass parent_class;
+};
+
+G_DEFINE_TYPE (GdkX11GLPbuffer,
+               gdk_x11_gl_pbuffer,
+               GDK_TYPE_GL_PBUFFER)
+
+static void
+gdk_x11_gl_pbuffer_init (GdkX11GLPbuffer *self)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+}
+
+static void
+gdk_x11_gl_pbuffer_finalize (GObject *object)
+{
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  G_OBJECT_CLASS (gdk_x11_gl_pbuffer_parent_class)->finalize (object);
+}
+
+static void
+gdk_x11_gl_pbuffer_class_init (GdkX11GLPbufferClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  GDK_GL_NOTE_FUNC_PRIVATE ();
+
+  object_class->finalize = gdk_x11_gl_pbuffer_finalize;
+}
+
+/**
+ * gdk_x11_gl_pbuffer_get_glxpbuffer:
+ * @glpbuffer: a #GdkGLPbuffer.
+ *
+ * Gets the GLX pbuffer, which is a GLXPbufferSGIX when GLX 1.3 is not
+ * available.
+ *
+ * Return value: the GLXPbuffer.
+ **/
+GLXDrawable
+gdk_x11_gl_pbuffer_get_glxpbuffer (GdkGLPbuffer *glpbuffer)
+{
+  g_return_val_if_fail (GDK_IS_X11_GL_PBUFFER (glpbuffer), None);
+
+  return GDK_GL_PBUFFER_IMPL_X11_GET_CLASS (glpbuffer->impl)->get_glxpbuffer (glpbuffer);
+}
@@ -0,0 +1,62 @@
+/* GdkGLExt - OpenGL Extension to GDK
+ * Copyright (C) 2002-2004  Naofumi Yasufuku
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA.
+ */
+
+#if !defined (__GDKGLX_H_INSIDE__) && !defined (GDK_GL_COMPILATION)
+#error "Only <gdk/gdkglx.h> can be included directly."
+#endif
+
+#ifndef __GDK_X11_GL_PBUFFER_H__
+#define __GDK_X11_GL_PBUFFER_H__
+
+#include <gdk/gdkx.h>
+
+#include <gdk/gdkgl.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_X11_GL_PBUFFER             (gdk_x11_gl_pbuffer_get_type ())
+#define GDK_X11_GL_PBUFFER(object)          (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_X11_GL_PBUFFER, GdkX11GLPbuffer))
+#define GDK_X11_GL_PBUFFER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_X11_GL_PBUFFER, GdkX11GLPbufferClass))
+#define GDK_IS_X11_GL_PBUFFER(object)       (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_X11_GL_PBUFFER))
+#define GDK_IS_X11_GL_PBUFFER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_X11_GL_PBUFFER))
+#define GDK_X11_GL_PBUFFER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_X11_GL_PBUFFER, GdkX11GLPbufferClass))
+
+#ifdef INSIDE_GDK_GL_X11
+typedef struct _GdkX11GLPbuffer GdkX11GLPbuffer;
+#else
+typedef GdkGLPbuffer GdkX11GLPbuffer;
+#endif
+typedef struct _GdkX11GLPbufferClass GdkX11GLPbufferClass;
+
+GType         gdk_x11_gl_pbuffer_get_type       (void);
+
+GLXDrawable   gdk_x11_gl_pbuffer_get_glxpbuffer (GdkGLPbuffer *glpbuffer);
+
+#ifdef INSIDE_GDK_GL_X11
+
+#define GDK_GL_PBUFFER_GLXPBUFFER(glpbuffer)   (GDK_GL_PBUFFER_IMPL_X11 (glpbuffer->impl)->glxpbuffer)
+
+#else
+
+#define GDK_GL_PBUFFER_GLXPBUFFER(glpbuffer)   (gdk_x11_gl_pbuffer_get_glxpbuffer (glpbuffer))
+
+#endif
+
+G_END_DECLS
+
+#endif /* __GDK_X11_GL_PBUFFER_H__ */
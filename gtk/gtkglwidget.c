@@ -23,26 +23,99 @@
 #include "gtkglprivate.h"
 #include "gtkglwidget.h"
 
+#include <string.h>
+#include <math.h>
+
 #include <GL/gl.h>
 
+/* Number of past frames whose damage is kept for buffer ages > 1. */
+#define GL_WIDGET_DAMAGE_HISTORY 4
+
+/* Number of frames a render thread may queue ahead of the GPU. */
+#define GL_WIDGET_MAX_FRAMES_IN_FLIGHT 2
+
+/*
+ * State shared between the main loop and a widget's render thread.
+ * Requests are coalesced rather than queued: any number of redraws
+ * posted while a frame is rendering result in one more frame.
+ *
+ * The struct is reference counted so that gtk_widget_queue_gl_render()
+ * can use it from other threads while the widget is being unrealized.
+ * The widget's pointer to it is only written on the main thread, with
+ * the render_thread lock held; other threads read it under that lock.
+ */
+typedef struct
+{
+  volatile gint ref_count;
+
+  GThread *thread;
+  GMutex lock;
+  GCond cond;
+
+  /* owned by the render thread once it is started */
+  GdkGLContext *glcontext;
+  GdkGLDrawable *gldrawable;
+
+  GtkGLRenderFunc render_func;
+  gpointer user_data;
+
+  /* owned by the render thread: fences behind the last frames */
+  GdkGLFence *frame_fences[GL_WIDGET_MAX_FRAMES_IN_FLIGHT];
+  guint frame_index;
+
+  /* protected by lock */
+  gint width;
+  gint height;
+  guint render_pending : 1;
+  guint is_visible     : 1;
+  guint quit           : 1;
+
+} GLWidgetRenderThread;
+
 typedef struct
 {
   GdkGLConfig *glconfig;
   GdkGLContext *share_list;
   gboolean direct;
   int render_type;
+  int major_version;
+  int minor_version;
+  GdkGLContextProfile profile;
+  GdkGLContextFlags flags;
 
   GdkGLContext *glcontext;
 
   gulong unrealize_handler;
 
-  guint is_realized : 1;
+  GtkGLRenderFunc render_func;
+  gpointer render_data;
+  GDestroyNotify render_destroy;
+  GLWidgetRenderThread *render_thread;
+
+  GtkGLFrameFunc frame_func;
+  gpointer frame_data;
+  GDestroyNotify frame_destroy;
+  guint tick_id;
+
+  /* exposed regions of the last frames, newest first; NULL if unknown */
+  cairo_region_t *damage_history[GL_WIDGET_DAMAGE_HISTORY];
+  gint damage_width;
+  gint damage_height;
+
+  /* size for which a wait for GDK was last queued */
+  gint synced_width;
+  gint synced_height;
+
+  guint is_realized   : 1;
+  guint frame_pending : 1;
 
 } GLWidgetPrivate;
 
 static const gchar quark_gl_private_string[] = "gtk-gl-widget-private";
 static GQuark quark_gl_private = 0;
 
+G_LOCK_DEFINE_STATIC (render_thread);
+
 gboolean _gtk_gl_widget_install_toplevel_visual = FALSE;
 
 static void     gtk_gl_widget_realize            (GtkWidget         *widget,
@@ -62,7 +135,19 @@ static void     gtk_gl_widget_style_set          (GtkWidget         *widget,
                                                   GtkStyle          *previous_style,
                                                   gpointer           user_data);
 
+static void     gtk_gl_widget_map_changed        (GtkWidget         *widget,
+                                                  GLWidgetPrivate   *private);
+
 static void     gl_widget_private_destroy        (GLWidgetPrivate   *private);
+static void     gl_widget_private_clear_damage   (GLWidgetPrivate   *private);
+
+static void     gtk_gl_widget_render_thread_start (GtkWidget        *widget,
+                                                   GLWidgetPrivate  *private);
+static void     gtk_gl_widget_render_thread_stop  (GLWidgetPrivate  *private);
+
+static void     gtk_gl_widget_update_ticking      (GtkWidget        *widget,
+                                                   GLWidgetPrivate  *private);
+static void     gtk_gl_widget_clear_animation     (GLWidgetPrivate  *private);
 
 /*
  * Signal handlers.
@@ -102,6 +187,9 @@ gtk_gl_widget_realize (GtkWidget       *widget,
     }
 
   private->is_realized = TRUE;
+
+  if (private->render_func != NULL && private->render_thread == NULL)
+    gtk_gl_widget_render_thread_start (widget, private);
 }
 
 static gboolean
@@ -125,18 +213,34 @@ gtk_gl_widget_size_allocate (GtkWidget       *widget,
                              GtkAllocation   *allocation,
                              GLWidgetPrivate *private)
 {
-  GdkGLDrawable *gldrawable;
-
   GTK_GL_NOTE_FUNC_PRIVATE ();
 
+  if (private->render_thread != NULL)
+    {
+      GLWidgetRenderThread *rt = private->render_thread;
+
+      g_mutex_lock (&rt->lock);
+      rt->width = allocation->width;
+      rt->height = allocation->height;
+      rt->render_pending = TRUE;
+      g_cond_signal (&rt->cond);
+      g_mutex_unlock (&rt->lock);
+    }
+
   /*
-   * Synchronize OpenGL and window resizing request streams.
+   * Synchronize OpenGL and window resizing request streams, only if the
+   * size changed. The wait is made by the next make-current onto the
+   * window, whoever makes it: an interactive resize may allocate many
+   * times per frame, and each wait is a round trip to the X server.
    */
 
-  if (gtk_widget_get_realized (widget) && private->is_realized)
+  if (gtk_widget_get_realized (widget) && private->is_realized &&
+      (allocation->width != private->synced_width ||
+       allocation->height != private->synced_height))
     {
-      gldrawable = gdk_window_get_gl_drawable (gtk_widget_get_window (widget));
-      gdk_gl_drawable_wait_gdk (gldrawable);
+      gdk_gl_window_queue_wait_gdk (gdk_window_get_gl_window (gtk_widget_get_window (widget)));
+      private->synced_width = allocation->width;
+      private->synced_height = allocation->height;
     }
 }
 
@@ -146,6 +250,12 @@ gtk_gl_widget_unrealize (GtkWidget       *widget,
 {
   GTK_GL_NOTE_FUNC_PRIVATE ();
 
+  /*
+   * Stop the render thread while its drawable still exists.
+   */
+
+  gtk_gl_widget_render_thread_stop (private);
+
   /*
    * Destroy OpenGL rendering context.
    */
@@ -163,6 +273,11 @@ gtk_gl_widget_unrealize (GtkWidget       *widget,
   if (gtk_widget_get_realized (widget))
     gdk_window_unset_gl_capability (gtk_widget_get_window (widget));
 
+  gl_widget_private_clear_damage (private);
+
+  private->synced_width = 0;
+  private->synced_height = 0;
+
   private->is_realized = FALSE;
 }
 
@@ -218,11 +333,31 @@ gtk_gl_widget_style_set (GtkWidget *widget,
     }
 }
 
+static void
+gtk_gl_widget_map_changed (GtkWidget       *widget,
+                           GLWidgetPrivate *private)
+{
+  GTK_GL_NOTE_FUNC_PRIVATE ();
+
+  gtk_gl_widget_update_ticking (widget, private);
+}
+
 static void
 gl_widget_private_destroy (GLWidgetPrivate *private)
 {
   GTK_GL_NOTE_FUNC_PRIVATE ();
 
+  gtk_gl_widget_render_thread_stop (private);
+
+  /* The widget is being finalized; its tick callbacks are gone. */
+  private->tick_id = 0;
+  gtk_gl_widget_clear_animation (private);
+
+  gl_widget_private_clear_damage (private);
+
+  if (private->render_destroy != NULL)
+    private->render_destroy (private->render_data);
+
   g_object_unref (G_OBJECT (private->glconfig));
 
   if (private->share_list != NULL)
@@ -231,6 +366,299 @@ gl_widget_private_destroy (GLWidgetPrivate *private)
   g_free (private);
 }
 
+static void
+gl_widget_private_clear_damage (GLWidgetPrivate *private)
+{
+  int i;
+
+  for (i = 0; i < GL_WIDGET_DAMAGE_HISTORY; i++)
+    {
+      if (private->damage_history[i] != NULL)
+        {
+          cairo_region_destroy (private->damage_history[i]);
+          private->damage_history[i] = NULL;
+        }
+    }
+}
+
+/*
+ * Render thread.
+ */
+
+static gpointer
+gtk_gl_widget_render_thread_main (gpointer data)
+{
+  GLWidgetRenderThread *rt = data;
+  GdkGLFence **frame_fence;
+  gint width, height;
+  guint i;
+
+  GTK_GL_NOTE_FUNC_PRIVATE ();
+
+  g_mutex_lock (&rt->lock);
+
+  for (;;)
+    {
+      while (!rt->quit && !(rt->render_pending && rt->is_visible))
+        g_cond_wait (&rt->cond, &rt->lock);
+
+      if (rt->quit)
+        break;
+
+      rt->render_pending = FALSE;
+      width = rt->width;
+      height = rt->height;
+
+      g_mutex_unlock (&rt->lock);
+
+      if (gdk_gl_context_make_current (rt->glcontext, rt->gldrawable, rt->gldrawable))
+        {
+          /* Wait for the frame rendered GL_WIDGET_MAX_FRAMES_IN_FLIGHT
+             frames ago rather than letting the driver queue up frames. */
+          frame_fence = &rt->frame_fences[rt->frame_index];
+          if (*frame_fence != NULL)
+            {
+              gdk_gl_fence_client_wait (*frame_fence, -1);
+              g_object_unref (*frame_fence);
+            }
+
+          rt->render_func (rt->glcontext, width, height, rt->user_data);
+
+          if (gdk_gl_drawable_is_double_buffered (rt->gldrawable))
+            gdk_gl_drawable_swap_buffers (rt->gldrawable);
+
+          /* Creating the fence flushes single-buffered drawables. */
+          *frame_fence = gdk_gl_fence_new ();
+          rt->frame_index = (rt->frame_index + 1) % GL_WIDGET_MAX_FRAMES_IN_FLIGHT;
+        }
+
+      g_mutex_lock (&rt->lock);
+    }
+
+  g_mutex_unlock (&rt->lock);
+
+  for (i = 0; i < GL_WIDGET_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+      if (rt->frame_fences[i] != NULL)
+        {
+          g_object_unref (rt->frame_fences[i]);
+          rt->frame_fences[i] = NULL;
+        }
+    }
+
+  /* Only this thread ever made rt->glcontext current. Release it
+     before returning, so that the thread holds no GL state once
+     gtk_gl_widget_render_thread_stop() has joined it. */
+  g_object_unref (rt->glcontext);
+  rt->glcontext = NULL;
+
+  return NULL;
+}
+
+static GLWidgetRenderThread *
+gtk_gl_widget_render_thread_ref (GLWidgetRenderThread *rt)
+{
+  g_atomic_int_inc (&rt->ref_count);
+
+  return rt;
+}
+
+static void
+gtk_gl_widget_render_thread_unref (GLWidgetRenderThread *rt)
+{
+  if (!g_atomic_int_dec_and_test (&rt->ref_count))
+    return;
+
+  g_mutex_clear (&rt->lock);
+  g_cond_clear (&rt->cond);
+  g_free (rt);
+}
+
+static void
+gtk_gl_widget_render_thread_start (GtkWidget       *widget,
+                                   GLWidgetPrivate *private)
+{
+  GLWidgetRenderThread *rt;
+  GdkGLDrawable *gldrawable;
+  GdkGLContext *glcontext;
+
+  GTK_GL_NOTE_FUNC_PRIVATE ();
+
+  gldrawable = gdk_window_get_gl_drawable (gtk_widget_get_window (widget));
+  if (gldrawable == NULL)
+    return;
+
+  glcontext = gdk_gl_context_new_full (gldrawable,
+                                       private->share_list,
+                                       private->direct,
+                                       private->render_type,
+                                       private->major_version,
+                                       private->minor_version,
+                                       private->profile,
+                                       private->flags);
+  if (glcontext == NULL)
+    {
+      g_warning ("cannot create GdkGLContext for the render thread\n");
+      return;
+    }
+
+  rt = g_new0 (GLWidgetRenderThread, 1);
+
+  rt->ref_count = 1;
+  g_mutex_init (&rt->lock);
+  g_cond_init (&rt->cond);
+
+  rt->glcontext = glcontext;
+  rt->gldrawable = gldrawable;
+  rt->render_func = private->render_func;
+  rt->user_data = private->render_data;
+
+  rt->width = gtk_widget_get_allocated_width (widget);
+  rt->height = gtk_widget_get_allocated_height (widget);
+  rt->render_pending = TRUE;
+  rt->is_visible = gtk_widget_get_mapped (widget);
+  rt->quit = FALSE;
+
+  rt->thread = g_thread_new ("gtkglext-render",
+                             gtk_gl_widget_render_thread_main,
+                             rt);
+
+  G_LOCK (render_thread);
+  private->render_thread = rt;
+  G_UNLOCK (render_thread);
+}
+
+static void
+gtk_gl_widget_render_thread_stop (GLWidgetPrivate *private)
+{
+  GLWidgetRenderThread *rt;
+
+  GTK_GL_NOTE_FUNC_PRIVATE ();
+
+  G_LOCK (render_thread);
+  rt = private->render_thread;
+  private->render_thread = NULL;
+  G_UNLOCK (render_thread);
+
+  if (rt == NULL)
+    return;
+
+  g_mutex_lock (&rt->lock);
+  rt->quit = TRUE;
+  g_cond_signal (&rt->cond);
+  g_mutex_unlock (&rt->lock);
+
+  g_thread_join (rt->thread);
+
+  gtk_gl_widget_render_thread_unref (rt);
+}
+
+static void
+gtk_gl_widget_render_thread_set_visible (GtkWidget       *widget,
+                                         GLWidgetPrivate *private)
+{
+  GLWidgetRenderThread *rt = private->render_thread;
+
+  if (rt == NULL)
+    return;
+
+  g_mutex_lock (&rt->lock);
+  rt->is_visible = gtk_widget_get_mapped (widget);
+  if (rt->is_visible)
+    rt->render_pending = TRUE;
+  g_cond_signal (&rt->cond);
+  g_mutex_unlock (&rt->lock);
+}
+
+static gboolean
+gtk_gl_widget_render_thread_draw (GtkWidget       *widget,
+                                  cairo_t         *cr,
+                                  GLWidgetPrivate *private)
+{
+  gtk_widget_queue_gl_render (widget);
+
+  /* The render thread paints the window. */
+  return TRUE;
+}
+
+/*
+ * Frame clock.
+ *
+ * The widget ticks while it is mapped and either animates or has a
+ * frame queued. Each tick renders at most one frame, however many times
+ * gtk_widget_queue_gl_frame() was called since the last one.
+ */
+
+static gboolean
+gtk_gl_widget_tick (GtkWidget     *widget,
+                    GdkFrameClock *frame_clock,
+                    gpointer       user_data)
+{
+  GLWidgetPrivate *private = user_data;
+
+  private->frame_pending = FALSE;
+
+  if (private->frame_func != NULL &&
+      !private->frame_func (widget, frame_clock, private->frame_data))
+    gtk_gl_widget_clear_animation (private);
+
+  /* A render thread renders on its own; otherwise the frame is drawn
+     in the paint phase of this frame clock cycle. */
+  if (private->render_thread != NULL)
+    gtk_widget_queue_gl_render (widget);
+  else
+    gtk_widget_queue_draw (widget);
+
+  if (private->frame_func == NULL && !private->frame_pending)
+    {
+      private->tick_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+gtk_gl_widget_update_ticking (GtkWidget       *widget,
+                              GLWidgetPrivate *private)
+{
+  gboolean wants_ticks;
+
+  wants_ticks = gtk_widget_get_mapped (widget) &&
+                (private->frame_func != NULL || private->frame_pending);
+
+  if (wants_ticks && private->tick_id == 0)
+    {
+      GTK_GL_NOTE (MISC, g_message (" - start ticking"));
+
+      private->tick_id = gtk_widget_add_tick_callback (widget,
+                                                       gtk_gl_widget_tick,
+                                                       private,
+                                                       NULL);
+    }
+  else if (!wants_ticks && private->tick_id != 0)
+    {
+      GTK_GL_NOTE (MISC, g_message (" - stop ticking"));
+
+      gtk_widget_remove_tick_callback (widget, private->tick_id);
+      private->tick_id = 0;
+    }
+}
+
+static void
+gtk_gl_widget_clear_animation (GLWidgetPrivate *private)
+{
+  GDestroyNotify destroy = private->frame_destroy;
+  gpointer data = private->frame_data;
+
+  private->frame_func = NULL;
+  private->frame_data = NULL;
+  private->frame_destroy = NULL;
+
+  if (destroy != NULL)
+    destroy (data);
+}
+
 /**
  * gtk_widget_set_gl_capability:
  * @widget: the #GtkWidget to be used as the rendering area.
@@ -252,6 +680,47 @@ gtk_widget_set_gl_capability (GtkWidget    *widget,
                               GdkGLContext *share_list,
                               gboolean      direct,
                               int           render_type)
+{
+  return gtk_widget_set_gl_capability_full (widget,
+                                            glconfig,
+                                            share_list,
+                                            direct,
+                                            render_type,
+                                            0, 0,
+                                            GDK_GL_CONTEXT_PROFILE_DEFAULT,
+                                            0);
+}
+
+/**
+ * gtk_widget_set_gl_capability_full:
+ * @widget: the #GtkWidget to be used as the rendering area.
+ * @glconfig: a #GdkGLConfig.
+ * @share_list: (allow-none): the #GdkGLContext with which to share display lists and texture
+ *              objects. NULL indicates that no sharing is to take place.
+ * @direct: whether rendering is to be done with a direct connection to
+ *          the graphics system.
+ * @render_type: GDK_GL_RGBA_TYPE.
+ * @major_version: the requested OpenGL major version, or 0 for any.
+ * @minor_version: the requested OpenGL minor version.
+ * @profile: the requested #GdkGLContextProfile.
+ * @flags: a combination of #GdkGLContextFlags.
+ *
+ * Like gtk_widget_set_gl_capability(), but the context returned by
+ * gtk_widget_get_gl_context() is created with gdk_gl_context_new_full()
+ * using the given version, profile and flags.
+ *
+ * Return value: TRUE if it is successful, FALSE otherwise.
+ **/
+gboolean
+gtk_widget_set_gl_capability_full (GtkWidget           *widget,
+                                   GdkGLConfig         *glconfig,
+                                   GdkGLContext        *share_list,
+                                   gboolean             direct,
+                                   int                  render_type,
+                                   int                  major_version,
+                                   int                  minor_version,
+                                   GdkGLContextProfile  profile,
+                                   GdkGLContextFlags    flags)
 {
   GdkVisual *visual;
   GLWidgetPrivate *private;
@@ -341,12 +810,34 @@ gtk_widget_set_gl_capability (GtkWidget    *widget,
 
   private->direct = direct;
   private->render_type = render_type;
+  private->major_version = major_version;
+  private->minor_version = minor_version;
+  private->profile = profile;
+  private->flags = flags;
 
   private->glcontext = NULL;
 
   private->unrealize_handler = 0;
 
+  private->render_func = NULL;
+  private->render_data = NULL;
+  private->render_destroy = NULL;
+  private->render_thread = NULL;
+
+  private->frame_func = NULL;
+  private->frame_data = NULL;
+  private->frame_destroy = NULL;
+  private->tick_id = 0;
+
+  memset (private->damage_history, 0, sizeof (private->damage_history));
+  private->damage_width = 0;
+  private->damage_height = 0;
+
+  private->synced_width = 0;
+  private->synced_height = 0;
+
   private->is_realized = FALSE;
+  private->frame_pending = FALSE;
 
   g_object_set_qdata_full (G_OBJECT (widget), quark_gl_private, private,
                            (GDestroyNotify) gl_widget_private_destroy);
@@ -373,6 +864,17 @@ gtk_widget_set_gl_capability (GtkWidget    *widget,
                     G_CALLBACK (gtk_gl_widget_size_allocate),
                     private);
 
+  /*
+   * Tick the frame clock only while the widget is mapped.
+   */
+
+  g_signal_connect (G_OBJECT (widget), "map",
+                    G_CALLBACK (gtk_gl_widget_map_changed),
+                    private);
+  g_signal_connect (G_OBJECT (widget), "unmap",
+                    G_CALLBACK (gtk_gl_widget_map_changed),
+                    private);
+
   return TRUE;
 }
 
@@ -490,10 +992,24 @@ gtk_widget_get_gl_context (GtkWidget *widget)
     return NULL;
 
   if (private->glcontext == NULL)
-    private->glcontext = gtk_widget_create_gl_context (widget,
-                                                       private->share_list,
-                                                       private->direct,
-                                                       private->render_type);
+    {
+      GdkGLDrawable *gldrawable;
+
+      gldrawable = gdk_window_get_gl_drawable (gtk_widget_get_window (widget));
+      if (gldrawable == NULL)
+        return NULL;
+
+      private->glcontext = gdk_gl_context_new_full (gldrawable,
+                                                    private->share_list,
+                                                    private->direct,
+                                                    private->render_type,
+                                                    private->major_version,
+                                                    private->minor_version,
+                                                    private->profile,
+                                                    private->flags);
+      if (private->glcontext == NULL)
+        g_warning ("cannot create GdkGLContext\n");
+    }
 
   return private->glcontext;
 }
@@ -548,3 +1064,333 @@ gtk_widget_end_gl(GtkWidget *widget, gboolean do_swap)
 
   gdk_gl_context_release_current();
 }
+
+/**
+ * gtk_widget_get_gl_damage:
+ * @widget: an OpenGL-capable #GtkWidget.
+ * @cr: the #cairo_t passed to the "draw" handler.
+ *
+ * Returns the part of @widget that must be repainted in this "draw"
+ * handler. This is the region GTK+ asked to be exposed, clipped to @cr,
+ * plus whatever the back buffer missed according to its age (see
+ * gdk_gl_drawable_get_buffer_age()). If the age is unknown, or the
+ * widget has been resized since the last frame, the whole widget is
+ * returned.
+ *
+ * Call it once per frame, between gtk_widget_begin_gl() and
+ * gtk_widget_end_gl_with_damage(), since each call records a frame.
+ * The region is in widget coordinates with the origin at the top left;
+ * for glScissor(), flip y against the widget height. Applications that
+ * invalidate only what changed, e.g. with gdk_window_invalidate_rect(),
+ * then redraw only that.
+ *
+ * Return value: (transfer full): the region to repaint. Free it with
+ *               cairo_region_destroy().
+ **/
+cairo_region_t *
+gtk_widget_get_gl_damage (GtkWidget *widget,
+                          cairo_t   *cr)
+{
+  GLWidgetPrivate *private;
+  GdkGLDrawable *gldrawable;
+  cairo_rectangle_int_t bounds;
+  cairo_rectangle_list_t *clip;
+  cairo_region_t *expose;
+  cairo_region_t *repaint;
+  gboolean is_full;
+  int age;
+  int i;
+
+  g_return_val_if_fail (GTK_IS_WIDGET (widget), NULL);
+  g_return_val_if_fail (cr != NULL, NULL);
+
+  private = g_object_get_qdata (G_OBJECT (widget), quark_gl_private);
+  g_return_val_if_fail (private != NULL, NULL);
+
+  bounds.x = 0;
+  bounds.y = 0;
+  bounds.width = gtk_widget_get_allocated_width (widget);
+  bounds.height = gtk_widget_get_allocated_height (widget);
+
+  /*
+   * Exposed region.
+   */
+
+  clip = cairo_copy_clip_rectangle_list (cr);
+
+  if (clip->status == CAIRO_STATUS_SUCCESS)
+    {
+      expose = cairo_region_create ();
+
+      for (i = 0; i < clip->num_rectangles; i++)
+        {
+          cairo_rectangle_int_t rect;
+
+          rect.x = floor (clip->rectangles[i].x);
+          rect.y = floor (clip->rectangles[i].y);
+          rect.width = ceil (clip->rectangles[i].x + clip->rectangles[i].width) - rect.x;
+          rect.height = ceil (clip->rectangles[i].y + clip->rectangles[i].height) - rect.y;
+
+          cairo_region_union_rectangle (expose, &rect);
+        }
+
+      cairo_region_intersect_rectangle (expose, &bounds);
+    }
+  else
+    {
+      expose = cairo_region_create_rectangle (&bounds);
+    }
+
+  cairo_rectangle_list_destroy (clip);
+
+  /*
+   * Add the damage of the frames the back buffer has not seen.
+   */
+
+  if (bounds.width != private->damage_width ||
+      bounds.height != private->damage_height)
+    {
+      gl_widget_private_clear_damage (private);
+      private->damage_width = bounds.width;
+      private->damage_height = bounds.height;
+    }
+
+  gldrawable = gdk_window_get_gl_drawable (gtk_widget_get_window (widget));
+  age = (gldrawable != NULL) ? gdk_gl_drawable_get_buffer_age (gldrawable) : 0;
+
+  repaint = cairo_region_copy (expose);
+
+  is_full = (age <= 0 || age > GL_WIDGET_DAMAGE_HISTORY + 1);
+  for (i = 0; !is_full && i < age - 1; i++)
+    {
+      if (private->damage_history[i] == NULL)
+        is_full = TRUE;
+      else
+        cairo_region_union (repaint, private->damage_history[i]);
+    }
+
+  if (is_full)
+    cairo_region_union_rectangle (repaint, &bounds);
+
+  GTK_GL_NOTE (MISC,
+    g_message (" - buffer age %d, %d rectangle(s) to repaint",
+               age, cairo_region_num_rectangles (repaint)));
+
+  /*
+   * Record this frame.
+   */
+
+  if (private->damage_history[GL_WIDGET_DAMAGE_HISTORY - 1] != NULL)
+    cairo_region_destroy (private->damage_history[GL_WIDGET_DAMAGE_HISTORY - 1]);
+
+  memmove (&private->damage_history[1], &private->damage_history[0],
+           (GL_WIDGET_DAMAGE_HISTORY - 1) * sizeof (cairo_region_t *));
+  private->damage_history[0] = expose;
+
+  return repaint;
+}
+
+/**
+ * gtk_widget_end_gl_with_damage:
+ * @widget: an OpenGL-capable #GtkWidget.
+ * @damage: (allow-none): the region that was repainted, usually the one
+ *          returned by gtk_widget_get_gl_damage(), or NULL.
+ *
+ * Like gtk_widget_end_gl() with @do_swap set, but presents only @damage
+ * where the window system allows it. See
+ * gdk_gl_drawable_swap_buffers_with_damage().
+ **/
+void
+gtk_widget_end_gl_with_damage (GtkWidget            *widget,
+                               const cairo_region_t *damage)
+{
+  GdkGLDrawable *gldrawable;
+
+  g_return_if_fail (GTK_IS_WIDGET (widget));
+
+  gldrawable = GDK_GL_DRAWABLE (gtk_widget_get_gl_window (widget));
+
+  if (gdk_gl_drawable_is_double_buffered (gldrawable))
+    gdk_gl_drawable_swap_buffers_with_damage (gldrawable, damage);
+  else
+    glFlush ();
+
+  gdk_gl_context_release_current();
+}
+
+/**
+ * gtk_widget_set_gl_render_thread:
+ * @widget: an OpenGL-capable #GtkWidget.
+ * @render_func: the function that renders a frame.
+ * @user_data: (allow-none): data passed to @render_func.
+ * @destroy: (allow-none): function to free @user_data, or NULL.
+ *
+ * Renders @widget from a dedicated thread instead of the main loop.
+ *
+ * When the widget is realized, a thread is started with its own
+ * #GdkGLContext, created with the parameters given to
+ * gtk_widget_set_gl_capability_full(). The thread calls @render_func with
+ * that context current and then swaps buffers, so neither rendering nor
+ * the swap blocks the main loop. Exposes, size changes and
+ * gtk_widget_queue_gl_render() request a new frame; requests made while
+ * a frame is rendering are merged into a single frame. Nothing is rendered
+ * while the widget is unmapped. The thread is stopped when the widget is
+ * unrealized.
+ *
+ * @render_func runs in the render thread and must not call GTK+ or GDK
+ * functions. Do not connect "draw" handlers that render with OpenGL to
+ * the widget. On X11, Xlib must be thread-safe: call XInitThreads() before
+ * gtk_init() unless libX11 is 1.8 or newer.
+ *
+ * This must be called after gtk_widget_set_gl_capability() and before
+ * the widget is realized.
+ *
+ * Return value: TRUE if it is successful, FALSE otherwise.
+ **/
+gboolean
+gtk_widget_set_gl_render_thread (GtkWidget       *widget,
+                                 GtkGLRenderFunc  render_func,
+                                 gpointer         user_data,
+                                 GDestroyNotify   destroy)
+{
+  GLWidgetPrivate *private;
+
+  GTK_GL_NOTE_FUNC ();
+
+  g_return_val_if_fail (GTK_IS_WIDGET (widget), FALSE);
+  g_return_val_if_fail (!gtk_widget_get_realized (widget), FALSE);
+  g_return_val_if_fail (render_func != NULL, FALSE);
+
+  private = g_object_get_qdata (G_OBJECT (widget), quark_gl_private);
+  g_return_val_if_fail (private != NULL, FALSE);
+  g_return_val_if_fail (private->render_func == NULL, FALSE);
+
+  private->render_func = render_func;
+  private->render_data = user_data;
+  private->render_destroy = destroy;
+
+  g_signal_connect (G_OBJECT (widget), "draw",
+                    G_CALLBACK (gtk_gl_widget_render_thread_draw),
+                    private);
+  g_signal_connect (G_OBJECT (widget), "map",
+                    G_CALLBACK (gtk_gl_widget_render_thread_set_visible),
+                    private);
+  g_signal_connect (G_OBJECT (widget), "unmap",
+                    G_CALLBACK (gtk_gl_widget_render_thread_set_visible),
+                    private);
+
+  return TRUE;
+}
+
+/**
+ * gtk_widget_queue_gl_render:
+ * @widget: a #GtkWidget with a render thread.
+ *
+ * Asks the render thread of @widget to render a new frame. Unlike
+ * gtk_widget_queue_draw(), this goes straight to the render thread. It
+ * may be called from any thread, including the render thread itself,
+ * as long as the caller holds a reference on @widget. Requests made
+ * while no render thread is running, for instance while the widget is
+ * being unrealized, are ignored. See gtk_widget_set_gl_render_thread().
+ **/
+void
+gtk_widget_queue_gl_render (GtkWidget *widget)
+{
+  GLWidgetPrivate *private;
+  GLWidgetRenderThread *rt;
+
+  g_return_if_fail (GTK_IS_WIDGET (widget));
+
+  /* The lock keeps the private data and the render thread state alive
+     while a reference is taken; see gtk_gl_widget_render_thread_stop(). */
+  G_LOCK (render_thread);
+
+  rt = NULL;
+  private = g_object_get_qdata (G_OBJECT (widget), quark_gl_private);
+  if (private != NULL && private->render_thread != NULL)
+    rt = gtk_gl_widget_render_thread_ref (private->render_thread);
+
+  G_UNLOCK (render_thread);
+
+  if (rt == NULL)
+    return;
+
+  g_mutex_lock (&rt->lock);
+  rt->render_pending = TRUE;
+  g_cond_signal (&rt->cond);
+  g_mutex_unlock (&rt->lock);
+
+  gtk_gl_widget_render_thread_unref (rt);
+}
+
+/**
+ * gtk_widget_set_gl_animation:
+ * @widget: an OpenGL-capable #GtkWidget.
+ * @frame_func: (allow-none): the function that advances the animation,
+ *              or NULL to stop animating.
+ * @user_data: (allow-none): data passed to @frame_func.
+ * @destroy: (allow-none): function to free @user_data, or NULL.
+ *
+ * Animates @widget from its #GdkFrameClock instead of a timeout or idle
+ * handler. On every frame clock tick @frame_func is called with the
+ * frame clock, whose frame time should be used to advance the animation,
+ * and then exactly one frame is rendered: the widget is redrawn in the
+ * paint phase of the same tick, or its render thread is asked for a
+ * frame (see gtk_widget_set_gl_render_thread()). Rendering thus runs at
+ * the display rate, without dropped or duplicated frames.
+ *
+ * The frame clock only ticks for @widget while it is mapped. The
+ * animation stops when @frame_func returns FALSE or when this is called
+ * again; @destroy is then called with @user_data.
+ **/
+void
+gtk_widget_set_gl_animation (GtkWidget      *widget,
+                             GtkGLFrameFunc  frame_func,
+                             gpointer        user_data,
+                             GDestroyNotify  destroy)
+{
+  GLWidgetPrivate *private;
+
+  GTK_GL_NOTE_FUNC ();
+
+  g_return_if_fail (GTK_IS_WIDGET (widget));
+
+  private = g_object_get_qdata (G_OBJECT (widget), quark_gl_private);
+  g_return_if_fail (private != NULL);
+
+  gtk_gl_widget_clear_animation (private);
+
+  private->frame_func = frame_func;
+  private->frame_data = user_data;
+  private->frame_destroy = destroy;
+
+  gtk_gl_widget_update_ticking (widget, private);
+}
+
+/**
+ * gtk_widget_queue_gl_frame:
+ * @widget: an OpenGL-capable #GtkWidget.
+ *
+ * Renders @widget once at the next frame clock tick. Any number of calls
+ * before that tick result in one frame, so this can be called for every
+ * change to the scene instead of invalidating the window. Nothing is
+ * rendered while @widget is unmapped; the frame is rendered once it is
+ * mapped again. Must be called from the main thread.
+ **/
+void
+gtk_widget_queue_gl_frame (GtkWidget *widget)
+{
+  GLWidgetPrivate *private;
+
+  g_return_if_fail (GTK_IS_WIDGET (widget));
+
+  private = g_object_get_qdata (G_OBJECT (widget), quark_gl_private);
+  g_return_if_fail (private != NULL);
+
+  if (private->frame_pending)
+    return;
+
+  private->frame_pending = TRUE;
+
+  gtk_gl_widget_update_ticking (widget, private);
+}
@@ -29,12 +29,51 @@
 
 G_BEGIN_DECLS
 
+/**
+ * GtkGLRenderFunc:
+ * @glcontext: the render thread's #GdkGLContext, which is current.
+ * @width: the width of the widget.
+ * @height: the height of the widget.
+ * @user_data: the data passed to gtk_widget_set_gl_render_thread().
+ *
+ * Renders one frame in a widget's render thread.
+ */
+typedef void (*GtkGLRenderFunc) (GdkGLContext *glcontext,
+                                 gint          width,
+                                 gint          height,
+                                 gpointer      user_data);
+
+/**
+ * GtkGLFrameFunc:
+ * @widget: the OpenGL-capable #GtkWidget.
+ * @frame_clock: the #GdkFrameClock of @widget.
+ * @user_data: the data passed to gtk_widget_set_gl_animation().
+ *
+ * Advances an animation to the frame time of @frame_clock, before the
+ * frame is rendered.
+ *
+ * Return value: FALSE to stop the animation, TRUE to keep it running.
+ */
+typedef gboolean (*GtkGLFrameFunc) (GtkWidget     *widget,
+                                    GdkFrameClock *frame_clock,
+                                    gpointer       user_data);
+
 gboolean      gtk_widget_set_gl_capability (GtkWidget    *widget,
                                             GdkGLConfig  *glconfig,
                                             GdkGLContext *share_list,
                                             gboolean      direct,
                                             int           render_type);
 
+gboolean      gtk_widget_set_gl_capability_full (GtkWidget           *widget,
+                                                 GdkGLConfig         *glconfig,
+                                                 GdkGLContext        *share_list,
+                                                 gboolean             direct,
+                                                 int                  render_type,
+                                                 int                  major_version,
+                                                 int                  minor_version,
+                                                 GdkGLContextProfile  profile,
+                                                 GdkGLContextFlags    flags);
+
 gboolean      gtk_widget_is_gl_capable     (GtkWidget    *widget);
 
 
@@ -56,6 +95,26 @@ gboolean      gtk_widget_begin_gl(GtkWidget *widget);
 
 void          gtk_widget_end_gl(GtkWidget *widget, gboolean do_swap);
 
+cairo_region_t *gtk_widget_get_gl_damage   (GtkWidget            *widget,
+                                            cairo_t              *cr);
+
+void          gtk_widget_end_gl_with_damage (GtkWidget            *widget,
+                                             const cairo_region_t *damage);
+
+gboolean      gtk_widget_set_gl_render_thread (GtkWidget       *widget,
+                                               GtkGLRenderFunc  render_func,
+                                               gpointer         user_data,
+                                               GDestroyNotify   destroy);
+
+void          gtk_widget_queue_gl_render   (GtkWidget    *widget);
+
+void          gtk_widget_set_gl_animation  (GtkWidget      *widget,
+                                            GtkGLFrameFunc  frame_func,
+                                            gpointer        user_data,
+                                            GDestroyNotify  destroy);
+
+void          gtk_widget_queue_gl_frame    (GtkWidget    *widget);
+
 G_END_DECLS
 
 #endif /* __GTK_GL_WIDGET_H__ */